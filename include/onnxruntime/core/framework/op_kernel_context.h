@@ -186,6 +186,28 @@ class OpKernelContext {
   */
   AllocatorPtr GetAllocator(const OrtDevice& device) const;
 
+  /**
+  Returns the state the kernel derives from the shapes of its inputs, such as broadcast plans or GEMM parameters,
+  if the current input shapes are hot in the session. init_fn initializes it the first time the shapes are hot.
+  @param state Set to nullptr if the shapes are not hot or shape specialization is disabled, in which case the
+               kernel computes the state itself. Otherwise it is valid for the lifetime of the session.
+  */
+  template <typename T, typename InitFn>
+  Status GetShapeSpecializedState(const InitFn& init_fn, const T*& state) {
+    // init_fn is passed as a function pointer and a context, as a std::function could allocate on every call
+    const void* untyped_state = nullptr;
+    ORT_RETURN_IF_ERROR(GetShapeSpecializedStateImpl(
+        [](const void* context, std::shared_ptr<const void>& new_state) -> Status {
+          auto typed_state = std::make_shared<T>();
+          ORT_RETURN_IF_ERROR((*static_cast<const InitFn*>(context))(*typed_state));
+          new_state = std::move(typed_state);
+          return Status::OK();
+        },
+        &init_fn, untyped_state));
+    state = static_cast<const T*>(untyped_state);
+    return Status::OK();
+  }
+
  protected:
   OpKernelContext(concurrency::ThreadPool* threadpool, const logging::Logger& logger, Stream* stream);
 
@@ -204,6 +226,9 @@ class OpKernelContext {
 
   virtual OrtValue* GetOrCreateOutputMLValue(int index);
 
+  Status GetShapeSpecializedStateImpl(Status (*create_fn)(const void* context, std::shared_ptr<const void>& state),
+                                      const void* create_fn_context, const void*& state);
+
  private:
   ORT_DISALLOW_COPY_AND_ASSIGNMENT(OpKernelContext);
   int GetInputArgIndex(int index) const;
@@ -1319,6 +1319,19 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
     return Resolve(default_options);
   }
 
+  /** How Resolve handles the nodes whose op, attributes and input and output types are unchanged since the
+  type and shape inferencing of the previous Resolve. Set on the main graph, it applies to all subgraphs.
+  Nodes containing subgraphs are always re-inferred. */
+  enum class IncrementalResolveMode {
+    kDisabled,  // every Resolve re-infers all nodes
+    kEnabled,   // skip the type and shape inferencing of the unchanged nodes
+    kVerified,  // re-infer the unchanged nodes too, and fail if their output types change. for debugging.
+  };
+
+  void SetIncrementalResolveMode(IncrementalResolveMode mode) noexcept {
+    incremental_resolve_mode_ = mode;
+  }
+
   const std::unordered_set<std::string>& GetOuterScopeNodeArgNames() const noexcept {
     return outer_scope_node_arg_names_;
   }
@@ -1540,6 +1553,12 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
 
   common::Status VerifyNodeAndOpMatch(const ResolveOptions& options);
 
+  // Hash of the op, attributes and input types of a node, i.e. everything its type and shape inferencing depends on.
+  size_t HashNodeInferenceInputs(const Node& node, const ONNX_NAMESPACE::NodeProto& node_proto) const;
+
+  // Records that the initializer with the given name was added, removed or replaced.
+  void OnInitializerChanged(const std::string& name);
+
   // Set graph inputs/outputs when resolving a graph..
   common::Status SetGraphInputsOutputs();
 
@@ -1723,6 +1742,23 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
   // number of times Resolve has run.
   int num_resolves_ = 0;
 
+#if !defined(ORT_MINIMAL_BUILD)
+  IncrementalResolveMode incremental_resolve_mode_ = IncrementalResolveMode::kDisabled;
+
+  // Hashes of the op, attributes and input types of each node, and of its output types, at the end of its last
+  // type and shape inferencing. Used by incremental resolve to find the nodes that need to be re-inferred.
+  struct NodeInferenceSignature {
+    size_t inputs_hash;
+    size_t outputs_hash;
+  };
+  InlinedHashMap<NodeIndex, NodeInferenceSignature> node_inference_signatures_;
+
+  // Generation of the initializers added, removed or replaced since the graph was loaded, hashed into the inference
+  // signatures of their consumers. The TensorProto of an initializer re-added with the same name may be allocated at
+  // the address of the removed one, so its address does not tell whether it changed.
+  InlinedHashMap<std::string, uint64_t> initializer_generations_;
+#endif
+
   const logging::Logger& logger_;
 
   // If true, all inconsistencies encountered during shape and type inference
@@ -49,6 +49,7 @@
 #endif
 #include "core/common/denormal.h"
 #include "core/common/inlined_containers_fwd.h"
+#include "core/common/profiler_common.h"
 #include "core/common/spin_pause.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/ort_spin_lock.h"
@@ -77,7 +78,9 @@
 //   work.
 //
 //   This spin-then-block behavior is configured via a flag provided
-//   when creating the thread pool, and by the constant spin_count.
+//   when creating the thread pool, and by the constant max_spin_count.
+//   With adaptive spinning enabled in ThreadOptions, each worker
+//   adapts the number of spins to the gaps between its work.
 //
 // - Although all tasks are simple void()->void functions,
 //   conceptually there are three different kinds:
@@ -207,6 +210,12 @@ struct PaddingToAvoidFalseSharing {
 3. To extend, just add more events in enum Event before "All", and update GetEventName(...) accordingly;
 4. Note LogStart must pair with either LogEnd or LogEndAndStart, otherwise ORT_ENFORCE will fail;
 5. ThreadPoolProfiler is thread-safe.
+
+Tracing is independent of the above: between StartTracing() and StopTracing() the pool records
+individual events in the chrome trace format of the session profiler, i.e. each parallel loop
+on the thread running it and each task, spin and block on the worker threads.  Events are
+appended as plain records to fixed size buffers, one per worker thread and one for parallel
+loops, without taking a lock; StopTracing() formats them into profiling events.
 */
 #ifdef ORT_MINIMAL_BUILD
 class ThreadPoolProfiler {
@@ -231,7 +240,14 @@ class ThreadPoolProfiler {
   void LogCoreAndBlock(std::ptrdiff_t){};
   void LogThreadId(int){};
   void LogRun(int){};
+  void LogSpin(int, int, bool){};
   std::string DumpChildThreadStat() { return {}; }
+  void StartTracing(onnxruntime::TimePoint, size_t){};
+  void StopTracing(onnxruntime::profiling::Events&){};
+  bool IsTracing() const { return false; }
+  void TraceParallelLoop(onnxruntime::TimePoint, onnxruntime::TimePoint, unsigned, std::ptrdiff_t){};
+  void TraceTask(int, onnxruntime::TimePoint, bool){};
+  void TraceIdle(int, onnxruntime::TimePoint, onnxruntime::TimePoint, bool){};
 };
 #else
 class ThreadPoolProfiler {
@@ -257,8 +273,22 @@ class ThreadPoolProfiler {
   void LogCoreAndBlock(std::ptrdiff_t block_size);  // called in main thread to log core and block size for task breakdown
   void LogThreadId(int thread_idx);                 // called in child thread to log its id
   void LogRun(int thread_idx);                      // called in child thread to log num of run
+  void LogSpin(int thread_idx, int spin_count, bool blocked);  // called in child thread to log the outcome of a spin
   std::string DumpChildThreadStat();                // return all child statitics collected so far
 
+  // start recording trace events, with timestamps relative to start_time, until max_num_events are recorded
+  void StartTracing(onnxruntime::TimePoint start_time, size_t max_num_events);
+  // stop recording trace events and append those recorded to events
+  void StopTracing(onnxruntime::profiling::Events& events);
+  bool IsTracing() const { return tracing_.load(std::memory_order_relaxed); }
+  // called in main thread to trace a parallel loop from start until now, with work distributed at dispatched
+  void TraceParallelLoop(onnxruntime::TimePoint start, onnxruntime::TimePoint dispatched,
+                         unsigned num_work_items, std::ptrdiff_t block_size);
+  // called in child thread to trace a task run from start until now
+  void TraceTask(int thread_idx, onnxruntime::TimePoint start, bool stolen);
+  // called in child thread to trace waiting for work from start until now, spinning until block_start if blocked
+  void TraceIdle(int thread_idx, onnxruntime::TimePoint start, onnxruntime::TimePoint block_start, bool blocked);
+
  private:
   static const char* GetEventName(ThreadPoolEvent);
   struct MainThreadStat {
@@ -284,17 +314,110 @@ class ThreadPoolProfiler {
   struct ORT_ALIGN_TO_AVOID_FALSE_SHARING ChildThreadStat {
     std::thread::id thread_id_;
     uint64_t num_run_ = 0;
+    uint64_t num_spin_hit_ = 0;  // work found while spinning
+    uint64_t num_block_ = 0;     // no work found while spinning, blocked instead
+    int spin_count_ = 0;         // number of times the thread last spun before blocking, if not interrupted
+    unsigned trace_thread_id_ = 0;  // thread id in trace events
     onnxruntime::TimePoint last_logged_point_ = Clock::now();
     int32_t core_ = -1;  // core that the child thread is running on
   };
+  // a traced parallel loop, task or idle period, formatted into profiling events by StopTracing
+  struct TraceRecord {
+    enum Kind : uint8_t {
+      PARALLEL_LOOP,
+      TASK,
+      IDLE
+    };
+    Kind kind_ = TASK;
+    bool flag_ = false;  // whether a task was stolen or an idle thread blocked
+    unsigned thread_id_ = 0;
+    unsigned num_work_items_ = 0;
+    std::ptrdiff_t block_size_ = 0;
+    onnxruntime::TimePoint start_;
+    onnxruntime::TimePoint mid_;  // when a parallel loop was dispatched or an idle thread blocked
+    onnxruntime::TimePoint end_;
+    std::atomic<bool> complete_{false};  // set once the record is written
+  };
+  // fixed size buffer of trace records, appended to without locking
+  struct ORT_ALIGN_TO_AVOID_FALSE_SHARING TraceBuffer {
+    static constexpr size_t kCapacity = 8192;
+    std::unique_ptr<TraceRecord[]> records_;
+    std::atomic<size_t> num_records_{0};  // may exceed kCapacity, the excess records are dropped
+    void Reset();
+    TraceRecord* Append();  // return nullptr once the buffer is full
+  };
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif  // _MSC_VER
   std::vector<ChildThreadStat> child_thread_stats_;
   std::string thread_pool_name_;
+
+  void FormatTraceRecords(TraceBuffer& buffer, onnxruntime::profiling::Events& events, size_t& max_num_events);
+  std::atomic<bool> tracing_{false};
+  OrtMutex trace_mutex_;  // serializes StartTracing and StopTracing
+  onnxruntime::TimePoint trace_start_time_;
+  size_t max_num_trace_events_ = 0;
+  std::unique_ptr<TraceBuffer[]> child_trace_buffers_;  // written by the child threads
+  TraceBuffer parallel_loop_trace_buffer_;              // written by the threads running parallel loops
 };
 #endif
 
+// The number of times a worker spins waiting for work before it blocks.
+//
+// Without adaptive spinning it is always max_spin_count.  With adaptive spinning it moves
+// between min_spin_count and max_spin_count based on how long the worker waited for work
+// each time it became idle:
+//
+// - If work arrived while spinning, or arrived after blocking but within the time that
+//   max_spin_count spins would have taken, then spinning (longer) avoids the cost of
+//   blocking and waking up.  Double the spin count.
+//
+// - If work arrived only after that, then spinning just burnt CPU time.  Halve it.
+//
+// The time of a spin is measured on each idle period, rather than assumed, since it
+// varies with the platform and the pause instruction used by SpinPause.
+class SpinCount {
+ public:
+  using Duration = std::chrono::steady_clock::duration;
+
+  SpinCount(int max_spin_count, int min_spin_count, bool adaptive)
+      : max_spin_count_(max_spin_count),
+        min_spin_count_(std::min(min_spin_count, max_spin_count)),
+        adaptive_(adaptive && max_spin_count > 0),
+        spin_count_(max_spin_count) {}
+
+  int Get() const { return spin_count_; }
+
+  bool IsAdaptive() const { return adaptive_; }
+
+  // Work was found while spinning.
+  void OnSpinHit() {
+    if (adaptive_) {
+      spin_count_ = std::min(spin_count_ * 2, max_spin_count_);
+    }
+  }
+
+  // Work was found after spinning Get() times for spin_time and then blocking, idle_time after
+  // the worker became idle.
+  void OnWakeUp(Duration spin_time, Duration idle_time) {
+    if (!adaptive_) {
+      return;
+    }
+    const Duration max_spin_time = spin_time * (max_spin_count_ / spin_count_);
+    if (idle_time <= max_spin_time) {
+      spin_count_ = std::min(spin_count_ * 2, max_spin_count_);
+    } else {
+      spin_count_ = std::max(spin_count_ / 2, min_spin_count_);
+    }
+  }
+
+ private:
+  const int max_spin_count_;
+  const int min_spin_count_;
+  const bool adaptive_;
+  int spin_count_;
+};
+
 // Extended Eigen thread pool interface, avoiding the need to modify
 // the ThreadPoolInterface.h header from the external Eigen
 // repository.
@@ -339,6 +462,8 @@ class ExtendedThreadPoolInterface : public Eigen::ThreadPoolInterface {
                              unsigned n, std::ptrdiff_t block_size) = 0;
   virtual void StartProfiling() = 0;
   virtual std::string StopProfiling() = 0;
+  virtual void StartTracing(onnxruntime::TimePoint start_time, size_t max_num_events) = 0;
+  virtual void StopTracing(onnxruntime::profiling::Events& events) = 0;
 };
 
 class ThreadPoolParallelSection {
@@ -730,6 +855,14 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return profiler_.Stop();
   }
 
+  void StartTracing(onnxruntime::TimePoint start_time, size_t max_num_events) override {
+    profiler_.StartTracing(start_time, max_num_events);
+  }
+
+  void StopTracing(onnxruntime::profiling::Events& events) override {
+    profiler_.StopTracing(events);
+  }
+
   struct Tag {
     constexpr Tag() : v_(0) {
     }
@@ -773,6 +906,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         env_(env),
         num_threads_(num_threads),
         allow_spinning_(allow_spinning),
+        adaptive_spinning_(allow_spinning && thread_options.adaptive_spinning),
         set_denormal_as_zero_(thread_options.set_denormal_as_zero),
         worker_data_(num_threads),
         all_coprimes_(num_threads),
@@ -1243,6 +1377,8 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
                             std::ptrdiff_t block_size) override {
     ORT_ENFORCE(n <= num_threads_ + 1, "More work items than threads");
     profiler_.LogStartAndCoreAndBlock(block_size);
+    const bool tracing = profiler_.IsTracing();
+    const auto trace_start = tracing ? std::chrono::high_resolution_clock::now() : onnxruntime::TimePoint{};
     PerThread* pt = GetPerThread();
     assert(pt->leading_par_section && "RunInParallel, but not in parallel section");
     assert((n > 1) && "Trivial parallel section; should be avoided by caller");
@@ -1273,6 +1409,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     RunInParallelInternal(*pt, ps, n, false, std::move(worker_fn));
     assert(ps.dispatch_q_idx == -1);
     profiler_.LogEndAndStart(ThreadPoolProfiler::DISTRIBUTION);
+    const auto trace_dispatched = tracing ? std::chrono::high_resolution_clock::now() : onnxruntime::TimePoint{};
 
     // Run work in the main thread
     loop.fn(0);
@@ -1284,6 +1421,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       onnxruntime::concurrency::SpinPause();
     }
     profiler_.LogEnd(ThreadPoolProfiler::WAIT);
+    if (tracing) {
+      profiler_.TraceParallelLoop(trace_start, trace_dispatched, n, block_size);
+    }
   }
 
   // Run a single parallel loop _without_ a parallel section.  This is a
@@ -1301,15 +1441,21 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   void RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) override {
     ORT_ENFORCE(n <= num_threads_ + 1, "More work items than threads");
     profiler_.LogStartAndCoreAndBlock(block_size);
+    const bool tracing = profiler_.IsTracing();
+    const auto trace_start = tracing ? std::chrono::high_resolution_clock::now() : onnxruntime::TimePoint{};
     PerThread* pt = GetPerThread();
     ThreadPoolParallelSection ps;
     StartParallelSectionInternal(*pt, ps);
     RunInParallelInternal(*pt, ps, n, true, fn);  // select dispatcher and do job distribution;
     profiler_.LogEndAndStart(ThreadPoolProfiler::DISTRIBUTION);
+    const auto trace_dispatched = tracing ? std::chrono::high_resolution_clock::now() : onnxruntime::TimePoint{};
     fn(0);  // run fn(0)
     profiler_.LogEndAndStart(ThreadPoolProfiler::RUN);
     EndParallelSectionInternal(*pt, ps);  // wait for all
     profiler_.LogEnd(ThreadPoolProfiler::WAIT);
+    if (tracing) {
+      profiler_.TraceParallelLoop(trace_start, trace_dispatched, n, block_size);
+    }
   }
 
   int NumThreads() const final {
@@ -1492,6 +1638,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   Environment& env_;
   const unsigned num_threads_;
   const bool allow_spinning_;
+  const bool adaptive_spinning_;
   const bool set_denormal_as_zero_;
   Eigen::MaxSizeVector<WorkerData> worker_data_;
   Eigen::MaxSizeVector<Eigen::MaxSizeVector<unsigned>> all_coprimes_;
@@ -1533,19 +1680,30 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     assert(td.GetStatus() == WorkerData::ThreadStatus::Spinning);
 
     constexpr int log2_spin = 20;
-    const int spin_count = allow_spinning_ ? (1ull << log2_spin) : 0;
-    const int steal_count = spin_count / 100;
+    constexpr int log2_min_spin = 10;
+    SpinCount spin_count(allow_spinning_ ? (1 << log2_spin) : 0, 1 << log2_min_spin, adaptive_spinning_);
 
     SetDenormalAsZero(set_denormal_as_zero_);
     profiler_.LogThreadId(thread_id);
 
     while (!should_exit) {
       Task t = q.PopFront();
+      bool stolen = false;
       if (!t) {
+        const auto idle_start = adaptive_spinning_ ? std::chrono::steady_clock::now()
+                                                   : std::chrono::steady_clock::time_point{};
+        const bool tracing = profiler_.IsTracing();
+        const auto trace_idle_start = tracing ? std::chrono::high_resolution_clock::now() : onnxruntime::TimePoint{};
+        auto trace_block_start = trace_idle_start;
+        bool blocked = false;
+        const int steal_count = std::max(spin_count.Get() / 100, 1);
+        int num_spins = 0;
+
         // Spin waiting for work.
-        for (int i = 0; i < spin_count && !done_; i++) {
-          if (((i + 1) % steal_count == 0)) {
+        for (; num_spins < spin_count.Get() && !done_; num_spins++) {
+          if (((num_spins + 1) % steal_count == 0)) {
             t = Steal(StealAttemptKind::TRY_ONE);
+            stolen = static_cast<bool>(t);
           } else {
             t = q.PopFront();
           }
@@ -1557,8 +1715,20 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
           onnxruntime::concurrency::SpinPause();
         }
 
+        if (t) {
+          profiler_.LogSpin(thread_id, spin_count.Get(), false);
+          spin_count.OnSpinHit();
+        }
+
         // Attempt to block
         if (!t) {
+          const auto block_start = adaptive_spinning_ ? std::chrono::steady_clock::now()
+                                                      : std::chrono::steady_clock::time_point{};
+          if (tracing) {
+            trace_block_start = std::chrono::high_resolution_clock::now();
+          }
+          blocked = true;
+          profiler_.LogSpin(thread_id, spin_count.Get(), true);
           td.SetBlocked(  // Pre-block test
               [&]() -> bool {
                 bool should_block = true;
@@ -1619,13 +1789,31 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
           // blocking, or are exiting, then either work was pushed to
           // us, or it was pushed to an overloaded queue
           if (!t) t = q.PopFront();
-          if (!t) t = Steal(StealAttemptKind::TRY_ALL);
+          if (!t) {
+            t = Steal(StealAttemptKind::TRY_ALL);
+            stolen = static_cast<bool>(t);
+          }
+
+          // Only adapt to full spins: a spin cut short by DisableSpinning or by shutting
+          // down says nothing about the gaps between work.
+          if (adaptive_spinning_ && t && num_spins == spin_count.Get()) {
+            spin_count.OnWakeUp(block_start - idle_start, std::chrono::steady_clock::now() - idle_start);
+          }
+        }
+
+        if (tracing) {
+          profiler_.TraceIdle(thread_id, trace_idle_start, trace_block_start, blocked);
         }
       }
 
       if (t) {
         td.SetActive();
+        const bool tracing = profiler_.IsTracing();
+        const auto trace_task_start = tracing ? std::chrono::high_resolution_clock::now() : onnxruntime::TimePoint{};
         t();
+        if (tracing) {
+          profiler_.TraceTask(thread_id, trace_task_start, stolen);
+        }
         profiler_.LogRun(thread_id);
         td.SetSpinning();
       }
@@ -21,6 +21,7 @@ limitations under the License.
 #include <functional>
 #include <memory>
 #include "core/common/common.h"
+#include "core/common/profiler_common.h"
 #include "core/platform/env.h"
 
 #include <functional>
@@ -213,6 +214,28 @@ class ThreadPool {
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
+  // Limit the number of threads, including the calling thread, used by parallel loops
+  // started from the calling thread while an instance is alive.  DegreeOfParallelism
+  // reports the limited value, so code such as MLAS partitions its work for the threads
+  // that will actually run it.  This lets sessions sharing a thread pool bound the share
+  // of the pool each of them takes.
+  //
+  // A limit of zero or less means no limit.  Limits may be nested, with the previous
+  // limit restored by the destructor.  Work scheduled onto other threads does not
+  // inherit the limit; use Current() to capture it and re-establish it there.
+  class ScopedLoopThreadLimit {
+   public:
+    explicit ScopedLoopThreadLimit(int max_threads);
+    ~ScopedLoopThreadLimit();
+
+    // Returns the limit of the calling thread, or zero if there is none.
+    static int Current();
+
+   private:
+    int prev_max_threads_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedLoopThreadLimit);
+  };
+
   // The below API allows to disable spinning
   // This is used to support real-time scenarios where
   // spinning between relatively infrequent requests
@@ -366,6 +389,13 @@ class ThreadPool {
   static void StartProfiling(concurrency::ThreadPool* tp);
   static std::string StopProfiling(concurrency::ThreadPool* tp);
 
+  // Record the parallel loops, tasks, spins and blocks of the pool as events in the chrome trace
+  // format of the session profiler, with timestamps relative to start_time.  At most max_num_events
+  // are recorded.  StopTracing appends the recorded events to events.
+  // StartTracing and StopTracing are not to be consumed as public-facing API
+  static void StartTracing(concurrency::ThreadPool* tp, TimePoint start_time, size_t max_num_events);
+  static void StopTracing(concurrency::ThreadPool* tp, profiling::Events& events);
+
  private:
   friend class LoopCounter;
 
@@ -373,6 +403,11 @@ class ThreadPool {
   // value returned by DegreeOfParallelism to code using the pool.
   int NumThreads() const;
 
+  // Returns the number of threads, including the calling thread, that a parallel loop
+  // started from the calling thread may use: NumThreads() + 1, capped by any
+  // ScopedLoopThreadLimit of the calling thread.
+  int NumLoopThreads() const;
+
   // Returns current thread id between 0 and NumThreads() - 1, if called from a
   // thread in the pool. Returns -1 otherwise.
   int CurrentThreadId() const;
@@ -415,6 +450,10 @@ class ThreadPool {
 
   std::string StopProfiling();
 
+  void StartTracing(TimePoint start_time, size_t max_num_events);
+
+  void StopTracing(profiling::Events& events);
+
   ThreadOptions thread_options_;
 
   // If a thread pool is created with degree_of_parallelism != 1 then an underlying
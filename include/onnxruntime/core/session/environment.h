@@ -13,6 +13,8 @@
 
 struct OrtThreadingOptions;
 namespace onnxruntime {
+class SharedInitializerRegistry;
+
 /** TODO: remove this class
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -79,7 +81,16 @@ class Environment {
    */
   Status UnregisterAllocator(const OrtMemoryInfo& mem_info);
 
-  Environment() = default;
+  /**
+   * Returns the registry of the initializers shared by content between the sessions of this env.
+   * See kOrtSessionOptionsConfigShareInitializersByContent.
+   */
+  SharedInitializerRegistry& GetSharedInitializerRegistry() const {
+    return *shared_initializer_registry_;
+  }
+
+  Environment();
+  ~Environment();
 
   /**
    * Create and register an allocator, specified by provider_type, for sharing between multiple sessions.
@@ -99,5 +110,6 @@ class Environment {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
   bool create_global_thread_pools_{false};
   std::vector<AllocatorPtr> shared_allocators_;
+  std::unique_ptr<SharedInitializerRegistry> shared_initializer_registry_;
 };
 }  // namespace onnxruntime
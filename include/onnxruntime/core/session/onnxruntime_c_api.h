@@ -300,6 +300,7 @@ ORT_RUNTIME_CLASS(Op);
 ORT_RUNTIME_CLASS(OpAttr);
 ORT_RUNTIME_CLASS(Logger);
 ORT_RUNTIME_CLASS(ShapeInferContext);
+ORT_RUNTIME_CLASS(PreparedRun);
 
 #ifdef _WIN32
 typedef _Return_type_success_(return == 0) OrtStatus* OrtStatusPtr;
@@ -4515,6 +4516,127 @@ struct OrtApi {
    * \since Version 1.17.
    */
   ORT_API2_STATUS(ReadOpAttr, _In_ const OrtOpAttr* op_attr, _In_ OrtOpAttrType type, _Inout_ void* data, _In_ size_t len, _Out_ size_t* out);
+
+  /** \brief Set all strings at once in a string tensor from a single contiguous buffer
+   *
+   * The inverse of OrtApi::GetStringTensorContent. The strings are copied straight from \p s using
+   * \p offsets, so callers holding strings in one buffer (e.g. Arrow or numpy string arrays) do not need to
+   * build an array of null terminated strings first.
+   *
+   * Given \p s contains "Thisisatest" and \p offsets contains { 0, 4, 6, 7 }<br>
+   * the tensor will contain the strings { "This" "is" "a" "test" }.
+   * The length of the last string is s_len - offsets[last]
+   *
+   * \param[in,out] value A tensor of type ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING
+   * \param[in] s Buffer with all the strings written sequentially. Strings are NOT null terminated.
+   * \param[in] s_len Number of bytes of the buffer pointed to by \p s
+   * \param[in] offsets Array of non-decreasing start offsets of each string in \p s
+   * \param[in] offsets_len Number of elements in offsets (Must match the size of \p value's tensor shape)
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.17.
+   */
+  ORT_API2_STATUS(FillStringTensorFromBuffer, _Inout_ OrtValue* value, _In_reads_bytes_(s_len) const void* s,
+                  size_t s_len, _In_reads_(offsets_len) const size_t* offsets, size_t offsets_len);
+
+  /** \brief Create an ::OrtPreparedRun for repeated runs with the same input and output names
+   *
+   * The names are validated and resolved against the session once. OrtApi::RunPrepared then only takes the
+   * ::OrtValue%s, in the order of the names given here, and skips the per-run name lookups. Values are only
+   * validated again when their type or shape differs from the previous run with the same ::OrtPreparedRun.
+   *
+   * An ::OrtPreparedRun holds per-run state and must not be used by concurrent runs. Create one per thread instead.
+   *
+   * \param[in] session The session the ::OrtPreparedRun is used with. It must outlive the ::OrtPreparedRun.
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] input_len Number of elements in the input_names array
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_names_len Number of elements in the output_names array
+   * \param[out] out Newly created ::OrtPreparedRun. Must be freed with OrtApi::ReleasePreparedRun
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.17.
+   */
+  ORT_API2_STATUS(CreatePreparedRun, _In_ const OrtSession* session,
+                  _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Outptr_ OrtPreparedRun** out);
+
+  /** \brief Release an ::OrtPreparedRun obtained from OrtApi::CreatePreparedRun
+   *
+   * \since Version 1.17.
+   */
+  ORT_CLASS_RELEASE(PreparedRun);
+
+  /** \brief Run the model with the input and output names of an ::OrtPreparedRun
+   *
+   * Same as OrtApi::Run, with \p input and \p output in the order of the names given to OrtApi::CreatePreparedRun.
+   *
+   * \param[in] session
+   * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+   * \param[in] prepared_run Created from \p session by OrtApi::CreatePreparedRun
+   * \param[in] input Array of ::OrtValue%s of the inputs
+   * \param[in] input_len Number of elements in the input array
+   * \param[in] output_len Number of elements in the output array
+   * \param[out] output Array of ::OrtValue%s that the outputs are stored in. This can also be
+   *             an array of nullptr values, in this case ::OrtValue objects will be allocated and pointers
+   *             to them will be set into the `output` array.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.17.
+   */
+  ORT_API2_STATUS(RunPrepared, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _Inout_ OrtPreparedRun* prepared_run,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  size_t output_len, _Inout_updates_all_(output_len) OrtValue** output);
+
+  /** \brief Get the per node latency histograms of the sampled runs of a session
+   *
+   * Sampled profiling is enabled with the "session.sampled_profiling.interval" session option config entry.
+   * The histograms cover all sampled runs since the session was initialized.
+   *
+   * \param[in] session
+   * \param[in] allocator
+   * \param[out] out Null terminated string of the histograms in the Prometheus text exposition format, allocated
+   *             using `allocator`. Must be freed using `allocator`
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.17.
+   */
+  ORT_API2_STATUS(SessionGetSampledProfile, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /** \brief Get the peak activation memory of the runs of a session with given input shapes
+   *
+   * When enabled with the "session.record_peak_memory_usage" session config entry, every run records the peak of the
+   * memory allocated for the tensors of the main graph and, if memory patterns are enabled, the size of the memory
+   * pattern planned for its input shapes. When profiling is enabled, both are
+   * also added to the "SequentialExecutor::Execute" event of the run as "peak_bytes" and "planned_peak_bytes".
+   * Memory allocated by subgraphs and by kernels for their scratch buffers is not included.
+   *
+   * \param[in] session
+   * \param[in] input_shapes Array of `num_inputs` pointers to the dimensions of each input, in the order of the model inputs
+   * \param[in] input_shape_lens Array of `num_inputs` numbers of dimensions
+   * \param[in] num_inputs
+   * \param[out] planned_peak_bytes Size of the planned memory pattern, 0 if memory patterns are disabled or the
+   *             pattern was not generated yet
+   * \param[out] actual_peak_bytes Maximum of the peaks of the runs
+   *
+   * Returns an error if the recording is disabled or the session has no run with the given input shapes. The runs that
+   * also feed overridable initializers are not matched.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.17.
+   */
+  ORT_API2_STATUS(SessionGetPeakMemoryUsage, _In_ const OrtSession* session,
+                  _In_reads_(num_inputs) const int64_t* const* input_shapes,
+                  _In_reads_(num_inputs) const size_t* input_shape_lens, size_t num_inputs,
+                  _Out_ size_t* planned_peak_bytes, _Out_ size_t* actual_peak_bytes);
 };
 
 /*
@@ -522,6 +522,7 @@ ORT_DEFINE_RELEASE(Status);
 ORT_DEFINE_RELEASE(OpAttr);
 ORT_DEFINE_RELEASE(Op);
 ORT_DEFINE_RELEASE(KernelInfo);
+ORT_DEFINE_RELEASE(PreparedRun);
 
 #undef ORT_DEFINE_RELEASE
 
@@ -985,6 +986,7 @@ struct ModelMetadata : detail::Base<OrtModelMetadata> {
 };
 
 struct IoBinding;
+struct PreparedRun;
 
 namespace detail {
 
@@ -1027,6 +1029,23 @@ struct ConstSessionImpl : Base<T> {
   AllocatedStringPtr GetOverridableInitializerNameAllocated(size_t index, OrtAllocator* allocator) const;  ///< Wraps OrtApi::SessionGetOverridableInitializerName
 
   uint64_t GetProfilingStartTimeNs() const;  ///< Wraps OrtApi::SessionGetProfilingStartTimeNs
+  /** \brief Returns a copy of the per node latency histograms of the sampled runs, in the Prometheus text format.
+   *
+   * \param allocator to allocate memory for the copy of the string returned
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   *  The OrtAllocator instances must be valid at the point of memory release.
+   */
+  AllocatedStringPtr GetSampledProfileAllocated(OrtAllocator* allocator) const;  ///< Wraps OrtApi::SessionGetSampledProfile
+  /** \brief Returns the planned and actual peak activation memory of the runs with the given input shapes.
+   *
+   * Requires the "session.record_peak_memory_usage" session config entry.
+   *
+   * \param input_shapes the dimensions of each input, in the order of the model inputs
+   * \param planned_peak_bytes size of the planned memory pattern, 0 if none
+   * \param actual_peak_bytes maximum of the peaks of the runs
+   */
+  void GetPeakMemoryUsage(const std::vector<std::vector<int64_t>>& input_shapes,
+                          size_t& planned_peak_bytes, size_t& actual_peak_bytes) const;  ///< Wraps OrtApi::SessionGetPeakMemoryUsage
   ModelMetadata GetModelMetadata() const;    ///< Wraps OrtApi::SessionGetModelMetadata
 
   TypeInfo GetInputTypeInfo(size_t index) const;                   ///< Wraps OrtApi::SessionGetInputTypeInfo
@@ -1067,6 +1086,21 @@ struct SessionImpl : ConstSessionImpl<T> {
 
   void Run(const RunOptions& run_options, const IoBinding&);  ///< Wraps OrtApi::RunWithBinding
 
+  /** \brief Run the model with the input and output names of a PreparedRun
+   *
+   * Wraps OrtApi::RunPrepared
+   *
+   * \param[in] run_options
+   * \param[in] prepared_run Created from this session
+   * \param[in] input_values Array of Value objects in the order of the input names of prepared_run
+   * \param[in] input_count Number of elements in the input_values array
+   * \param[out] output_values Array of Value objects in the order of the output names of prepared_run.
+   *             Null values are filled with outputs allocated by onnxruntime.
+   * \param[in] output_count Number of elements in the output_values array
+   */
+  void Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+           Value* output_values, size_t output_count);
+
   /** \brief Run the model asynchronously in a thread owned by intra op thread pool
    *
    * Wraps OrtApi::RunAsync
@@ -1495,6 +1529,16 @@ struct ValueImpl : ConstValueImpl<T> {
   /// <param name="s_len">[in] Count of strings in s (Must match the size of \p value's tensor shape)</param>
   void FillStringTensor(const char* const* s, size_t s_len);
 
+  /// <summary>
+  /// Set all strings at once in a string tensor from a single buffer of concatenated strings.
+  /// The inverse of GetStringTensorContent.
+  /// </summary>
+  /// <param name="s">[in] Buffer with all the strings written sequentially, NOT null terminated</param>
+  /// <param name="s_len">[in] Number of bytes of the buffer</param>
+  /// <param name="offsets">[in] Non-decreasing start offsets of each string in s</param>
+  /// <param name="offsets_len">[in] Number of offsets (Must match the size of \p value's tensor shape)</param>
+  void FillStringTensorFromBuffer(const void* s, size_t s_len, const size_t* offsets, size_t offsets_len);
+
   /// <summary>
   /// Set a single string in a string tensor
   /// </summary>
@@ -1859,6 +1903,19 @@ struct IoBinding : detail::IoBindingImpl<OrtIoBinding> {
   UnownedIoBinding GetUnowned() const { return UnownedIoBinding{this->p_}; }
 };
 
+/** \brief Wrapper around ::OrtPreparedRun
+ *
+ * Input and output names resolved against a session once for repeated calls to
+ * Session::Run(const RunOptions&, PreparedRun&, const Value*, size_t, Value*, size_t).
+ * Must not be used by concurrent runs.
+ */
+struct PreparedRun : detail::Base<OrtPreparedRun> {
+  explicit PreparedRun(std::nullptr_t) {}  ///< Create an empty PreparedRun object, must be assigned a valid one to be used
+  /// Wraps OrtApi::CreatePreparedRun
+  PreparedRun(const Session& session, const char* const* input_names, size_t input_count,
+              const char* const* output_names, size_t output_count);
+};
+
 /*! \struct Ort::ArenaCfg
  * \brief it is a structure that represents the configuration of an arena based allocator
  * \details Please see docs/C_API.md for details
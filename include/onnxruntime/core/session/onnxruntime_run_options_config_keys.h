@@ -30,3 +30,19 @@ static const char* const kOrtRunOptionsConfigEnableMemoryArenaShrinkage = "memor
 // Per default it will be set to '0'
 // Taking CUDA EP as an example, it omit triggering cudaStreamSynchronize on the compute stream.
 static const char* const kOrtRunOptionsConfigDisableSynchronizeExecutionProviders = "disable_synchronize_execution_providers";
+
+// Priority of a RunAsync request, used when the session has dedicated async run threads
+// (see kOrtSessionOptionsConfigAsyncRunNumThreads). Queued requests with a higher value start first,
+// requests of the same priority start in submission order.
+// Any integer. Default is "0".
+static const char* const kOrtRunOptionsConfigAsyncRunPriority = "run.async_run.priority";
+
+// Deadline of a RunAsync request in milliseconds from the RunAsync call, used when the session has dedicated async
+// run threads. If the request has not started by then, it is not run and its callback receives an error status.
+// By default a request has no deadline.
+static const char* const kOrtRunOptionsConfigAsyncRunDeadlineMs = "run.async_run.deadline_ms";
+
+// Maximum number of intra op threads, including the thread calling Run, that a parallel loop of this run uses.
+// Overrides kOrtSessionOptionsConfigIntraOpMaxDegreeOfParallelism of the session, so the share of a thread pool that
+// a session takes can be changed between runs. "0" means no limit.
+static const char* const kOrtRunOptionsConfigIntraOpMaxDegreeOfParallelism = "run.intra_op.max_degree_of_parallelism";
@@ -103,6 +103,40 @@ static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "
 static const char* const kOrtSessionOptionsConfigAllowInterOpSpinning = "session.inter_op.allow_spinning";
 static const char* const kOrtSessionOptionsConfigAllowIntraOpSpinning = "session.intra_op.allow_spinning";
 
+// Configure whether the inter_op/intra_op threads adapt how long they spin to the gaps between the work they receive.
+// Each thread spins longer while work keeps arriving soon after it became idle, and shorter while it ends up blocking
+// until long after its spin ended. This saves CPU in low load periods without adding wake up latency at peak load.
+// Only used when spinning is allowed.
+// "0": default, thread spins a fixed number of times before blocking
+// "1": thread adapts the number of times it spins before blocking
+static const char* const kOrtSessionOptionsConfigAdaptiveInterOpSpinning = "session.inter_op.adaptive_spinning";
+static const char* const kOrtSessionOptionsConfigAdaptiveIntraOpSpinning = "session.intra_op.adaptive_spinning";
+
+// Configure whether the profile of the session includes a trace of its intra op and inter op thread pools:
+// each parallel loop, with the time taken to distribute it to the workers, and each task, spin and block on the
+// worker threads, with whether the task was stolen from another worker. Only used when profiling is enabled.
+// Not supported for sessions using the global thread pools of the environment, which are shared with other sessions:
+// the option is ignored with a warning.
+// "0": default, the profile only includes the per thread statistics of the thread pools for each node
+// "1": the profile includes the trace of the thread pools
+static const char* const kOrtSessionOptionsConfigEnableThreadPoolTracing = "session.enable_thread_pool_tracing";
+
+// Enable sampled profiling, with which 1 in N runs of the session time each node of the main graph and add the time
+// to a per node latency histogram. Unlike the profiling enabled with SessionOptions::enable_profiling, this neither
+// records events nor writes a file, and is cheap enough to leave enabled in production.
+// Get the histograms with OrtApi::SessionGetSampledProfile.
+// "0": default, disabled
+// "N": sample 1 in N runs
+static const char* const kOrtSessionOptionsConfigSampledProfilingInterval = "session.sampled_profiling.interval";
+
+// Maximum number of intra op threads, including the thread calling Run, that a parallel loop of this session uses.
+// Intended for sessions sharing the global thread pools of the environment, so that one heavy model does not take
+// the whole pool from the others. Can be overridden per run with kOrtRunOptionsConfigIntraOpMaxDegreeOfParallelism.
+// "0": default, no limit
+// "n": use at most n threads per parallel loop
+static const char* const kOrtSessionOptionsConfigIntraOpMaxDegreeOfParallelism =
+    "session.intra_op.max_degree_of_parallelism";
+
 // Key for using model bytes directly for ORT format
 // If a session is created using an input byte array contains the ORT format model data,
 // By default we will copy the model bytes at the time of session creation to ensure the model bytes
@@ -162,6 +196,14 @@ static const char* const kOrtSessionOptionsConfigNnapiEpPartitioningStopOps = "e
 // Available since version 1.11.
 static const char* const kOrtSessionOptionsConfigDynamicBlockBase = "session.dynamic_block_base";
 
+// Configure whether the parallel loops of the intra op thread pool of the session use guided scheduling on hybrid
+// CPUs. Each worker then claims a share of the iterations remaining in its part of the loop rather than a fixed
+// block, so the blocks shrink towards the end of the loop and the workers on efficiency cores don't hold up its end.
+// Not used on other CPUs, by the thread pools of the environment, or when session.dynamic_block_base is set.
+// "0": default, the loops are split in fixed blocks
+// "1": the loops use guided scheduling on hybrid CPUs
+static const char* const kOrtSessionOptionsConfigIntraOpGuidedScheduling = "session.intra_op.guided_scheduling";
+
 // This option allows to decrease CPU usage between infrequent
 // requests and forces any TP threads spinning stop immediately when the last of
 // concurrent Run() call returns.
@@ -200,6 +242,14 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
 
+// Bind the threads of the session's thread pools to the physical cores of a NUMA node, e.g. "0" or "1".
+// With the default number of intra op threads the pool then gets one thread per core of that node.
+// Memory first touched by these threads, such as most of the arena memory used while running, is then local to the node
+// on operating systems with a first touch policy. For best results the thread calling Run should run on the same node.
+// Ignored if "session.intra_op_thread_affinities" is set, or if the node does not exist.
+// Default is "-1", which does not bind the threads to a node.
+static const char* const kOrtSessionOptionsConfigNumaNode = "session.numa_node";
+
 // This option will dump out the model to assist debugging any issues with layout transformation,
 // and is primarily intended for developer usage. It is only relevant if an execution provider that requests
 // NHWC layout is enabled such as NNAPI, XNNPACK or QNN.
@@ -249,4 +299,103 @@ static const char* const kOrtSessionOptionEpContextFilePath = "ep.context_file_p
 // Flag to specify whether to dump the EP context into the Onnx model.
 // "0": dump the EP context into separate file, keep the file name in the Onnx model.
 // "1": dump the EP context into the Onnx model. (default).
-static const char* const kOrtSessionOptionEpContextEmbedMode = "ep.context_embed_mode";
\ No newline at end of file
+static const char* const kOrtSessionOptionEpContextEmbedMode = "ep.context_embed_mode";
+
+// Number of dedicated threads that run the requests of RunAsync.
+// "0": RunAsync schedules each request on the intra-op thread pool, where it occupies a worker for the whole run. (default)
+// "n": RunAsync requests are queued and run on a session owned pool of n threads, at most n of them concurrently.
+//      The priority and deadline of a request can be set with the RunOptions config keys
+//      kOrtRunOptionsConfigAsyncRunPriority and kOrtRunOptionsConfigAsyncRunDeadlineMs.
+static const char* const kOrtSessionOptionsConfigAsyncRunNumThreads = "session.async_run.num_threads";
+
+// Maximum number of RunAsync requests waiting to start when kOrtSessionOptionsConfigAsyncRunNumThreads is set.
+// RunAsync fails immediately, without calling the callback, when the queue is full.
+// "0": unbounded. (default)
+static const char* const kOrtSessionOptionsConfigAsyncRunMaxQueueDepth = "session.async_run.max_queue_depth";
+
+// Configure whether the initialization of the session uses the intra op thread pool to deserialize the initializers
+// on CPU, create the kernels of the CPU execution provider and pre-pack their constant inputs concurrently.
+// Constant folding also computes the independent foldable nodes concurrently.
+// The result is the same as that of a serial initialization. Pre-packing of the initializers shared across sessions
+// with a PrepackedWeightsContainer remains serial.
+// "0": default, the initialization runs on the calling thread
+// "1": the initialization runs on the intra op thread pool
+static const char* const kOrtSessionOptionsConfigParallelInitialization = "session.parallel_initialization";
+
+// Configure whether the Graph::Resolve calls between the graph transformations skip the type and shape inferencing
+// of the nodes whose op, attributes and input types have not changed since the previous Resolve.
+// "0": default, every Resolve re-infers all nodes
+// "1": only the nodes around the modified parts of the graph are re-inferred
+// "2": as "1", but the unchanged nodes are re-inferred as well, and the initialization fails if that changes their
+//      output types. For debugging.
+static const char* const kOrtSessionOptionsConfigIncrementalGraphResolve = "session.graph_resolve.incremental";
+
+// Directory of a cache of optimized models, in ORT format.
+// When set, the first session of an ONNX model saves the optimized graph to the directory, keyed by a hash of the
+// model bytes, the ORT version, the session options, the execution providers and the instruction set of the CPU.
+// The external data files of the model are keyed by their path, size and last write time.
+// The sessions created later with the same key load the optimized graph instead of optimizing the model again.
+// The cache is only used for ONNX models loaded from a file or a buffer, and not when optimized_model_filepath is set
+// or when the session supplies initializers through AddInitializer or AddExternalInitializers.
+// Optimized graphs containing nodes compiled by an execution provider are not cached. Entries that fail to load are
+// replaced.
+// "": default, no cache
+static const char* const kOrtSessionOptionsConfigOptimizedModelCacheDir = "session.optimized_model_cache_dir";
+
+// Configure whether the runs of the main graph skip the nodes that are not needed to compute the requested outputs.
+// The nodes needed by each set of requested outputs are computed on the first run that requests it, once per prepared
+// run, and the runs that skip nodes use memory patterns of their own. RunOptions::only_execute_path_to_fetches
+// requests it for a single run. Nodes with side effects but no outputs needed by the run, such as the nodes updating
+// weights in training graphs, are skipped too.
+// "0": default, every run executes all the nodes
+// "1": runs skip the nodes not needed by their outputs
+static const char* const kOrtSessionOptionsConfigPruneToFetches = "session.prune_to_fetches";
+
+// Configure whether the runs of the main graph record their planned and actual peak memory usage by the shapes of
+// their inputs, to be queried with SessionGetPeakMemoryUsage. The usage of up to 256 distinct input shapes is recorded.
+// "0": default, the memory usage is not recorded
+// "1": the memory usage of the runs is recorded
+static const char* const kOrtSessionOptionsConfigRecordPeakMemoryUsage = "session.record_peak_memory_usage";
+
+// Configure whether the NCHWc layout transformer estimates if converting each region of connected nodes to NCHWc
+// pays off. A region is left in NCHW when the estimated cost of reordering the values at its boundary to and from
+// NCHWc exceeds the estimated savings of its NCHWc convolutions, as for regions of a few small convolutions.
+// "0": default, every node that can use the NCHWc layout is converted
+// "1": only the regions estimated to be faster in NCHWc are converted
+static const char* const kOrtSessionOptionsConfigNchwcCostModel = "optimization.nchwc_cost_model";
+
+// Configure whether the memory patterns are planned from the symbolic shapes of the values, resolved from the input
+// shapes, when a run sees new input shapes. The pattern is then used by that first run instead of being traced from
+// its allocations. The patterns are traced as before when the shape of an activation cannot be resolved.
+// Only used when memory patterns are enabled.
+// "0": the patterns are traced in the first run with each set of input shapes. the default in inference builds.
+// "1": the patterns are planned statically when possible. the default in training builds.
+static const char* const kOrtSessionOptionsConfigStaticMemoryPlanning = "session.static_memory_planning";
+
+// Configure the maximum ratio between the size of the outputs of a node folded by constant folding and the size of its
+// constant inputs, so that folding does not expand the initializers, as when folding a ConstantOfShape or an Expand.
+// The nodes whose outputs would exceed it are left in the graph and computed at run time.
+// "0": default, no limit
+// A positive floating point value such as "2.0" limits the outputs to twice the size of the inputs.
+static const char* const kOrtSessionOptionsConfigConstantFoldingMaxSizeRatio =
+    "optimization.constant_folding_max_size_ratio";
+
+// Configure after how many executions with the same input shapes a node caches the state its kernel derives from
+// them, such as the broadcast plan and GEMM parameters of MatMul, so the later executions with these shapes skip
+// computing it. Only the kernels that opt in through OpKernelContext::GetShapeSpecializedState use it, and each node
+// caches the state of a few input shapes.
+// "0": default, shape specialization is disabled
+// A positive integer such as "3" caches the state on the third execution with the same input shapes.
+static const char* const kOrtSessionOptionsConfigShapeSpecializationHotThreshold =
+    "session.shape_specialization_hot_threshold";
+
+// Configure whether the constant initializers are shared by content between the sessions of the same environment,
+// so that sessions of models with identical weights, such as fine-tuned variants of a base model, hold a single copy
+// of each. The initializers are matched by a hash of their bytes, and their pre-packed forms are shared as well
+// unless a PrepackedWeightsContainer was provided to the session. A shared initializer is released with the last
+// session holding it. The pre-packed forms are released when no session sharing initializers by content is left, so
+// an environment whose sessions are replaced one at a time keeps the pre-packed forms of the released models.
+// Only the initializers of at least 1 KiB consumed by nodes assigned to the CPU execution provider are shared.
+// "0": default, the initializers are not shared
+// "1": the initializers are shared by content
+static const char* const kOrtSessionOptionsConfigShareInitializersByContent = "session.share_initializers_by_content";
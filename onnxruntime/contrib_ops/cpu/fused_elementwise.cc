@@ -0,0 +1,325 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", {DataTypeImpl::GetTensorType<float>(),
+                                            DataTypeImpl::GetTensorType<bool>()}),
+    FusedElementwise);
+
+namespace {
+
+// Number of output elements computed at a time. Each register of a tile takes 4KB, so the registers of a chain of
+// a few dozen operators fit in the L2 cache.
+constexpr std::ptrdiff_t kTileSize = 1024;
+
+enum class InputAccess {
+  kContiguous,  // same shape as the output
+  kScalar,      // a single element
+  kRepeated,    // same shape as the innermost dimensions of the output
+  kStrided,     // any other broadcast
+};
+
+struct InputInfo {
+  const Tensor* tensor;
+  InputAccess access;
+  // the stride of each output dimension in the input, 0 for the broadcast dimensions. only set for kStrided.
+  TensorShapeVector strides;
+};
+
+Status ComputeOutputDims(const std::string& node_name, gsl::span<const Tensor* const> inputs,
+                         TensorShapeVector& output_dims) {
+  size_t rank = 0;
+  for (const auto* input : inputs) {
+    rank = std::max(rank, input->Shape().NumDimensions());
+  }
+
+  output_dims.assign(rank, 1);
+  for (const auto* input : inputs) {
+    const auto input_dims = input->Shape().GetDims();
+    const size_t offset = rank - input_dims.size();
+    for (size_t i = 0; i < input_dims.size(); ++i) {
+      auto& output_dim = output_dims[offset + i];
+      if (input_dims[i] == output_dim || input_dims[i] == 1) {
+        continue;
+      }
+      if (output_dim != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, node_name, ": input shape ", input->Shape(),
+                               " cannot be broadcast with the other inputs.");
+      }
+      output_dim = input_dims[i];
+    }
+  }
+
+  return Status::OK();
+}
+
+InputInfo GetInputInfo(const Tensor& input, gsl::span<const int64_t> output_dims, int64_t output_size) {
+  InputInfo info{&input, InputAccess::kStrided, {}};
+  const int64_t input_size = input.Shape().Size();
+  if (input_size == output_size) {
+    info.access = InputAccess::kContiguous;
+    return info;
+  }
+  if (input_size == 1) {
+    info.access = InputAccess::kScalar;
+    return info;
+  }
+
+  auto input_dims = input.Shape().GetDims();
+  while (!input_dims.empty() && input_dims.front() == 1) {
+    input_dims = input_dims.subspan(1);
+  }
+  if (std::equal(input_dims.begin(), input_dims.end(), output_dims.end() - input_dims.size())) {
+    info.access = InputAccess::kRepeated;
+    return info;
+  }
+
+  const auto all_input_dims = input.Shape().GetDims();
+  const size_t offset = output_dims.size() - all_input_dims.size();
+  info.strides.assign(output_dims.size(), 0);
+  int64_t stride = 1;
+  for (size_t i = all_input_dims.size(); i-- > 0;) {
+    if (all_input_dims[i] != 1) {
+      info.strides[offset + i] = stride;
+    }
+    stride *= all_input_dims[i];
+  }
+  return info;
+}
+
+// Loads the elements [begin, begin + count) of the input broadcast to the output shape.
+template <typename T>
+void LoadInput(const InputInfo& info, gsl::span<const int64_t> output_dims, std::ptrdiff_t begin,
+               std::ptrdiff_t count, float* buffer) {
+  const T* data = info.tensor->Data<T>();
+  switch (info.access) {
+    case InputAccess::kContiguous:
+      std::transform(data + begin, data + begin + count, buffer, [](T value) { return static_cast<float>(value); });
+      break;
+    case InputAccess::kScalar:
+      std::fill_n(buffer, count, static_cast<float>(*data));
+      break;
+    case InputAccess::kRepeated: {
+      const std::ptrdiff_t input_size = narrow<std::ptrdiff_t>(info.tensor->Shape().Size());
+      std::ptrdiff_t offset = begin % input_size;
+      for (std::ptrdiff_t i = 0; i < count;) {
+        const std::ptrdiff_t run = std::min(count - i, input_size - offset);
+        std::transform(data + offset, data + offset + run, buffer + i,
+                       [](T value) { return static_cast<float>(value); });
+        i += run;
+        offset = 0;
+      }
+      break;
+    }
+    case InputAccess::kStrided: {
+      const size_t rank = output_dims.size();
+      TensorShapeVector index(rank);
+      int64_t remaining = begin;
+      int64_t offset = 0;
+      for (size_t d = rank; d-- > 0;) {
+        index[d] = remaining % output_dims[d];
+        remaining /= output_dims[d];
+        offset += index[d] * info.strides[d];
+      }
+      for (std::ptrdiff_t i = 0; i < count; ++i) {
+        buffer[i] = static_cast<float>(data[offset]);
+        for (size_t d = rank; d-- > 0;) {
+          offset += info.strides[d];
+          if (++index[d] < output_dims[d]) {
+            break;
+          }
+          offset -= index[d] * info.strides[d];
+          index[d] = 0;
+        }
+      }
+      break;
+    }
+  }
+}
+
+}  // namespace
+
+const FusedElementwise::OpInfo FusedElementwise::kOpInfos[] = {
+    {"Add", OpType::kAdd, 2},
+    {"Sub", OpType::kSub, 2},
+    {"Mul", OpType::kMul, 2},
+    {"Div", OpType::kDiv, 2},
+    {"Relu", OpType::kRelu, 1},
+    {"Neg", OpType::kNeg, 1},
+    {"Sigmoid", OpType::kSigmoid, 1},
+    {"Tanh", OpType::kTanh, 1},
+    {"Erf", OpType::kErf, 1},
+    {"Where", OpType::kWhere, 3},
+    {"Cast", OpType::kCast, 1},
+};
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  const auto ops = info.GetAttrsOrDefault<std::string>("ops");
+  const auto operands = info.GetAttrsOrDefault<int64_t>("operands");
+  ORT_ENFORCE(!ops.empty() && operands.size() == ops.size() * 3,
+              "FusedElementwise requires 3 operands for each of its ops.");
+
+  const int num_inputs = static_cast<int>(info.GetInputCount());
+  instructions_.reserve(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    const auto* op_info = std::find_if(std::begin(kOpInfos), std::end(kOpInfos),
+                                       [&](const OpInfo& op_info) { return ops[i] == op_info.name; });
+    ORT_ENFORCE(op_info != std::end(kOpInfos), "FusedElementwise does not support ", ops[i]);
+    Instruction instruction{op_info->op_type, {}};
+    const int arity = op_info->arity;
+
+    // an operand is an input or the result of a previous op
+    for (int j = 0; j < 3; ++j) {
+      const int64_t operand = operands[i * 3 + j];
+      ORT_ENFORCE(j < arity ? (operand >= 0 && operand < num_inputs + static_cast<int64_t>(i)) : operand == -1,
+                  "Invalid operand ", operand, " of op ", i, " of FusedElementwise.");
+      instruction.operands[j] = static_cast<int>(operand);
+    }
+    instructions_.push_back(instruction);
+  }
+}
+
+const float* FusedElementwise::RunInstruction(const Instruction& instruction,
+                                              gsl::span<const float* const> registers,
+                                              float* output, std::ptrdiff_t count) {
+  const auto& operands = instruction.operands;
+  auto a = ConstEigenVectorArrayMap<float>(registers[operands[0]], count);
+  auto y = EigenVectorArrayMap<float>(output, count);
+  switch (instruction.op_type) {
+    case OpType::kAdd:
+      y = a + ConstEigenVectorArrayMap<float>(registers[operands[1]], count);
+      break;
+    case OpType::kSub:
+      y = a - ConstEigenVectorArrayMap<float>(registers[operands[1]], count);
+      break;
+    case OpType::kMul:
+      y = a * ConstEigenVectorArrayMap<float>(registers[operands[1]], count);
+      break;
+    case OpType::kDiv:
+      y = a / ConstEigenVectorArrayMap<float>(registers[operands[1]], count);
+      break;
+    case OpType::kRelu:
+      y = a.cwiseMax(0.0f);
+      break;
+    case OpType::kNeg:
+      y = -a;
+      break;
+    case OpType::kSigmoid:
+      MlasComputeLogistic(registers[operands[0]], output, static_cast<size_t>(count));
+      break;
+    case OpType::kTanh:
+      MlasComputeTanh(registers[operands[0]], output, static_cast<size_t>(count));
+      break;
+    case OpType::kErf:
+      MlasComputeErf(registers[operands[0]], output, static_cast<size_t>(count));
+      break;
+    case OpType::kWhere:
+      y = (a != 0.0f).select(ConstEigenVectorArrayMap<float>(registers[operands[1]], count),
+                             ConstEigenVectorArrayMap<float>(registers[operands[2]], count));
+      break;
+    case OpType::kCast:
+      // the registers already hold floats
+      return registers[operands[0]];
+  }
+  return output;
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  const int num_inputs = context->InputCount();
+  InlinedVector<const Tensor*> inputs;
+  inputs.reserve(num_inputs);
+  for (int i = 0; i < num_inputs; ++i) {
+    inputs.push_back(context->Input<Tensor>(i));
+  }
+
+  TensorShapeVector output_dims;
+  ORT_RETURN_IF_ERROR(ComputeOutputDims(Node().Name(), inputs, output_dims));
+  Tensor& output = *context->Output(0, output_dims);
+  const int64_t output_size = output.Shape().Size();
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  InlinedVector<InputInfo> input_infos;
+  input_infos.reserve(num_inputs);
+  for (const auto* input : inputs) {
+    input_infos.push_back(GetInputInfo(*input, output_dims, output_size));
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  const size_t num_registers = num_inputs + instructions_.size();
+  float* output_data = output.MutableData<float>();
+  const std::ptrdiff_t num_tiles = narrow<std::ptrdiff_t>((output_size + kTileSize - 1) / kTileSize);
+  const TensorOpCost cost{static_cast<double>(num_inputs * kTileSize * sizeof(float)),
+                          static_cast<double>(kTileSize * sizeof(float)),
+                          static_cast<double>(instructions_.size() * kTileSize * 4)};
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), num_tiles, cost,
+      [&](std::ptrdiff_t first_tile, std::ptrdiff_t last_tile) {
+        auto buffers = IAllocator::MakeUniquePtr<float>(allocator, num_registers * kTileSize);
+        InlinedVector<const float*> registers(num_registers);
+
+        for (std::ptrdiff_t tile = first_tile; tile < last_tile; ++tile) {
+          const std::ptrdiff_t begin = tile * kTileSize;
+          const std::ptrdiff_t count = std::min<std::ptrdiff_t>(kTileSize, output_size - begin);
+
+          for (int i = 0; i < num_inputs; ++i) {
+            const auto& info = input_infos[i];
+            float* buffer = buffers.get() + i * kTileSize;
+            const bool is_float = info.tensor->IsDataType<float>();
+            if (is_float && info.access == InputAccess::kContiguous) {
+              registers[i] = info.tensor->Data<float>() + begin;
+              continue;
+            }
+            registers[i] = buffer;
+            // scalars are loaded once for all the tiles
+            if (info.access == InputAccess::kScalar && tile != first_tile) {
+              continue;
+            }
+            const std::ptrdiff_t load_count = info.access == InputAccess::kScalar ? kTileSize : count;
+            if (is_float) {
+              LoadInput<float>(info, output_dims, begin, load_count, buffer);
+            } else {
+              LoadInput<bool>(info, output_dims, begin, load_count, buffer);
+            }
+          }
+
+          // the last instruction writes the output directly
+          for (size_t i = 0; i < instructions_.size(); ++i) {
+            float* result = i + 1 == instructions_.size() ? output_data + begin
+                                                           : buffers.get() + (num_inputs + i) * kTileSize;
+            registers[num_inputs + i] = RunInstruction(instructions_[i], registers, result, count);
+          }
+
+          if (registers.back() != output_data + begin) {
+            std::memcpy(output_data + begin, registers.back(), count * sizeof(float));
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
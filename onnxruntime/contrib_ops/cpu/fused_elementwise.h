@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/**
+ * Evaluates a chain of elementwise operators fused by ElementwiseChainFusion.
+ *
+ * Registers [0, N) hold the N inputs and register N + i holds the result of the i-th operator. The output is computed
+ * tile by tile, so the registers of a tile stay in cache and the intermediate values of the chain are never written
+ * to memory.
+ */
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  enum class OpType {
+    kAdd,
+    kSub,
+    kMul,
+    kDiv,
+    kRelu,
+    kNeg,
+    kSigmoid,
+    kTanh,
+    kErf,
+    kWhere,
+    kCast,
+  };
+
+  struct OpInfo {
+    const char* name;
+    OpType op_type;
+    int arity;
+  };
+
+  static const OpInfo kOpInfos[];
+
+  struct Instruction {
+    OpType op_type;
+    std::array<int, 3> operands;
+  };
+
+  // Computes one tile of an instruction into output, and returns where the result is. Cast returns its operand.
+  static const float* RunInstruction(const Instruction& instruction, gsl::span<const float* const> registers,
+                                     float* output, std::ptrdiff_t count);
+
+  std::vector<Instruction> instructions_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
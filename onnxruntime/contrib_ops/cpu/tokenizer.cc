@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/common/common.h"
+#include "core/common/inlined_containers.h"
 #include "core/common/narrow.h"
 #include "core/common/utf8_util.h"
 #include "core/framework/tensor.h"
@@ -196,8 +197,16 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
                                                size_t N, size_t C,
                                                gsl::span<const int64_t> input_dims) const {
   using namespace re2;
-  std::vector<std::vector<StringPiece>> rows;
-  rows.reserve(N * C);
+  // The tokens of all the rows in a single vector, so that collecting them doesn't allocate per row. The tokens
+  // point into the input strings, and their bytes are only copied to the output.
+  // row_ends[i] is the number of tokens of rows [0, i].
+  InlinedVector<StringPiece> tokens;
+  InlinedVector<size_t> row_ends;
+  row_ends.reserve(N * C);
+
+  // The tokens of the current row before and after splitting them on a separator. Reused across the rows.
+  InlinedVector<StringPiece> row;
+  InlinedVector<StringPiece> split_row;
 
   // We do not constraint the search to match
   // on the beginning or end of the string
@@ -219,10 +228,11 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
                     "Input string contains invalid utf8 chars: " + s);
     }
 
-    std::vector<StringPiece> row{s};
+    row.clear();
+    row.emplace_back(s);
 
     for (const auto& sep : separators_) {
-      std::vector<StringPiece> tokens;
+      split_row.clear();
       for (const auto& text : row) {
         const auto end_pos = text.length();
         size_t start_pos = 0;
@@ -245,7 +255,7 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
                             "Match contains invalid utf8 chars: " + std::string{submatch});
             }
             if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, token_len);
+              split_row.emplace_back(text.data() + start_pos, token_len);
             }
             // Update starting position
             // Guard against empty string match
@@ -264,16 +274,17 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
             utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
                      trailing_len, utf8_chars);
             if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, trailing_len);
+              split_row.emplace_back(text.data() + start_pos, trailing_len);
             }
           }
         } while (match);
       }  // row
       // Replace the row with the results of this tokenezation
-      row.swap(tokens);
+      row.swap(split_row);
     }  // separators_
     max_tokens = std::max(max_tokens, row.size());
-    rows.push_back(std::move(row));
+    tokens.insert(tokens.end(), row.begin(), row.end());
+    row_ends.push_back(tokens.size());
     ++curr_input;
   }
 
@@ -301,8 +312,9 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
   const size_t max_output_index = N * C * max_tokens;
 #endif
   size_t output_index = 0;
+  size_t row_begin = 0;
   curr_input = input_data;
-  for (auto& row : rows) {
+  for (const size_t row_end : row_ends) {
 #ifdef _DEBUG
     size_t c_idx = output_index;
 #endif
@@ -311,15 +323,17 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
       ++output_index;
     }
     // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.size());
+    const size_t row_size = row_end - row_begin;
+    for (size_t t = row_begin; t < row_end; ++t) {
+      (output_data + output_index)->assign(tokens[t].data(), tokens[t].size());
       ++output_index;
     }
+    row_begin = row_end;
     if (mark_) {
       (output_data + output_index)->assign(&end_text, 1);
       ++output_index;
     }
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
+    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row_size;
     for (size_t p = 0; p < pads; ++p) {
       *(output_data + output_index) = pad_value_;
       ++output_index;
@@ -337,10 +351,12 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
                                   size_t N, size_t C,
                                   gsl::span<const int64_t> input_dims) const {
   using namespace re2;
-  // Represents a token that will be output after
-  // first is the index, second is the size;
-  std::vector<std::vector<StringPiece>> tokens;
-  tokens.reserve(N * C);
+  // The tokens of all the rows in a single vector, so that collecting them doesn't allocate per row. The tokens
+  // point into the input strings, and their bytes are only copied to the output.
+  // row_ends[i] is the number of tokens of rows [0, i].
+  InlinedVector<StringPiece> tokens;
+  InlinedVector<size_t> row_ends;
+  row_ends.reserve(N * C);
 
   size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
@@ -362,8 +378,7 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
                     "Input string contains invalid utf8 chars: " + s);
     }
 
-    tokens.emplace_back();
-    auto& row = tokens.back();
+    const size_t row_begin = tokens.size();
 
     StringPiece text(s);
     const auto end_pos = s.length();
@@ -387,7 +402,7 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
                         "Match contains invalid utf8 chars: " + std::string{submatch});
         }
         if (utf8_chars >= size_t(mincharnum_)) {
-          row.push_back(submatch);
+          tokens.push_back(submatch);
           start_pos = match_pos + token_len;
         } else {
           size_t bytes = 0;
@@ -396,7 +411,8 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
         }
       }
     } while (match);
-    max_tokens = std::max(max_tokens, row.size());
+    max_tokens = std::max(max_tokens, tokens.size() - row_begin);
+    row_ends.push_back(tokens.size());
     ++curr_input;
   }
 
@@ -426,7 +442,8 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
 #endif
   curr_input = input_data;
   size_t output_index = 0;
-  for (const auto& row : tokens) {
+  size_t row_begin = 0;
+  for (const size_t row_end : row_ends) {
     assert(curr_input != last);
 #ifdef _DEBUG
     size_t c_idx = output_index;
@@ -436,15 +453,17 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
       ++output_index;
     }
     // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.length());
+    const size_t row_size = row_end - row_begin;
+    for (size_t t = row_begin; t < row_end; ++t) {
+      (output_data + output_index)->assign(tokens[t].data(), tokens[t].size());
       ++output_index;
     }
+    row_begin = row_end;
     if (mark_) {
       (output_data + output_index)->assign(&end_text, 1);
       ++output_index;
     }
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
+    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row_size;
     for (size_t p = 0; p < pads; ++p) {
       *(output_data + output_index) = pad_value_;
       ++output_index;
@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 
@@ -20,6 +21,7 @@ limitations under the License.
 #include "core/common/common.h"
 #include "core/common/cpuid_info.h"
 #include "core/common/eigen_common_wrapper.h"
+#include "core/common/logging/logging.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
 #if !defined(ORT_MINIMAL_BUILD)
@@ -200,6 +202,7 @@ const char* ThreadPoolProfiler::GetEventName(ThreadPoolEvent event) {
 
 void ThreadPoolProfiler::LogThreadId(int thread_idx) {
   child_thread_stats_[thread_idx].thread_id_ = std::this_thread::get_id();
+  child_thread_stats_[thread_idx].trace_thread_id_ = logging::GetThreadId();
 }
 
 void ThreadPoolProfiler::LogRun(int thread_idx) {
@@ -230,11 +233,168 @@ void ThreadPoolProfiler::LogRun(int thread_idx) {
   }
 }
 
+void ThreadPoolProfiler::LogSpin(int thread_idx, int spin_count, bool blocked) {
+  if (enabled_) {
+    auto& stat = child_thread_stats_[thread_idx];
+    if (blocked) {
+      stat.num_block_++;
+    } else {
+      stat.num_spin_hit_++;
+    }
+    stat.spin_count_ = spin_count;
+  }
+}
+
+void ThreadPoolProfiler::TraceBuffer::Reset() {
+  if (!records_) {
+    records_ = std::make_unique<TraceRecord[]>(kCapacity);
+  }
+  const size_t num_records = std::min(num_records_.load(), kCapacity);
+  for (size_t i = 0; i < num_records; ++i) {
+    records_[i].complete_.store(false, std::memory_order_relaxed);
+  }
+  num_records_ = 0;
+}
+
+ThreadPoolProfiler::TraceRecord* ThreadPoolProfiler::TraceBuffer::Append() {
+  // only parallel loops run by several threads at once contend for the buffer
+  const size_t idx = num_records_.fetch_add(1, std::memory_order_relaxed);
+  return idx < kCapacity ? &records_[idx] : nullptr;
+}
+
+void ThreadPoolProfiler::StartTracing(onnxruntime::TimePoint start_time, size_t max_num_events) {
+  std::lock_guard<OrtMutex> lock(trace_mutex_);
+  if (!child_trace_buffers_) {
+    child_trace_buffers_ = std::make_unique<TraceBuffer[]>(num_threads_);
+  }
+  // the buffers are kept until the pool is destroyed, a task that started before tracing stopped
+  // may still be writing to them
+  for (int i = 0; i < num_threads_; ++i) {
+    child_trace_buffers_[i].Reset();
+  }
+  parallel_loop_trace_buffer_.Reset();
+  trace_start_time_ = start_time;
+  max_num_trace_events_ = max_num_events;
+  tracing_ = true;
+}
+
+void ThreadPoolProfiler::StopTracing(onnxruntime::profiling::Events& events) {
+  std::lock_guard<OrtMutex> lock(trace_mutex_);
+  if (!tracing_) {
+    return;
+  }
+  tracing_ = false;
+  size_t max_num_events = max_num_trace_events_;
+  FormatTraceRecords(parallel_loop_trace_buffer_, events, max_num_events);
+  for (int i = 0; i < num_threads_; ++i) {
+    FormatTraceRecords(child_trace_buffers_[i], events, max_num_events);
+  }
+}
+
+void ThreadPoolProfiler::FormatTraceRecords(TraceBuffer& buffer, onnxruntime::profiling::Events& events,
+                                            size_t& max_num_events) {
+  const auto pid = logging::GetProcessId();
+  auto add_event = [&](const TraceRecord& record, const char* name, onnxruntime::TimePoint start,
+                       onnxruntime::TimePoint end, std::unordered_map<std::string, std::string>&& args) {
+    if (max_num_events == 0) {
+      return;
+    }
+    --max_num_events;
+    events.emplace_back(profiling::THREAD_POOL_EVENT, pid, static_cast<int>(record.thread_id_),
+                        std::string(name), TimeDiffMicroSeconds(trace_start_time_, start),
+                        TimeDiffMicroSeconds(start, end), std::move(args));
+  };
+
+  const size_t num_records = std::min(buffer.num_records_.load(std::memory_order_acquire), TraceBuffer::kCapacity);
+  for (size_t i = 0; i < num_records; ++i) {
+    const auto& record = buffer.records_[i];
+    // skip a record still being written by a task that outlived tracing
+    if (!record.complete_.load(std::memory_order_acquire)) {
+      continue;
+    }
+    switch (record.kind_) {
+      case TraceRecord::PARALLEL_LOOP:
+        add_event(record, "parallel_loop", record.start_, record.end_,
+                  {{"thread_pool_name", thread_pool_name_},
+                   {"num_work_items", std::to_string(record.num_work_items_)},
+                   {"block_size", std::to_string(record.block_size_)},
+                   {"dispatch_us", std::to_string(TimeDiffMicroSeconds(record.start_, record.mid_))}});
+        break;
+      case TraceRecord::TASK:
+        add_event(record, "task", record.start_, record.end_, {{"stolen", record.flag_ ? "1" : "0"}});
+        break;
+      case TraceRecord::IDLE:
+        add_event(record, "spin", record.start_, record.flag_ ? record.mid_ : record.end_, {});
+        if (record.flag_) {
+          add_event(record, "block", record.mid_, record.end_, {});
+        }
+        break;
+    }
+  }
+}
+
+void ThreadPoolProfiler::TraceParallelLoop(onnxruntime::TimePoint start, onnxruntime::TimePoint dispatched,
+                                           unsigned num_work_items, std::ptrdiff_t block_size) {
+  const auto now = Clock::now();
+  // the pool may still be running loops that started before tracing stopped
+  if (!tracing_.load(std::memory_order_acquire)) {
+    return;
+  }
+  auto* record = parallel_loop_trace_buffer_.Append();
+  if (record) {
+    record->kind_ = TraceRecord::PARALLEL_LOOP;
+    record->thread_id_ = logging::GetThreadId();
+    record->num_work_items_ = num_work_items;
+    record->block_size_ = block_size;
+    record->start_ = start;
+    record->mid_ = dispatched;
+    record->end_ = now;
+    record->complete_.store(true, std::memory_order_release);
+  }
+}
+
+void ThreadPoolProfiler::TraceTask(int thread_idx, onnxruntime::TimePoint start, bool stolen) {
+  const auto now = Clock::now();
+  if (!tracing_.load(std::memory_order_acquire)) {
+    return;
+  }
+  auto* record = child_trace_buffers_[thread_idx].Append();
+  if (record) {
+    record->kind_ = TraceRecord::TASK;
+    record->flag_ = stolen;
+    record->thread_id_ = child_thread_stats_[thread_idx].trace_thread_id_;
+    record->start_ = start;
+    record->end_ = now;
+    record->complete_.store(true, std::memory_order_release);
+  }
+}
+
+void ThreadPoolProfiler::TraceIdle(int thread_idx, onnxruntime::TimePoint start, onnxruntime::TimePoint block_start,
+                                   bool blocked) {
+  const auto now = Clock::now();
+  if (!tracing_.load(std::memory_order_acquire)) {
+    return;
+  }
+  auto* record = child_trace_buffers_[thread_idx].Append();
+  if (record) {
+    record->kind_ = TraceRecord::IDLE;
+    record->flag_ = blocked;
+    record->thread_id_ = child_thread_stats_[thread_idx].trace_thread_id_;
+    record->start_ = start;
+    record->mid_ = block_start;
+    record->end_ = now;
+    record->complete_.store(true, std::memory_order_release);
+  }
+}
+
 std::string ThreadPoolProfiler::DumpChildThreadStat() {
   std::stringstream ss;
   for (int i = 0; i < num_threads_; ++i) {
     ss << "\"" << child_thread_stats_[i].thread_id_ << "\": {"
        << "\"num_run\": " << child_thread_stats_[i].num_run_ << ", "
+       << "\"num_spin_hit\": " << child_thread_stats_[i].num_spin_hit_ << ", "
+       << "\"num_block\": " << child_thread_stats_[i].num_block_ << ", "
+       << "\"spin_count\": " << child_thread_stats_[i].spin_count_ << ", "
        << "\"core\": " << child_thread_stats_[i].core_ << "}"
        << (i == num_threads_ - 1 ? "" : ",");
   }
@@ -331,6 +491,38 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
     return false;
   }
 
+  // Attempt to claim iterations for guided scheduling.  Like ClaimIterations, but the claim is a
+  // share of the iterations remaining in the shard, in multiples of block_size: 1 / (2 * claimants_per_shard)
+  // of them, or a single block towards the end of the shard.  The share is derived from the shard's own
+  // counter, so the claims contend on no more state than the fixed-size claims do.
+  bool ClaimGuidedIterations(unsigned my_home_shard,
+                             unsigned& my_shard,
+                             uint64_t& my_start,
+                             uint64_t& my_end,
+                             uint64_t block_size,
+                             uint64_t claimants_per_shard) {
+    do {
+      auto& shard = _shards[my_shard];
+      const uint64_t next = shard._next.load(::std::memory_order_relaxed);
+      if (next < shard._end) {
+        const uint64_t num_blocks = (shard._end - next) / (2 * claimants_per_shard * block_size);
+        const uint64_t claim = std::max<uint64_t>(1, num_blocks) * block_size;
+        uint64_t temp_start = shard._next.fetch_add(claim);
+        if (temp_start < shard._end) {
+          my_start = temp_start;
+          my_end = std::min(shard._end, temp_start + claim);
+          return true;
+        }
+      }
+      my_shard = (my_shard + 1) % _num_shards;
+    } while (my_shard != my_home_shard);
+    return false;
+  }
+
+  unsigned NumShards() const {
+    return _num_shards;
+  }
+
  private:
   // Derive the number of shards to use for a given loop.  We require
   // at least one block of work per shard, and subject to the
@@ -416,11 +608,38 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
   }
 
   auto d_of_p = DegreeOfParallelism(this);
-  if (thread_options_.dynamic_block_base_ <= 0) {
+  if (thread_options_.dynamic_block_base_ <= 0 && thread_options_.guided_scheduling &&
+      (force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid())) {
+    // Guided scheduling for hybrid CPUs, if enabled.  Workers on slower (efficiency) cores would otherwise hold
+    // up the end of the loop with blocks as large as those of the faster cores.  Each claim instead takes a share
+    // of the iterations remaining in its shard, in multiples of block_size: early claims are large, keeping the
+    // number of atomic operations low, and the blocks get smaller towards the end of the loop.  Workers that run
+    // faster come back sooner and so claim more of the work, which sizes the work of each worker by its actual
+    // throughput.
+    auto num_blocks = total / block_size;
+    auto num_threads_inc_main = NumLoopThreads();
+    int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(num_threads_inc_main), num_blocks));
+    assert(num_work_items > 0);
+
+    LoopCounter lc(total, d_of_p, block_size);
+    // the work items sharing a shard, which the guided claims divide its remaining iterations between
+    const uint64_t claimants_per_shard = (static_cast<uint64_t>(num_work_items) + lc.NumShards() - 1) / lc.NumShards();
+    std::function<void(unsigned)> run_work = [&](unsigned idx) {
+      unsigned my_home_shard = lc.GetHomeShard(idx);
+      unsigned my_shard = my_home_shard;
+      uint64_t my_iter_start, my_iter_end;
+      while (lc.ClaimGuidedIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, block_size,
+                                      claimants_per_shard)) {
+        fn(static_cast<std::ptrdiff_t>(my_iter_start),
+           static_cast<std::ptrdiff_t>(my_iter_end));
+      }
+    };
+    RunInParallel(run_work, num_work_items, block_size);
+  } else if (thread_options_.dynamic_block_base_ <= 0) {
     // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
     // hence we need at most one for each thread, even if the number of blocks of iterations is larger.
     auto num_blocks = total / block_size;
-    auto num_threads_inc_main = NumThreads() + 1;
+    auto num_threads_inc_main = NumLoopThreads();
     int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(num_threads_inc_main), num_blocks));
     assert(num_work_items > 0);
 
@@ -459,7 +678,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     };
     // Distribute task among all threads in the pool, reduce number of work items if
     // num_of_blocks is smaller than number of threads.
-    RunInParallel(run_work, std::min(NumThreads() + 1, num_of_blocks), base_block_size);
+    RunInParallel(run_work, std::min(NumLoopThreads(), num_of_blocks), base_block_size);
   }
 }
 
@@ -493,8 +712,34 @@ std::string ThreadPool::StopProfiling() {
   }
 }
 
+void ThreadPool::StartTracing(TimePoint start_time, size_t max_num_events) {
+  if (underlying_threadpool_) {
+    underlying_threadpool_->StartTracing(start_time, max_num_events);
+  }
+}
+
+void ThreadPool::StopTracing(profiling::Events& events) {
+  if (underlying_threadpool_) {
+    underlying_threadpool_->StopTracing(events);
+  }
+}
+
 namespace {
 thread_local std::optional<ThreadPoolParallelSection> current_parallel_section;
+thread_local int current_loop_thread_limit = 0;
+}  // namespace
+
+ThreadPool::ScopedLoopThreadLimit::ScopedLoopThreadLimit(int max_threads)
+    : prev_max_threads_(current_loop_thread_limit) {
+  current_loop_thread_limit = std::max(max_threads, 0);
+}
+
+ThreadPool::ScopedLoopThreadLimit::~ScopedLoopThreadLimit() {
+  current_loop_thread_limit = prev_max_threads_;
+}
+
+int ThreadPool::ScopedLoopThreadLimit::Current() {
+  return current_loop_thread_limit;
 }
 
 ThreadPool::ParallelSection::ParallelSection(ThreadPool* tp) {
@@ -546,6 +791,11 @@ bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
     return false;
   }
 
+  // Nor when the calling thread is limited to running loops by itself.
+  if (current_loop_thread_limit == 1) {
+    return false;
+  }
+
   return true;
 }
 
@@ -639,10 +889,11 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
   // When not using OpenMP, we parallelise over the N threads created by the pool
   // tp, plus 1 for the thread entering a loop.
   if (tp) {
-    if (tp->force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid()) {
-      return ((tp->NumThreads() + 1)) * TaskGranularityFactor;
+    const int num_loop_threads = tp->NumLoopThreads();
+    if (num_loop_threads > 1 && (tp->force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid())) {
+      return num_loop_threads * TaskGranularityFactor;
     } else {
-      return ((tp->NumThreads() + 1));
+      return num_loop_threads;
     }
   } else {
     return 1;
@@ -663,6 +914,18 @@ std::string ThreadPool::StopProfiling(concurrency::ThreadPool* tp) {
   }
 }
 
+void ThreadPool::StartTracing(concurrency::ThreadPool* tp, TimePoint start_time, size_t max_num_events) {
+  if (tp) {
+    tp->StartTracing(start_time, max_num_events);
+  }
+}
+
+void ThreadPool::StopTracing(concurrency::ThreadPool* tp, profiling::Events& events) {
+  if (tp) {
+    tp->StopTracing(events);
+  }
+}
+
 void ThreadPool::EnableSpinning() {
   if (extended_eigen_threadpool_) {
     extended_eigen_threadpool_->EnableSpinning();
@@ -684,6 +947,12 @@ int ThreadPool::NumThreads() const {
   }
 }
 
+int ThreadPool::NumLoopThreads() const {
+  const int num_threads_inc_main = NumThreads() + 1;
+  return current_loop_thread_limit > 0 ? std::min(num_threads_inc_main, current_loop_thread_limit)
+                                       : num_threads_inc_main;
+}
+
 // Return ID of the current thread within this pool.  Returns -1 for a thread outside the
 // current pool.
 int ThreadPool::CurrentThreadId() const {
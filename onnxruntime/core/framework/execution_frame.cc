@@ -342,13 +342,18 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 #ifdef ORT_ENABLE_STREAM
                                const DeviceStreamCollection* device_streams,
 #endif
-                               const SessionState& session_state)
+                               const SessionState& session_state,
+                               const InlinedHashSet<NodeIndex>* node_to_execute)
     : IExecutionFrame(session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo(), fetch_mlvalue_idxs),
 #ifdef ORT_ENABLE_STREAM
       device_streams_(device_streams),
 #endif
       session_state_(session_state),
-      mem_patterns_(nullptr) {
+      mem_patterns_(nullptr),
+      account_memory_(session_state.GetRecordMemoryUsage() || session_state.Profiler().IsEnabled()),
+      dynamic_bytes_per_value_(account_memory_
+                                   ? static_cast<size_t>(session_state.GetOrtValueNameIdxMap().MaxIdx()) + 1
+                                   : 0) {
   Init(
       feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(),
 #if !defined(DISABLE_SPARSE_TENSORS)
@@ -397,7 +402,8 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
+      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, node_to_execute,
+                                                          inferred_shapes_);
       // if no existing patterns, generate one in this execution frame
       if (!mem_patterns_) {
         planner_.emplace(*session_state.GetExecutionPlan());
@@ -416,8 +422,9 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
             // due to that we can still run and use those blocks (inside the arena logic) instead of one large one.
             // it's less efficient (the arena will add some overhead to coalesce individual allocations
             // back into blocks on 'free'), but better than failing completely.
+            auto peak_size = mem_patterns_->patterns[i].PeakSize();
+            planned_peak_bytes_ += peak_size;
             ORT_TRY {
-              auto peak_size = mem_patterns_->patterns[i].PeakSize();
               // Planning of one memory type should only happen once.
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
               ORT_ENFORCE(
@@ -461,6 +468,7 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
             if (buffer != nullptr) {
               buffers_[location] = BufferUniquePtr(buffer, BufferDeleter(alloc));
+              static_bytes_ += peak_size;
             }
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
             // Record activation memory pattern
@@ -596,6 +604,10 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
     Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
   }
 
+  if (account_memory_) {
+    AccountAllocation(ort_value_index, size);
+  }
+
   // trace the memory allocation.
   // don't trace the memory allocation on string tensors, as it need
   // placement new, we don't support it in memory pattern optimization.
@@ -695,8 +707,8 @@ static Status AllocateSparseTensor(OrtValue& mlvalue, const DataTypeImpl& ml_typ
 #endif
 
 Status ExecutionFrame::AllocateReusedOrtValueIfNotAllocatedHelper(int reuse_mlvalue_index, const TensorShape* shape) {
-  // In case OrtRunOptions.only_execute_path_to_fetches == true, it is possible that 'reuse_value'
-  // is not allocated (its upstream op is not executed due to the option).
+  // In case the execution skips the nodes not needed by the fetches, it is possible that 'reuse_value'
+  // is not allocated (its upstream op is not executed).
   // In this case we need to allocate 'reuse_value' and then let 'ort_value' to reuse it.
   OrtValue& reuse_value = GetMutableMLValue(reuse_mlvalue_index);
   if (!reuse_value.IsAllocated()) {
@@ -864,6 +876,9 @@ void ExecutionFrame::VerifyOutputSizes(int output_index, const Node& node, const
 Status ExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
   ORT_RETURN_IF_ERROR(IExecutionFrame::ReleaseMLValueImpl(ort_value_idx));
   TraceFree(ort_value_idx);
+  if (account_memory_) {
+    AccountFree(ort_value_idx);
+  }
   return Status::OK();
 }
 
@@ -913,6 +928,24 @@ void ExecutionFrame::TraceFree(int ort_value_idx) {
   }
 }
 
+void ExecutionFrame::AccountAllocation(int ort_value_idx, size_t size) {
+  dynamic_bytes_per_value_[ort_value_idx] += size;
+  const size_t bytes = dynamic_bytes_.fetch_add(size, std::memory_order_relaxed) + size;
+  size_t peak_bytes = peak_dynamic_bytes_.load(std::memory_order_relaxed);
+  while (bytes > peak_bytes &&
+         !peak_dynamic_bytes_.compare_exchange_weak(peak_bytes, bytes, std::memory_order_relaxed)) {
+  }
+}
+
+void ExecutionFrame::AccountFree(int ort_value_idx) {
+  // values that were not allocated individually, e.g. those on the memory pattern buffers, have 0 bytes.
+  const size_t size = dynamic_bytes_per_value_[ort_value_idx];
+  if (size > 0) {
+    dynamic_bytes_per_value_[ort_value_idx] = 0;
+    dynamic_bytes_.fetch_sub(size, std::memory_order_relaxed);
+  }
+}
+
 // generate memory pattern based on the tracing of memory allocation/free in current execution
 // return error if the planner is not setup.
 Status ExecutionFrame::GeneratePatterns(MemoryPatternGroup& out) {
@@ -920,7 +953,12 @@ Status ExecutionFrame::GeneratePatterns(MemoryPatternGroup& out) {
     return Status(ONNXRUNTIME, FAIL, "Memory pattern planner is not enabled on this execution framework.");
   }
 
-  return planner_->GeneratePatterns(out);
+  ORT_RETURN_IF_ERROR(planner_->GeneratePatterns(out));
+  planned_peak_bytes_ = 0;
+  for (const auto& pattern : out.patterns) {
+    planned_peak_bytes_ += pattern.PeakSize();
+  }
+  return Status::OK();
 }
 
 bool ExecutionFrame::TryGetInferredShape(int index, TensorShape& shape) const {
@@ -946,4 +984,8 @@ bool ExecutionFrame::TryGetInferredShape(int index, TensorShape& shape) const {
   return false;
 }
 
+ShapeSpecializationCache* ExecutionFrame::GetShapeSpecializationCache() const {
+  return session_state_.GetShapeSpecializationCache();
+}
+
 }  // namespace onnxruntime
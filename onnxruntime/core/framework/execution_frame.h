@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <vector>
 
@@ -21,6 +22,7 @@ namespace onnxruntime {
 
 class DataTransferManager;
 class SessionState;
+class ShapeSpecializationCache;
 class OrtValueNameIdxMap;
 struct MemoryPatternGroup;
 class NodeIndexInfo;
@@ -80,6 +82,9 @@ class IExecutionFrame {
   // If the retrieval is successful, this function returns true and false otherwise.
   virtual bool TryGetInferredShape(int index, TensorShape& shape) const;
 
+  // Returns the cache of the state kernels derive from their input shapes, or nullptr if it is not enabled.
+  virtual ShapeSpecializationCache* GetShapeSpecializationCache() const { return nullptr; }
+
   /**
    * write the output values to the 'fetches' vector
    * Don't access the values after SessionState is destroyed
@@ -144,7 +149,9 @@ class ExecutionFrame final : public IExecutionFrame {
 #ifdef ORT_ENABLE_STREAM
                  const DeviceStreamCollection* device_streams,
 #endif
-                 const SessionState& session_state);
+                 const SessionState& session_state,
+                 // the nodes the execution runs, nullptr for all of them. see SessionState::GetToBeExecutedRange
+                 const InlinedHashSet<NodeIndex>* node_to_execute = nullptr);
   ~ExecutionFrame() override;
 
   // TODO: These two AllocateMLValue... methods are in the API purely for unit test usage.
@@ -164,10 +171,23 @@ class ExecutionFrame final : public IExecutionFrame {
     return planner_.has_value();
   }
 
+  // Bytes of the memory pattern for the input shapes of this execution, either used by it or generated from it.
+  // 0 if memory patterns are disabled.
+  size_t GetPlannedPeakBytes() const { return planned_peak_bytes_; }
+
+  // Peak bytes of the tensors allocated by this execution so far: the memory pattern buffers plus the peak of the
+  // tensors allocated individually, including the graph outputs. The tensors allocated individually are only
+  // accounted when the session records its peak memory usage or profiling is enabled.
+  size_t GetPeakBytes() const {
+    return static_bytes_ + peak_dynamic_bytes_.load(std::memory_order_relaxed);
+  }
+
   // This function try retrieve the inferred shapes for the given NodeArg index.
   // If the retrival is sucessful, this function returns true and false otherwise.
   bool TryGetInferredShape(int index, TensorShape& shape) const override;
 
+  ShapeSpecializationCache* GetShapeSpecializationCache() const override;
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Return the size of virtual memory allocated in runtime.
   // The memory is usually used for activations in forward and backward passes.
@@ -213,6 +233,10 @@ class ExecutionFrame final : public IExecutionFrame {
   void TraceAllocate(int ort_value_idx, size_t size);
   void TraceFree(int ort_value_idx);
 
+  // per execution memory accounting of the tensors that are not allocated on the memory pattern buffers
+  void AccountAllocation(int ort_value_idx, size_t size);
+  void AccountFree(int ort_value_idx);
+
   const AllocPlanPerValue& GetAllocationPlan(int ort_value_idx);
 
   Stream* GetValueStream(int ort_value_idx) const;
@@ -245,6 +269,19 @@ class ExecutionFrame final : public IExecutionFrame {
   // It is never updated after creation
   const InlinedHashMap<int, TensorShape>* inferred_shapes_{nullptr};
 
+  // Sizes of the memory pattern buffers, planned and actually allocated.
+  size_t planned_peak_bytes_{0};
+  size_t static_bytes_{0};
+
+  // Whether the tensors allocated individually are accounted, which costs atomic updates per allocation.
+  const bool account_memory_;
+
+  // Bytes of the tensors allocated individually. The values may be allocated and freed concurrently by the
+  // streams of the execution, each value by a single stream at a time. Empty unless account_memory_.
+  InlinedVector<size_t> dynamic_bytes_per_value_;
+  std::atomic<size_t> dynamic_bytes_{0};
+  std::atomic<size_t> peak_dynamic_bytes_{0};
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Size of virtual memory allocated before any kernel execution.
   // This field is not physical memory size.
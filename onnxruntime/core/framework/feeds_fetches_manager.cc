@@ -5,6 +5,7 @@
 
 #include "core/framework/execution_providers.h"
 #include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/session_state.h"
 #include "core/framework/utils.h"
 
 namespace onnxruntime {
@@ -82,4 +83,19 @@ void FeedsFetchesManager::SetDeviceCopyChecks(DeviceCopyCheck input_copy_needed,
           ? DeviceCopyCheck::NoCopy
           : DeviceCopyCheck::Copy;
 }
+
+void FeedsFetchesManager::ResetDeviceCopyChecks() {
+  device_copy_checks_ = {};
+  for (auto& copy_info : fetches_device_copy_info_) {
+    copy_info.target_device = OrtDevice();
+  }
+}
+
+const InlinedHashSet<NodeIndex>* FeedsFetchesManager::GetNodesToExecute(const SessionState& session_state) const {
+  std::call_once(nodes_to_execute_flag_, [this, &session_state]() {
+    nodes_to_execute_ = session_state.GetToBeExecutedRange(feeds_fetches_info_.fetches_mlvalue_idxs);
+  });
+  return nodes_to_execute_;
+}
+
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <string>
 #include <vector>
 #include <optional>
@@ -10,6 +11,7 @@
 
 #ifndef SHARED_PROVIDER
 #include "core/framework/ort_value.h"
+#include "core/graph/basic_types.h"
 #endif
 
 namespace onnxruntime {
@@ -98,6 +100,15 @@ class FeedsFetchesManager {
   const DeviceCopyChecks& GetDeviceCopyChecks() const { return device_copy_checks_; }
   void SetDeviceCopyChecks(DeviceCopyCheck input_copy_needed, DeviceCopyCheck output_copy_needed);
 
+  // Return the copy checks and fetch target devices to the state of a new instance so they are recomputed from
+  // the feeds and fetches of the next execution. Used when an instance is reused across runs.
+  void ResetDeviceCopyChecks();
+
+  // Returns the nodes needed to produce the fetches, or nullptr if all the nodes are needed.
+  // See SessionState::GetToBeExecutedRange. Looked up on the first call only, so the executions reusing an instance
+  // don't look it up again.
+  const InlinedHashSet<NodeIndex>* GetNodesToExecute(const SessionState& session_state) const;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FeedsFetchesManager);
 
@@ -107,5 +118,8 @@ class FeedsFetchesManager {
 
   std::vector<MLValueCopyInfo> feeds_device_copy_info_;
   std::vector<MLValueCopyInfo> fetches_device_copy_info_;
+
+  mutable std::once_flag nodes_to_execute_flag_;
+  mutable const InlinedHashSet<NodeIndex>* nodes_to_execute_ = nullptr;
 };
 }  // namespace onnxruntime
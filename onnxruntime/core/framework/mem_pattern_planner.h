@@ -29,10 +29,9 @@ namespace onnxruntime {
 // Thread-safe.
 class MemPatternPlanner {
  public:
-  // only the Training code currently uses the program counter based logic
+  // the program counter based logic is used by the memory patterns planned statically
   MemPatternPlanner(bool using_counters) : using_counters_{using_counters} {}
 
-#ifdef ENABLE_TRAINING
   // TODO: OverlappingTimeSchedules should be private
   // Returns true if there is an intersection between two time schedules.
   // ProgramCounter values are validated when the execution plan is created
@@ -128,7 +127,6 @@ class MemPatternPlanner {
 
     blocks_.insert(best_fit_it, (static_cast<int>(allocs_.size()) - 1));
   }
-#endif
 
   void TraceAllocation(int ml_value_idx, size_t size) {
     ORT_ENFORCE(!using_counters_);
@@ -203,7 +201,6 @@ class MemPatternPlanner {
   MemoryPattern GenerateMemPattern() const {
     std::lock_guard<OrtMutex> lock(lock_);
 
-#ifdef ENABLE_TRAINING
     if (using_counters_) {
       // Time schedules of overlapping memory blocks SHOULD NOT intersect.
       for (size_t index_1 = 0; index_1 < allocs_.size(); index_1 += 1) {
@@ -231,7 +228,6 @@ class MemPatternPlanner {
         }
       }
     }
-#endif
 
     MemoryPattern pattern;
     pattern.peak_size_ = buffer_size_;
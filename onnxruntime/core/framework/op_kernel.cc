@@ -4,6 +4,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shape_specialization_cache.h"
 #include "core/graph/op.h"
 #include "core/common/logging/logging.h"
 using namespace ::onnxruntime::common;
@@ -69,6 +70,43 @@ bool OpKernelContext::TryGetInferredOutputShape(int index, TensorShape& shape) c
   return execution_frame_->TryGetInferredShape(GetOutputArgIndex(index), shape);
 }
 
+Status OpKernelContext::GetShapeSpecializedStateImpl(
+    Status (*create_fn)(const void* context, std::shared_ptr<const void>& state), const void* create_fn_context,
+    const void*& state) {
+  state = nullptr;
+  ShapeSpecializationCache* cache =
+      execution_frame_ != nullptr ? execution_frame_->GetShapeSpecializationCache() : nullptr;
+  if (cache == nullptr) {
+    return Status::OK();
+  }
+
+  // the rank then the dims of each input. -1 for a missing or non-tensor input.
+  // built on the stack as it runs on every call of the kernel. longer signatures aren't cached.
+  std::array<int64_t, ShapeSpecializationCache::kMaxSignatureLength> signature;
+  size_t length = 0;
+  for (int i = 0, end = InputCount(); i < end; ++i) {
+    const OrtValue* input = GetInputMLValue(i);
+    if (input == nullptr || !input->IsAllocated() || !input->IsTensor()) {
+      if (length == signature.size()) {
+        return Status::OK();
+      }
+      signature[length++] = -1;
+      continue;
+    }
+
+    const auto dims = input->Get<Tensor>().Shape().GetDims();
+    if (signature.size() - length < dims.size() + 1) {
+      return Status::OK();
+    }
+    signature[length++] = static_cast<int64_t>(dims.size());
+    std::copy(dims.begin(), dims.end(), signature.begin() + length);
+    length += dims.size();
+  }
+
+  return cache->GetOrCreateState(GetNodeIndex(), gsl::make_span(signature.data(), length),
+                                 ShapeSpecializationCache::StateFactory{create_fn, create_fn_context}, state);
+}
+
 OrtValue* OpKernelContext::OutputMLValue(int index, const TensorShape& shape) {
   if (index < 0 || index >= OutputCount())
     return nullptr;
@@ -14,7 +14,6 @@ OrtValuePatternPlanner::OrtValuePatternPlanner(const ExecutionPlanBase& executio
   }
 }
 
-#ifdef ENABLE_TRAINING
 common::Status OrtValuePatternPlanner::TraceAllocation(int ort_value_idx,
                                                        const AllocPlanPerValue::ProgramCounter& counter,
                                                        size_t size) {
@@ -28,7 +27,6 @@ common::Status OrtValuePatternPlanner::TraceAllocation(int ort_value_idx,
   it->second.TraceAllocation(ort_value_idx, counter, size);
   return common::Status::OK();
 }
-#endif
 
 common::Status OrtValuePatternPlanner::TraceAllocation(int ort_value_idx, size_t size) {
   const auto& location = execution_planner_.GetLocation(ort_value_idx);
@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/sampled_profiler.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+size_t GetBucketIndex(int64_t duration_us) {
+  size_t index = 0;
+  while (index < SampledProfiler::kNumBuckets - 1 && (int64_t{1} << index) < duration_us) {
+    ++index;
+  }
+  return index;
+}
+
+// Escapes a label value of the Prometheus text format.
+std::string EscapeLabelValue(const std::string& value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+}  // namespace
+
+SampledProfiler::SampledProfiler(const GraphViewer& graph_viewer, uint32_t sampling_interval)
+    : sampling_interval_(sampling_interval),
+      node_names_(graph_viewer.MaxNodeIndex()),
+      op_types_(graph_viewer.MaxNodeIndex()),
+      node_counters_(std::make_unique<NodeCounters[]>(graph_viewer.MaxNodeIndex())) {
+  ORT_ENFORCE(sampling_interval_ > 0, "The sampling interval must be positive");
+  for (const auto& node : graph_viewer.Nodes()) {
+    node_names_[node.Index()] = node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name();
+    op_types_[node.Index()] = node.OpType();
+  }
+}
+
+void SampledProfiler::RecordNode(NodeIndex node_index, int64_t duration_us) {
+  if (node_index >= node_names_.size()) {
+    return;
+  }
+  auto& counters = node_counters_[node_index];
+  counters.bucket_counts[GetBucketIndex(duration_us)].fetch_add(1, std::memory_order_relaxed);
+  counters.sum_us.fetch_add(static_cast<uint64_t>(std::max<int64_t>(duration_us, 0)), std::memory_order_relaxed);
+}
+
+std::vector<SampledProfiler::NodeHistogram> SampledProfiler::Snapshot() const {
+  std::vector<NodeHistogram> snapshot;
+  for (size_t i = 0; i < node_names_.size(); ++i) {
+    const auto& counters = node_counters_[i];
+    NodeHistogram histogram;
+    for (size_t b = 0; b < kNumBuckets; ++b) {
+      histogram.bucket_counts[b] = counters.bucket_counts[b].load(std::memory_order_relaxed);
+      histogram.count += histogram.bucket_counts[b];
+    }
+    if (histogram.count == 0) {
+      continue;
+    }
+    histogram.sum_us = counters.sum_us.load(std::memory_order_relaxed);
+    histogram.node_name = node_names_[i];
+    histogram.op_type = op_types_[i];
+    snapshot.push_back(std::move(histogram));
+  }
+  return snapshot;
+}
+
+std::string SampledProfiler::ToPrometheusText(const std::vector<NodeHistogram>& snapshot) {
+  constexpr const char* kName = "onnxruntime_node_latency_microseconds";
+  std::ostringstream ss;
+  ss << "# HELP " << kName << " Latency of the nodes in the sampled runs of the session.\n";
+  ss << "# TYPE " << kName << " histogram\n";
+  for (const auto& histogram : snapshot) {
+    const auto labels = MakeString("node=\"", EscapeLabelValue(histogram.node_name),
+                                   "\",op_type=\"", EscapeLabelValue(histogram.op_type), "\"");
+    uint64_t cumulative_count = 0;
+    for (size_t b = 0; b < kNumBuckets; ++b) {
+      cumulative_count += histogram.bucket_counts[b];
+      ss << kName << "_bucket{" << labels << ",le=\"";
+      if (b == kNumBuckets - 1) {
+        ss << "+Inf";
+      } else {
+        ss << (uint64_t{1} << b);
+      }
+      ss << "\"} " << cumulative_count << "\n";
+    }
+    ss << kName << "_sum{" << labels << "} " << histogram.sum_us << "\n";
+    ss << kName << "_count{" << labels << "} " << histogram.count << "\n";
+  }
+  return ss.str();
+}
+
+}  // namespace onnxruntime
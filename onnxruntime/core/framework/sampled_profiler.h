@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+class GraphViewer;
+
+/**
+ * Aggregates the latency of each node of a graph over a sample of the executions of the graph.
+ *
+ * Unlike profiling::Profiler, which records an event per node and run and writes them all out at the end, this only
+ * times 1 in N executions, and only increments a fixed set of per-node histogram counters with relaxed atomics.
+ * It is cheap enough to leave enabled in production. Enabled with kOrtSessionOptionsConfigSampledProfilingInterval.
+ */
+class SampledProfiler {
+ public:
+  // The upper bounds of the histogram buckets are 1, 2, 4, ..., 2^(kNumBuckets - 2) microseconds and +Inf.
+  static constexpr size_t kNumBuckets = 24;
+
+  struct NodeHistogram {
+    std::string node_name;
+    std::string op_type;
+    std::array<uint64_t, kNumBuckets> bucket_counts{};  // not cumulative
+    uint64_t count = 0;
+    uint64_t sum_us = 0;
+  };
+
+  SampledProfiler(const GraphViewer& graph_viewer, uint32_t sampling_interval);
+
+  // Returns true if the current execution of the graph is sampled. Called once per execution.
+  bool SampleExecution() {
+    return next_execution_.fetch_add(1, std::memory_order_relaxed) % sampling_interval_ == 0;
+  }
+
+  // Called for each node of a sampled execution.
+  void RecordNode(NodeIndex node_index, int64_t duration_us);
+
+  // Returns the histograms of the nodes recorded at least once. Concurrent executions may be partially included.
+  std::vector<NodeHistogram> Snapshot() const;
+
+  // Formats a snapshot in the Prometheus text exposition format, as the histogram
+  // onnxruntime_node_latency_microseconds with node and op_type labels.
+  static std::string ToPrometheusText(const std::vector<NodeHistogram>& snapshot);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SampledProfiler);
+
+  struct NodeCounters {
+    std::array<std::atomic<uint64_t>, kNumBuckets> bucket_counts{};
+    std::atomic<uint64_t> sum_us{0};
+  };
+
+  const uint32_t sampling_interval_;
+  std::atomic<uint64_t> next_execution_{0};
+  std::vector<std::string> node_names_;
+  std::vector<std::string> op_types_;
+  std::unique_ptr<NodeCounters[]> node_counters_;
+};
+}  // namespace onnxruntime
@@ -165,8 +165,11 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
 
   size_t num_barriers{0};
 
+  // A stable order of the nodes of all streams, in which the program counters of the values are computed.
+  // Only set if the memory patterns are planned statically.
+  InlinedVector<NodeIndex> stable_execution_order;
+
 #ifdef ENABLE_TRAINING
-  InlinedVector<NodeIndex> node_execution_order_in_training;
   InlinedHashMap<NodeIndex, size_t> node_index_2_toposort_index;
 #endif
 
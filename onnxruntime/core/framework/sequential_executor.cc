@@ -14,6 +14,7 @@
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/sampled_profiler.h"
 #include "core/framework/utils.h"
 
 #if defined DEBUG_NODE_INPUTS_OUTPUTS
@@ -155,11 +156,8 @@ class SessionScope {
  public:
   friend class KernelScope;
   SessionScope(const SessionState& session_state, const ExecutionFrame& frame)
-      : session_state_(session_state)
-#if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
-        ,
+      : session_state_(session_state),
         frame_(frame)
-#endif
 #ifdef CONCURRENCY_VISUALIZER
         ,
         series_(ComposeSeriesName(session_state.GetGraphViewer()))
@@ -180,6 +178,12 @@ class SessionScope {
       session_start_ = session_state.Profiler().Start();
     }
 
+    // nodes are only timed for the sampled executions
+    sampled_profiler_ = session_state_.GetSampledProfiler();
+    if (sampled_profiler_ && !sampled_profiler_->SampleExecution()) {
+      sampled_profiler_ = nullptr;
+    }
+
     auto& logger = session_state_.Logger();
     LOGS(logger, VERBOSE) << "Begin execution";
     const SequentialExecutionPlan& seq_exec_plan = *session_state_.GetExecutionPlan();
@@ -189,9 +193,6 @@ class SessionScope {
 // Enable TRACE_EXECUTION compile flag to dump execution plan
 #if defined(TRACE_EXECUTION)
     std::cout << std::make_pair(&seq_exec_plan, &session_state) << std::endl;
-#endif
-#if defined(ORT_MINIMAL_BUILD) || !defined(ORT_MEMORY_PROFILE)
-    ORT_UNUSED_PARAMETER(frame);
 #endif
   }
 
@@ -225,7 +226,10 @@ class SessionScope {
 #endif
 
     if (session_state_.Profiler().IsEnabled()) {
-      session_state_.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", session_start_);
+      session_state_.Profiler().EndTimeAndRecordEvent(
+          profiling::SESSION_EVENT, "SequentialExecutor::Execute", session_start_,
+          {{"planned_peak_bytes", std::to_string(frame_.GetPlannedPeakBytes())},
+           {"peak_bytes", std::to_string(frame_.GetPeakBytes())}});
     }
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
     auto& logger = session_state_.Logger();
@@ -250,8 +254,9 @@ class SessionScope {
  private:
   const SessionState& session_state_;
   TimePoint session_start_;
-#if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
+  SampledProfiler* sampled_profiler_ = nullptr;
   const ExecutionFrame& frame_;
+#if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Whether memory profiler need create events and flush to file.
   // For partial graph run, when the last subgraph of the whole graph is executing, we need flush to file.
   bool flush_memory_info_ = true;
@@ -350,11 +355,21 @@ class KernelScope {
                                input_activation_sizes_, input_parameter_sizes_,
                                node_name_, input_type_shape_);
     }
+
+    if (session_scope_.sampled_profiler_) {
+      sampled_begin_time_ = std::chrono::steady_clock::now();
+    }
   }
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelScope);
 
   ~KernelScope() {
+    if (session_scope_.sampled_profiler_) {
+      const auto duration = std::chrono::steady_clock::now() - sampled_begin_time_;
+      session_scope_.sampled_profiler_->RecordNode(
+          kernel_.Node().Index(), std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    }
+
 #ifdef ENABLE_NVTX_PROFILE
     node_compute_range_.End();
 #endif
@@ -407,6 +422,7 @@ class KernelScope {
 
  private:
   TimePoint kernel_begin_time_;
+  std::chrono::steady_clock::time_point sampled_begin_time_;
   SessionScope& session_scope_;
   const SessionState& session_state_;
   std::string node_name_;
@@ -528,7 +544,7 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                                    const DeviceStreamCollection* device_streams,
 #endif
                                    const bool& terminate_flag,
-                                   const bool only_execute_path_to_fetches,
+                                   const InlinedHashSet<NodeIndex>* node_to_execute,
                                    bool single_thread_mode) {
   auto* execution_plan = session_state.GetExecutionPlan();
   LOGS(logger, VERBOSE) << "Number of streams: " << execution_plan->execution_plan.size();
@@ -551,7 +567,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                              fetches,
                              fetch_allocators,
                              logger,
-                             single_thread_mode);
+                             single_thread_mode,
+                             node_to_execute);
 #else
   StreamExecutionContext ctx(session_state,
                              valid_streams,
@@ -561,21 +578,17 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                              fetches,
                              fetch_allocators,
                              logger,
-                             single_thread_mode);
-#endif
-#ifdef ENABLE_TRAINING
-  if (only_execute_path_to_fetches) {
-    auto* node_to_execute = session_state.GetToBeExecutedRange(fetch_mlvalue_idxs);
-    ctx.SetNodeToExecute(node_to_execute);
-  }
-#else
-  ORT_UNUSED_PARAMETER(only_execute_path_to_fetches);
+                             single_thread_mode,
+                             node_to_execute);
 #endif
 
   SessionScope session_scope(session_state, ctx.GetExecutionFrame());
 
   auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
 
+  // loops in the scheduled streams are limited like those of the calling thread
+  const int loop_thread_limit = concurrency::ThreadPool::ScopedLoopThreadLimit::Current();
+
   for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
     if (execution_plan->execution_plan[i]->steps_.empty()) {
       // execution context is initialized with number of valid streams
@@ -583,7 +596,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
       // so don't need to invoke CompleteTask here
       // ctx.CompleteTask();
     } else {
-      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
+      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope, loop_thread_limit]() {
+        concurrency::ThreadPool::ScopedLoopThreadLimit scoped_loop_thread_limit(loop_thread_limit);
         RunSince(i, ctx, session_scope, terminate_flag, 0);
       });
     }
@@ -592,19 +606,25 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
   ctx.WaitAll();
   ORT_RETURN_IF_ERROR(ctx.TaskStatus());
   ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GetOutputs(fetches));
-  if (ctx.GetExecutionFrame().HasMemoryPatternPlanner()) {
-    bool all_tensors = true;
-    for (const auto& feed : feeds) {
-      if (!(feed.IsTensor())) {
-        all_tensors = false;
-        break;
-      }
+  bool all_tensors = true;
+  for (const auto& feed : feeds) {
+    if (!(feed.IsTensor())) {
+      all_tensors = false;
+      break;
     }
+  }
 
-    if (all_tensors) {
+  if (all_tensors) {
+    if (ctx.GetExecutionFrame().HasMemoryPatternPlanner()) {
       MemoryPatternGroup mem_patterns;
       ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GeneratePatterns(mem_patterns));
-      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
+      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, node_to_execute,
+                                                                      std::move(mem_patterns)));
+    }
+
+    if (node_to_execute == nullptr && session_state.GetRecordMemoryUsage()) {
+      session_state.RecordMemoryUsage(feed_mlvalue_idxs, feeds, ctx.GetExecutionFrame().GetPlannedPeakBytes(),
+                                      ctx.GetExecutionFrame().GetPeakBytes());
     }
   }
 
@@ -643,9 +663,12 @@ onnxruntime::Status PartialExecuteThePlan(const SessionState& session_state, gsl
 
   auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
 
+  const int loop_thread_limit = concurrency::ThreadPool::ScopedLoopThreadLimit::Current();
+
   for (size_t i = 0; i < plan->execution_plan.size(); ++i) {
     if (!plan->execution_plan[i]->steps_.empty()) {
-      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
+      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope, loop_thread_limit]() {
+        concurrency::ThreadPool::ScopedLoopThreadLimit scoped_loop_thread_limit(loop_thread_limit);
         auto* range = ctx.GetCurrentRange();
         size_t start = !range ? 0 : range->stream_pc_range[i].first;
         RunSince(i, ctx, session_scope, terminate_flag, start);
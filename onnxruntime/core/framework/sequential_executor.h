@@ -45,7 +45,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                                    const DeviceStreamCollection* device_streams,
 #endif
                                    const bool& terminate_flag,
-                                   const bool only_execute_path_to_fetches,
+                                   // the nodes to execute, nullptr for all of them
+                                   const InlinedHashSet<NodeIndex>* node_to_execute,
                                    bool single_thread_mode);
 
 #ifdef ENABLE_TRAINING
@@ -3,10 +3,15 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
+#include <numeric>
 #include <sstream>
+#include <tuple>
 
 #include "core/platform/ort_mutex.h"
+#include "core/common/hash_combine.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
@@ -87,6 +92,23 @@ SessionState::SessionState(Graph& graph,
 {
   enable_mem_pattern_ = sess_options_.enable_mem_pattern &&
                         sess_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL;
+  // the memory usage of subgraphs, executed for each iteration of a loop, is not queried
+  record_memory_usage_ = !graph_.IsSubgraph() &&
+                         sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigRecordPeakMemoryUsage,
+                                                                         "0") == "1";
+  // the fetches of a subgraph are all its outputs
+  prune_to_fetches_ = !graph_.IsSubgraph() &&
+                      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPruneToFetches,
+                                                                      "0") == "1";
+
+#ifdef ENABLE_TRAINING
+  constexpr const char* static_memory_planning_default = "1";
+#else
+  constexpr const char* static_memory_planning_default = "0";
+#endif
+  static_memory_planning_ = enable_mem_pattern_ &&
+                            sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigStaticMemoryPlanning,
+                                                                            static_memory_planning_default) == "1";
   if (parent_allocators) {
     allocators_ = parent_allocators;
   } else {
@@ -213,7 +235,32 @@ const KernelCreateInfo& SessionState::GetNodeKernelCreateInfo(NodeIndex node_ind
   return *entry->second;
 }
 
-Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_manager) {
+// Runs fn(i) for i in [0, n) on the thread pool, and returns the error of the lowest i that failed, if any,
+// so that the result does not depend on the scheduling.
+template <typename Fn>
+static Status TryParallelForWithStatus(concurrency::ThreadPool* thread_pool, size_t n, const Fn& fn) {
+  std::vector<Status> statuses(n);
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(n),
+      [&fn, &statuses](std::ptrdiff_t i) {
+        ORT_TRY {
+          statuses[i] = fn(static_cast<size_t>(i));
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+          });
+        }
+      });
+
+  for (auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
+Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_manager,
+                                   concurrency::ThreadPool* thread_pool) {
   const auto& nodes = graph_viewer_->Nodes();
   if (!nodes.empty()) {
     size_t max_nodeid = 0;
@@ -222,7 +269,8 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1);
-    for (const auto& node : nodes) {
+
+    auto create_kernel = [this, &kernel_registry_manager](const Node& node) -> Status {
       // construct and save the kernels
       const KernelCreateInfo& kci = GetNodeKernelCreateInfo(node.Index());
 
@@ -231,8 +279,23 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
       const IExecutionProvider& exec_provider = *execution_providers_.Get(exec_provider_name);
 
       // assumes vector is already resize()'ed to the number of nodes in the graph
-      ORT_RETURN_IF_ERROR(kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]));
+      return kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]);
+    };
+
+    // other execution providers may not support creating kernels concurrently, so only those of the CPU EP are
+    InlinedVector<const Node*> parallel_nodes;
+    for (const auto& node : nodes) {
+      if (thread_pool != nullptr && node.GetExecutionProviderType() == kCpuExecutionProvider) {
+        parallel_nodes.push_back(&node);
+      } else {
+        ORT_RETURN_IF_ERROR(create_kernel(node));
+      }
     }
+
+    ORT_RETURN_IF_ERROR(TryParallelForWithStatus(thread_pool, parallel_nodes.size(),
+                                                 [&create_kernel, &parallel_nodes](size_t i) {
+                                                   return create_kernel(*parallel_nodes[i]);
+                                                 }));
   }
   node_index_info_.emplace(*graph_viewer_, ort_value_name_idx_map_);
   return Status::OK();
@@ -394,120 +457,172 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
   return ss_1.str();
 }
 
+using PackedInputs = InlinedVector<std::tuple<SessionState*, int, std::string>>;
+
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
-                                                       const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
-                                        bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
-    for (auto& node : GetGraphViewer().Nodes()) {
-      auto kernel = GetMutableKernel(node.Index());
-      int input_idx = 0;
-      for (auto& input_def : node.InputDefs()) {
-        if (input_def->Exists()) {
-          const std::string& input_name = input_def->Name();
-          SessionState* st = this;
-          // subgraph can use the value from outer scope,
-          // so it needs to check if current node uses constant initialized tensor from current and outer graphs
-          do {
-            int ort_value_idx;
-            if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
-              std::unordered_map<int, OrtValue>& constant_initialized_tensors = st->constant_initialized_tensors_;
-
-              if (constant_initialized_tensors.count(ort_value_idx)) {
-                bool is_packed = false;
-                const Tensor& const_initialized_tensor = constant_initialized_tensors[ort_value_idx].Get<Tensor>();
-
-                auto iter = initializers_to_share_map.find(input_name);
-                bool is_shared_initializer = (iter != initializers_to_share_map.end());
-
-                // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
-                if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
-                    node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
-
-                  AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
-                  ORT_ENFORCE(allocator_for_caching.get() != nullptr);
-
-                  PrePackedWeights weights_to_be_filled_in;
-                  // The reason we invoke PrePack() before looking into the container for any pre-packed weight
-                  // cached by another instance of the same op_type (for the same constant initializer) is because
-                  // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
-                  // weight with the pre-packed weight generated by this instance of the same op_type because other static
-                  // properties of the node like node attributes could play a role in the pre-packed weights' contents.
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
-                                                      is_packed,
-                                                      &weights_to_be_filled_in));
-
-                  if (is_packed) {
-                    // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
-                    ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
-                                " doesn't have an implementation that can cache computed pre-packed weights");
-
-                    const auto& op_type = node.OpType();
-
-                    // Sanity check
-                    // TODO: Check if some version of the ONNX IR allows op_type to be empty
-                    ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
-
-                    // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
-                    // that we just got by invoking PrePack() on this kernel.
-
-                    const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
-                                                                                                           weights_to_be_filled_in);
-
-                    bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
-
-                    if (container_contains_packed_weight) {
-                      LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: " << input_name
-                                          << " used in the node: " << node.Name() << " which is of op type: " << node.OpType();
-
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
-
-                      ++used_shared_pre_packed_weights_counter_;
-                    } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
-
-                      if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
-                        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
-                      }
-
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
-                    }
-                  }
+                                                       const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map,
+                                                       concurrency::ThreadPool* thread_pool) {
+  // pre-packs the constant initialized inputs of the kernel of a node and appends those packed to packed_inputs.
+  // only reads the initialized tensors of this and the outer session states, so that nodes can be packed concurrently.
+  auto prepack_node = [this, &initializers_to_share_map](
+                          const Node& node, bool should_cache_prepacked_weights_for_shared_initializers,
+                          PackedInputs& packed_inputs) -> Status {
+    auto kernel = GetMutableKernel(node.Index());
+    int input_idx = 0;
+    for (auto& input_def : node.InputDefs()) {
+      if (input_def->Exists()) {
+        const std::string& input_name = input_def->Name();
+        SessionState* st = this;
+        // subgraph can use the value from outer scope,
+        // so it needs to check if current node uses constant initialized tensor from current and outer graphs
+        do {
+          int ort_value_idx;
+          if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
+            const std::unordered_map<int, OrtValue>& constant_initialized_tensors = st->constant_initialized_tensors_;
+
+            auto constant_initialized_tensor = constant_initialized_tensors.find(ort_value_idx);
+            if (constant_initialized_tensor != constant_initialized_tensors.end()) {
+              bool is_packed = false;
+              const Tensor& const_initialized_tensor = constant_initialized_tensor->second.Get<Tensor>();
+
+              auto iter = initializers_to_share_map.find(input_name);
+              bool is_shared_initializer = (iter != initializers_to_share_map.end());
+
+              // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
+              if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
+                  node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
+
+                AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
+                ORT_ENFORCE(allocator_for_caching.get() != nullptr);
+
+                PrePackedWeights weights_to_be_filled_in;
+                // The reason we invoke PrePack() before looking into the container for any pre-packed weight
+                // cached by another instance of the same op_type (for the same constant initializer) is because
+                // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
+                // weight with the pre-packed weight generated by this instance of the same op_type because other static
+                // properties of the node like node attributes could play a role in the pre-packed weights' contents.
+                ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
+                                                    is_packed,
+                                                    &weights_to_be_filled_in));
 
-                } else {  // caching of pre-packed weights' turned OFF
-                  AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
-                                                      session_cpu_alloc,  // use allocator tied to this session
-                                                      is_packed,
-                                                      nullptr  // no caching required
-                                                      ));
-                }
                 if (is_packed) {
-                  ++number_of_prepacks_counter_;
+                  // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
+                  ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
+                              " doesn't have an implementation that can cache computed pre-packed weights");
+
+                  const auto& op_type = node.OpType();
 
-                  if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
-                    // release the constant initialized tensor
-                    st->initialized_tensors_.erase(ort_value_idx);
-                    constant_initialized_tensors.erase(ort_value_idx);
+                  // Sanity check
+                  // TODO: Check if some version of the ONNX IR allows op_type to be empty
+                  ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
+
+                  // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
+                  // that we just got by invoking PrePack() on this kernel.
+
+                  const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
+                                                                                                         weights_to_be_filled_in);
+
+                  bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
+
+                  if (container_contains_packed_weight) {
+                    LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: " << input_name
+                                        << " used in the node: " << node.Name() << " which is of op type: " << node.OpType();
+
+                    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
+                                                                        prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                        node.Name()));
+
+                    ++used_shared_pre_packed_weights_counter_;
+                  } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
+
+                    if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
+                      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
+                    }
+
+                    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
+                                                                        prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                        node.Name()));
                   }
                 }
+
+              } else {  // caching of pre-packed weights' turned OFF
+                AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+                ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
+                                                    session_cpu_alloc,  // use allocator tied to this session
+                                                    is_packed,
+                                                    nullptr  // no caching required
+                                                    ));
               }
-              // stop searching in 2 cases:
-              // 1. value is not from OuterScope
-              // 2. value is from OuterScope and the current OuterScope has the value
-              if (st != this || !st->graph_.IsOuterScopeValue(input_name)) {
-                break;
+              if (is_packed) {
+                packed_inputs.emplace_back(st, ort_value_idx, input_name);
               }
             }
-            st = st->Parent();
-          } while (st);
-        }
-        input_idx++;
+            // stop searching in 2 cases:
+            // 1. value is not from OuterScope
+            // 2. value is from OuterScope and the current OuterScope has the value
+            if (st != this || !st->graph_.IsOuterScopeValue(input_name)) {
+              break;
+            }
+          }
+          st = st->Parent();
+        } while (st);
+      }
+      input_idx++;
+    }
+
+    return Status::OK();
+  };
+
+  // counts the packed inputs and releases the constant initialized tensors once all their uses are packed
+  auto release_packed_inputs = [this, &constant_initializers_use_count](const PackedInputs& packed_inputs) {
+    for (const auto& [st, ort_value_idx, input_name] : packed_inputs) {
+      ++number_of_prepacks_counter_;
+
+      if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
+        // release the constant initialized tensor
+        st->initialized_tensors_.erase(ort_value_idx);
+        st->constant_initialized_tensors_.erase(ort_value_idx);
+      }
+    }
+  };
+
+  auto prepacked_constant_weights = [&](bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
+    if (thread_pool == nullptr || should_cache_prepacked_weights_for_shared_initializers) {
+      PackedInputs packed_inputs;
+      for (auto& node : GetGraphViewer().Nodes()) {
+        packed_inputs.clear();
+        ORT_RETURN_IF_ERROR(prepack_node(node, should_cache_prepacked_weights_for_shared_initializers, packed_inputs));
+        release_packed_inputs(packed_inputs);
+      }
+      return Status::OK();
+    }
+
+    // the kernels of the CPU EP pre-pack concurrently, the others serially. the initialized tensors are
+    // released afterwards in node order, which leaves the same ones as packing all nodes serially would.
+    InlinedVector<const Node*> nodes;
+    for (auto& node : GetGraphViewer().Nodes()) {
+      nodes.push_back(&node);
+    }
+    std::vector<PackedInputs> packed_inputs(nodes.size());
+    InlinedVector<size_t> parallel_nodes;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      if (nodes[i]->GetExecutionProviderType() == kCpuExecutionProvider) {
+        parallel_nodes.push_back(i);
+      } else {
+        ORT_RETURN_IF_ERROR(prepack_node(*nodes[i], false, packed_inputs[i]));
       }
     }
 
+    ORT_RETURN_IF_ERROR(TryParallelForWithStatus(thread_pool, parallel_nodes.size(),
+                                                 [&](size_t i) {
+                                                   const size_t node_idx = parallel_nodes[i];
+                                                   return prepack_node(*nodes[node_idx], false,
+                                                                       packed_inputs[node_idx]);
+                                                 }));
+
+    for (const auto& node_packed_inputs : packed_inputs) {
+      release_packed_inputs(node_packed_inputs);
+    }
     return Status::OK();
   };
 
@@ -531,7 +646,26 @@ static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tenso
   return key;
 }
 
-#ifdef ENABLE_TRAINING
+// the exact shapes of the inputs, unlike CalculateMemoryPatternsKey, as the memory usage is queried by callers that
+// can't tell a collision from another shape signature
+template <typename GetShape>
+static InlinedVector<int64_t> CalculateMemoryUsageKey(gsl::span<const int> input_mlvalue_idxs,
+                                                      const GetShape& get_shape) {
+  InlinedVector<size_t> order(input_mlvalue_idxs.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::sort(order.begin(), order.end(),
+            [&input_mlvalue_idxs](size_t a, size_t b) { return input_mlvalue_idxs[a] < input_mlvalue_idxs[b]; });
+
+  InlinedVector<int64_t> key;
+  for (size_t i : order) {
+    const auto dims = get_shape(i).GetDims();
+    key.push_back(input_mlvalue_idxs[i]);
+    key.push_back(static_cast<int64_t>(dims.size()));
+    key.insert(key.end(), dims.begin(), dims.end());
+  }
+  return key;
+}
+
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
                         const InlinedHashMap<std::string, TensorShape>& feeds,
@@ -617,6 +751,7 @@ void TryCalculateSizeFromResolvedShape(int ml_value_idx, const InlinedHashMap<in
 // If this function fails NO memory planning will take place, hence lets ONLY FAIL and stop training where warranted, example SIZE overflow.
 Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                gsl::span<const int> feed_mlvalue_idxs,
+                                               bool allow_unresolved_shapes,
                                                MemoryPatternGroup& output,
                                                InlinedHashMap<int, TensorShape>& resolved_shapes) const {
   InlinedHashMap<std::string, TensorShape> feeds;
@@ -634,7 +769,7 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
   // Try to resolve shapes for activations.
   auto& node_index_info = GetNodeIndexInfo();
-  auto& execution_order = exe_plan->node_execution_order_in_training;
+  auto& execution_order = exe_plan->stable_execution_order;
   for (auto& node_idx : execution_order) {
     int node_index = node_index_info.GetNodeOffset(node_idx);
     auto* node = graph_viewer_->GetNode(node_idx);
@@ -723,6 +858,14 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
       size_t size = 0;
       TryCalculateSizeFromResolvedShape(ml_value_idx, resolved_shapes, size);
 
+      if (size == 0 && !allow_unresolved_shapes &&
+          exe_plan->allocation_plan[ml_value_idx].alloc_kind == AllocKind::kAllocate &&
+          ml_data_type != DataTypeImpl::GetType<std::string>()) {
+        std::string node_name;
+        ORT_RETURN_IF_ERROR(this->ort_value_name_idx_map_.GetName(ml_value_idx, node_name));
+        return Status(ONNXRUNTIME, FAIL, "Unknown shape found in memory pattern compute, node name is : " + node_name);
+      }
+
       // Plan memory if conditions are met.
       if (exe_plan->allocation_plan[ml_value_idx].alloc_kind == AllocKind::kAllocate &&
           ml_data_type != DataTypeImpl::GetType<std::string>() && size != 0) {
@@ -763,32 +906,52 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
   return Status::OK();
 }
 
-#endif
+int64_t SessionState::GetMemoryPatternsKey(gsl::span<const OrtValue> tensor_inputs,
+                                           const InlinedHashSet<NodeIndex>* node_to_execute) const {
+  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  // the values of an execution that skips nodes are released earlier than in a full execution, so its patterns may
+  // overlap values whose lifetimes overlap in a full execution. the node sets are cached for the lifetime of the
+  // session state, so their addresses identify them.
+  if (node_to_execute != nullptr) {
+    size_t hash = static_cast<size_t>(key);
+    HashCombine(node_to_execute, hash);
+    key = static_cast<int64_t>(hash);
+  }
+  return key;
+}
 
 // MemoryPatternGroup pointer is cached. It only inserted upon creation
 // and is not updated if already present.
 const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
+    const InlinedHashSet<NodeIndex>* node_to_execute,
     const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
   out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  int64_t key = GetMemoryPatternsKey(tensor_inputs, node_to_execute);
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
   auto it = mem_patterns_.find(key);
   if (it == mem_patterns_.end()) {
+    if (static_memory_planning_) {
 #ifdef ENABLE_TRAINING
-    MemoryPatternGroup mem_patterns;
-    InlinedHashMap<int, TensorShape> inferred_shapes;
-    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
-    }
+      // the values whose shapes cannot be resolved are allocated dynamically in each execution
+      constexpr bool allow_unresolved_shapes = true;
 #else
-    ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
+      // a pattern traced in the first execution covers all the values, so it is preferred to a partial plan
+      constexpr bool allow_unresolved_shapes = false;
 #endif
+      MemoryPatternGroup mem_patterns;
+      InlinedHashMap<int, TensorShape> inferred_shapes;
+      if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, allow_unresolved_shapes,
+                                    mem_patterns, inferred_shapes)
+              .IsOK()) {
+        auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
+        auto ptr = &patt_insert.first->second;
+        auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
+        out_inferred_shapes = &shape_insert.first->second;
+        return ptr;
+      }
+    }
     return nullptr;
   }
 
@@ -846,8 +1009,9 @@ void SessionState::ResolveMemoryPatternFlag() {
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
+                                                   const InlinedHashSet<NodeIndex>* node_to_execute,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  int64_t key = GetMemoryPatternsKey(tensor_inputs, node_to_execute);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
   // Do not update if present, as the pointer to the existing one is cached
@@ -855,6 +1019,45 @@ Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> ten
   return Status::OK();
 }
 
+void SessionState::RecordMemoryUsage(gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> tensor_inputs,
+                                     size_t planned_peak_bytes, size_t actual_peak_bytes) const {
+  // bounds the memory used by the sessions whose input shapes vary
+  constexpr size_t kMaxMemoryUsageShapes = 256;
+
+  auto key = CalculateMemoryUsageKey(feed_mlvalue_idxs,
+                                     [&tensor_inputs](size_t i) { return tensor_inputs[i].Get<Tensor>().Shape(); });
+
+  std::lock_guard<OrtMutex> lock(memory_usage_lock_);
+  auto it = memory_usage_.find(key);
+  if (it == memory_usage_.end()) {
+    if (memory_usage_.size() == kMaxMemoryUsageShapes) {
+      return;
+    }
+    it = memory_usage_.emplace(std::move(key), MemoryUsage{}).first;
+  }
+
+  auto& memory_usage = it->second;
+  // the executions that generate the memory pattern have none to use, so keep the planned size once known
+  if (planned_peak_bytes > 0) {
+    memory_usage.planned_peak_bytes = planned_peak_bytes;
+  }
+  memory_usage.actual_peak_bytes = std::max(memory_usage.actual_peak_bytes, actual_peak_bytes);
+}
+
+bool SessionState::GetMemoryUsage(gsl::span<const int> input_mlvalue_idxs, gsl::span<const TensorShape> input_shapes,
+                                  MemoryUsage& memory_usage) const {
+  const auto key = CalculateMemoryUsageKey(input_mlvalue_idxs,
+                                           [&input_shapes](size_t i) -> const TensorShape& { return input_shapes[i]; });
+
+  std::lock_guard<OrtMutex> lock(memory_usage_lock_);
+  auto it = memory_usage_.find(key);
+  if (it == memory_usage_.end()) {
+    return false;
+  }
+  memory_usage = it->second;
+  return true;
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 bool SessionState::GetEnableMemoryReuse() const { return sess_options_.enable_mem_reuse; }
@@ -984,47 +1187,41 @@ const NodeIndexInfo& SessionState::GetNodeIndexInfo() const {
   return *node_index_info_;
 }
 
-#ifdef ENABLE_TRAINING
-void SessionState::UpdateToBeExecutedRange(gsl::span<int const> fetch_mlvalue_idxs) {
-  InlinedVector<int> sorted_idxs;
-  sorted_idxs.reserve(fetch_mlvalue_idxs.size());
-  sorted_idxs.assign(fetch_mlvalue_idxs.begin(), fetch_mlvalue_idxs.end());
+const InlinedHashSet<NodeIndex>* SessionState::GetToBeExecutedRange(
+    gsl::span<int const> fetch_mlvalue_idxs) const {
+  InlinedVector<int> sorted_idxs(fetch_mlvalue_idxs.begin(), fetch_mlvalue_idxs.end());
   std::sort(sorted_idxs.begin(), sorted_idxs.end());
-  if (to_be_executed_nodes_.find(sorted_idxs) != to_be_executed_nodes_.end())
-    return;
 
-  // Get the nodes generating the fetches.
-  InlinedVector<const Node*> nodes;
-  nodes.reserve(fetch_mlvalue_idxs.size());
-  InlinedHashSet<NodeIndex> reachable_nodes;
-  reachable_nodes.reserve(graph_.NumberOfNodes());
+  std::lock_guard<OrtMutex> lock(to_be_executed_nodes_lock_);
+  auto it = to_be_executed_nodes_.find(sorted_idxs);
+  if (it != to_be_executed_nodes_.end()) {
+    return it->second.get();
+  }
 
-  for (auto idx : fetch_mlvalue_idxs) {
+  // Get the nodes generating the fetches. Fetches that are graph inputs or initializers have none.
+  InlinedVector<const Node*> nodes;
+  nodes.reserve(sorted_idxs.size());
+  for (auto idx : sorted_idxs) {
     std::string node_arg_name;
     const auto status = this->GetOrtValueNameIdxMap().GetName(idx, node_arg_name);
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
-    auto ending_node = graph_.GetProducerNode(node_arg_name);
-    nodes.push_back(ending_node);
+    if (const auto* ending_node = graph_.GetProducerNode(node_arg_name)) {
+      nodes.push_back(ending_node);
+    }
   }
 
   // Reversely traverse to get reachable nodes.
+  auto reachable_nodes = std::make_unique<InlinedHashSet<NodeIndex>>();
+  reachable_nodes->reserve(graph_.NumberOfNodes());
   graph_.ReverseDFSFrom(
-      nodes, {}, [&reachable_nodes](const Node* n) { reachable_nodes.insert(n->Index()); });
+      nodes, {}, [&reachable_nodes](const Node* n) { reachable_nodes->insert(n->Index()); });
 
-  // global start, end doesn't matters
-  to_be_executed_nodes_.emplace(std::move(sorted_idxs), std::move(reachable_nodes));
-}
+  if (reachable_nodes->size() == static_cast<size_t>(graph_.NumberOfNodes())) {
+    reachable_nodes.reset();
+  }
 
-const InlinedHashSet<NodeIndex>* SessionState::GetToBeExecutedRange(
-    gsl::span<int const> fetch_mlvalue_idxs) const {
-  InlinedVector<int> sorted_idxs;
-  sorted_idxs.reserve(fetch_mlvalue_idxs.size());
-  sorted_idxs.assign(fetch_mlvalue_idxs.begin(), fetch_mlvalue_idxs.end());
-  std::sort(sorted_idxs.begin(), sorted_idxs.end());
-  auto it = to_be_executed_nodes_.find(sorted_idxs);
-  return (it != to_be_executed_nodes_.end()) ? &it->second : nullptr;
+  return to_be_executed_nodes_.emplace(std::move(sorted_idxs), std::move(reachable_nodes)).first->second.get();
 }
-#endif
 
 Status SessionState::CreateSubgraphSessionState() {
   for (auto& node : graph_.Nodes()) {
@@ -1378,7 +1575,8 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
 
   SequentialPlannerContext context(session_options.execution_mode,
                                    session_options.execution_order,
-                                   session_options.enable_mem_reuse);
+                                   session_options.enable_mem_reuse,
+                                   static_memory_planning_);
 
 #ifdef _WIN32
 
@@ -1473,6 +1671,12 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   }
 #endif
 
+  // with parallel initialization, the intra op thread pool loads the initializers, creates the kernels and pre-packs
+  concurrency::ThreadPool* initialization_thread_pool =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigParallelInitialization, "0") == "1"
+          ? thread_pool_
+          : nullptr;
+
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInitializedTensors(
           Env::Default(), graph_location, *graph_viewer_,
@@ -1486,7 +1690,8 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
             }
             return Status::OK();
           },
-          logger_, data_transfer_mgr_, *p_seq_exec_plan_, session_options, memory_profile_func));
+          logger_, data_transfer_mgr_, *p_seq_exec_plan_, session_options, memory_profile_func,
+          initialization_thread_pool));
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Record Weight allocation info on device
@@ -1500,11 +1705,21 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
     CleanInitializedTensorsFromGraph();
   }
 
-  ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
+  ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager, initialization_thread_pool));
+
+  int64_t shape_specialization_hot_threshold = 0;
+  ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigShapeSpecializationHotThreshold, "0"),
+      shape_specialization_hot_threshold));
+  if (shape_specialization_hot_threshold > 0) {
+    shape_specialization_cache_ = std::make_unique<ShapeSpecializationCache>(
+        static_cast<size_t>(graph_viewer_->MaxNodeIndex()), shape_specialization_hot_threshold);
+  }
 
   if (!disable_prepacking) {
     ORT_RETURN_IF_ERROR(PrepackConstantInitializedTensors(constant_initializers_use_count,
-                                                          session_options.initializers_to_share_map));
+                                                          session_options.initializers_to_share_map,
+                                                          initialization_thread_pool));
   }
 
   ORT_RETURN_IF_ERROR(
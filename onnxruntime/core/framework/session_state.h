@@ -24,6 +24,7 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/shape_specialization_cache.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
@@ -58,6 +59,7 @@ class NodeIndexInfo;
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
 class DeviceStreamCollection;
+class SampledProfiler;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 class MemoryInfo;
 #endif
@@ -211,18 +213,31 @@ class SessionState {
   }
 #endif
 
+  /**
+  Get the sampled profiler for executions of this graph, or nullptr if sampled profiling is not enabled.
+  */
+  SampledProfiler* GetSampledProfiler() const noexcept { return sampled_profiler_; }
+
+  void SetSampledProfiler(SampledProfiler* sampled_profiler) noexcept {
+    sampled_profiler_ = sampled_profiler;
+  }
+
+  /**
+  Get the cache of the state kernels derive from their input shapes, or nullptr if shape specialization is not enabled.
+  */
+  ShapeSpecializationCache* GetShapeSpecializationCache() const noexcept { return shape_specialization_cache_.get(); }
+
   /**
   Get cached memory pattern based on input shapes
   Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  If the memory patterns are planned statically, the pattern for new input
+  shapes is planned and cached under the mutex, along with the shapes of the
+  values resolved from the input shapes.
   */
   const MemoryPatternGroup* GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
+      const InlinedHashSet<NodeIndex>* node_to_execute,
       const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
 
   /**
@@ -231,8 +246,38 @@ class SessionState {
   All inputs must represent Tensors
   */
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
+                                       const InlinedHashSet<NodeIndex>* node_to_execute,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Peak bytes of the activations of the executions of the graph with given input shapes.
+  planned_peak_bytes is the size of the memory pattern for the input shapes (0 if memory patterns are disabled),
+  actual_peak_bytes the maximum of the peaks reached by the executions.
+  Memory allocated by the kernels outside of the execution frame, e.g. by subgraphs, is not included.
+  */
+  struct MemoryUsage {
+    size_t planned_peak_bytes = 0;
+    size_t actual_peak_bytes = 0;
+  };
+
+  // Whether the executions record their memory usage. See kOrtSessionOptionsConfigRecordPeakMemoryUsage.
+  bool GetRecordMemoryUsage() const noexcept { return record_memory_usage_; }
+
+  /**
+  Record the memory usage of an execution with given inputs.
+  Const as it's an internal statistics update only.
+  All inputs must represent Tensors
+  */
+  void RecordMemoryUsage(gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> tensor_inputs,
+                         size_t planned_peak_bytes, size_t actual_peak_bytes) const;
+
+  /**
+  Get the recorded memory usage of the executions whose inputs have exactly the given OrtValue indexes and shapes.
+  Returns false if no execution with the input shapes was recorded.
+  */
+  bool GetMemoryUsage(gsl::span<const int> input_mlvalue_idxs, gsl::span<const TensorShape> input_shapes,
+                      MemoryUsage& memory_usage) const;
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
   /**
@@ -297,10 +342,16 @@ class SessionState {
   InlinedVector<BufferUniquePtr>& GetMutableWeightsBuffers() noexcept { return weights_buffers_; }
 
   const NodeIndexInfo& GetNodeIndexInfo() const;
-#ifdef ENABLE_TRAINING
-  void UpdateToBeExecutedRange(gsl::span<int const> fetch_mlvalue_idxs);
+
+  /**
+  Returns the nodes needed to produce the given fetches, or nullptr if all the nodes of the graph are needed.
+  Computed on the first call for a set of fetches and cached for the lifetime of the session state.
+  Executions look it up through FeedsFetchesManager::GetNodesToExecute.
+  */
   const InlinedHashSet<NodeIndex>* GetToBeExecutedRange(gsl::span<int const> fetch_mlvalue_idxs) const;
-#endif
+
+  // Whether every execution skips the nodes not needed by its fetches. See kOrtSessionOptionsConfigPruneToFetches.
+  bool GetPruneToFetches() const noexcept { return prune_to_fetches_; }
 
   Status FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                               const KernelRegistryManager& kernel_registry_manager,
@@ -360,8 +411,10 @@ class SessionState {
   // Populate OrtValueNameIdxMap and create the graph viewer.
   void CreateGraphInfo();
 
-  // create kernels using info in kernel_create_info_map_
-  Status CreateKernels(const KernelRegistryManager& custom_registry_manager);
+  // create kernels using info in kernel_create_info_map_.
+  // with a thread pool, the kernels of the CPU execution provider are created concurrently.
+  Status CreateKernels(const KernelRegistryManager& custom_registry_manager,
+                       concurrency::ThreadPool* thread_pool = nullptr);
 
   // remove TensorProto versions of initializers from Graph instance
   // (replaced byOrtValue instances in initialized_tensors_)
@@ -370,9 +423,12 @@ class SessionState {
   /**
    * Prepack the constant initialized tensors for better performance.
    * The original constant initialized tensors will be removed to save memory.
+   * With a thread pool, the kernels of the CPU execution provider pre-pack concurrently, unless pre-packed weights
+   * are cached in a shared container.
    */
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
-                                           const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
+                                           const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map,
+                                           concurrency::ThreadPool* thread_pool = nullptr);
 
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
@@ -393,13 +449,19 @@ class SessionState {
                                   const InlinedHashMap<OrtValueName, OrtDevice>& outer_scope_node_arg_to_location_map = {},
                                   bool graph_info_already_created = false);
 
-#ifdef ENABLE_TRAINING
+  // The key of the memory patterns of the executions with the given input shapes and nodes to execute.
+  int64_t GetMemoryPatternsKey(gsl::span<const OrtValue> tensor_inputs,
+                               const InlinedHashSet<NodeIndex>* node_to_execute) const;
+
+  // Plans the memory patterns for the input shapes from the shapes of the values and the program counters of the
+  // execution plan. Fails if a planned value has a shape that cannot be resolved, unless allow_unresolved_shapes
+  // is true, in which case the value is left out of the patterns and allocated dynamically.
   Status GeneratePatternGroupCache(
       gsl::span<const OrtValue> inputs,
       gsl::span<const int> feed_mlvalue_idxs,
+      bool allow_unresolved_shapes,
       MemoryPatternGroup& output,
       InlinedHashMap<int, TensorShape>& inferred_shapes) const;
-#endif
 
   // KernelCreateInfo for each node so we do kernel lookup once
   KernelCreateInfoMap kernel_create_info_map_;
@@ -480,21 +542,29 @@ class SessionState {
   MemoryProfiler* memory_profiler_;
 #endif
 
+  SampledProfiler* sampled_profiler_ = nullptr;
+
+  // see kOrtSessionOptionsConfigShapeSpecializationHotThreshold. created when the session state is finalized.
+  std::unique_ptr<ShapeSpecializationCache> shape_specialization_cache_;
+
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
+  // whether the memory patterns are planned from the shapes of the values. see kOrtSessionOptionsConfigStaticMemoryPlanning.
+  bool static_memory_planning_ = false;
 
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
+  // cache for the generated mem_patterns. key is calculated based on input shapes, and on the nodes executed by the
+  // executions that skip nodes. see GetMemoryPatternsKey.
   // must be a node based container as a pointer is cached.
   mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
+  // memory usage of the executions of all nodes, keyed by the OrtValue index, rank and dims of each input in the
+  // order of the indexes. bounded by kMaxMemoryUsageShapes and guarded by memory_usage_lock_.
+  mutable std::map<InlinedVector<int64_t>, MemoryUsage> memory_usage_;
+  mutable OrtMutex memory_usage_lock_;
+  bool record_memory_usage_ = false;
+  // shapes of the values resolved when planning the memory patterns statically. guarded by mem_patterns_lock_.
   mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -517,14 +587,10 @@ class SessionState {
   // prepacked_weights_container_ can be nullptr if no caching is required for prepacked weights
   PrepackedWeightsContainer* const prepacked_weights_container_{};
 
-#ifdef ENABLE_TRAINING
-// Needed for ORTTrainer. Should be removed along with ORTTrainer code
-#ifndef DISABLE_ABSEIL
-  InlinedHashMap<InlinedVector<int>, InlinedHashSet<NodeIndex>> to_be_executed_nodes_;
-#else
-  std::map<InlinedVector<int>, InlinedHashSet<NodeIndex>> to_be_executed_nodes_;
-#endif
-#endif
+  // the nodes needed by each sorted set of fetches, nullptr if all nodes are needed. see GetToBeExecutedRange.
+  mutable std::map<InlinedVector<int>, std::unique_ptr<InlinedHashSet<NodeIndex>>> to_be_executed_nodes_;
+  mutable OrtMutex to_be_executed_nodes_lock_;
+  bool prune_to_fetches_ = false;
 
   SessionState* parent_ = nullptr;
   // Assign each graph in each session an unique id.
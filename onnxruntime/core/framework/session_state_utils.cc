@@ -197,7 +197,8 @@ common::Status SaveInitializedTensors(
     const logging::Logger& logger, const DataTransferManager& data_transfer_mgr,
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
-    const MemoryProfileFunction& memory_profile_func) {
+    const MemoryProfileFunction& memory_profile_func,
+    concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
@@ -292,6 +293,62 @@ common::Status SaveInitializedTensors(
 
   OrtCallback deleter{nullptr, nullptr};
 
+  const bool use_device_allocator_for_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
+
+  auto deserialize_tensor = [&](int ort_value_index, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                OrtValue& ort_value) -> Status {
+    const std::string& name = tensor_proto.name();
+    std::optional<MemBuffer> m;
+    AllocatorPtr alloc;
+    // TODO: if the tensor need be copied, does it have enough room?
+    ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
+
+    Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
+                                       default_cpu_alloc, ort_value, data_transfer_mgr,
+                                       use_device_allocator_for_initializers);
+    if (!st.IsOK()) {
+      std::ostringstream oss;
+      oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
+      return Status(st.Category(), st.Code(), oss.str());
+    }
+    return Status::OK();
+  };
+
+  // with a thread pool, the tensors on CPU are deserialized concurrently up front, as that needs no copy
+  // through the data transfer manager. they are still saved one by one in the order below.
+  InlinedHashMap<int, std::pair<OrtValue, Status>> deserialized_tensors;
+  if (thread_pool != nullptr) {
+    InlinedVector<std::pair<int, const ONNX_NAMESPACE::TensorProto*>> cpu_tensors;
+    for (const auto& entry : id_to_initialized_tensor) {
+      if (!entry.second->name().empty() &&
+          user_supplied_initializer_ids.find(entry.first) == user_supplied_initializer_ids.end() &&
+          exec_plan.GetLocation(entry.first).Type() == OrtDevice::CPU) {
+        cpu_tensors.push_back(entry);
+      }
+    }
+
+    std::vector<std::pair<OrtValue, Status>> results(cpu_tensors.size());
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(cpu_tensors.size()),
+        [&](std::ptrdiff_t i) {
+          auto& result = results[i];
+          ORT_TRY {
+            result.second = deserialize_tensor(cpu_tensors[i].first, *cpu_tensors[i].second, result.first);
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              result.second = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+            });
+          }
+        });
+
+    deserialized_tensors.reserve(cpu_tensors.size());
+    for (size_t i = 0; i < cpu_tensors.size(); ++i) {
+      deserialized_tensors.emplace(cpu_tensors[i].first, std::move(results[i]));
+    }
+  }
+
   // 3. create weight tensors based on weights buffer
   for (const auto& entry : id_to_initialized_tensor) {
     int ort_value_index = entry.first;
@@ -307,24 +364,11 @@ common::Status SaveInitializedTensors(
     if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
       ort_value = *(session_options.initializers_to_share_map.at(name));
       LOGS(logger, INFO) << "Using user supplied initializer with name (" << name << ").";
+    } else if (auto it = deserialized_tensors.find(ort_value_index); it != deserialized_tensors.end()) {
+      ORT_RETURN_IF_ERROR(it->second.second);
+      ort_value = std::move(it->second.first);
     } else {
-      const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
-
-      std::optional<MemBuffer> m;
-      AllocatorPtr alloc;
-      // TODO: if the tensor need be copied, does it have enough room?
-      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
-      bool use_device_allocator_for_initializers =
-          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
-
-      Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
-                                         default_cpu_alloc, ort_value, data_transfer_mgr,
-                                         use_device_allocator_for_initializers);
-      if (!st.IsOK()) {
-        std::ostringstream oss;
-        oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-        return Status(st.Category(), st.Code(), oss.str());
-      }
+      ORT_RETURN_IF_ERROR(deserialize_tensor(ort_value_index, *(entry.second), ort_value));
     }
 
     // 'name' is a reference to a string within the TensorProto that save_tensor_func may free
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shape_specialization_cache.h"
+
+#include <algorithm>
+
+#include "core/common/hash_combine.h"
+
+namespace onnxruntime {
+
+ShapeSpecializationCache::ShapeSpecializationCache(size_t num_nodes, int64_t hot_threshold)
+    : hot_threshold_(hot_threshold),
+      num_nodes_(num_nodes),
+      node_states_(std::make_unique<NodeStates[]>(num_nodes)) {
+  ORT_ENFORCE(hot_threshold_ > 0, "The hot threshold of shape specialization must be positive.");
+}
+
+ShapeSpecializationCache::~ShapeSpecializationCache() = default;
+
+size_t ShapeSpecializationCache::Hash(gsl::span<const int64_t> signature) {
+  size_t hash = 0;
+  for (const int64_t value : signature) {
+    HashCombine(value, hash);
+  }
+  return hash;
+}
+
+const void* ShapeSpecializationCache::FindHotState(const NodeStates& node_states, size_t begin, size_t end,
+                                                   size_t hash, gsl::span<const int64_t> signature) {
+  for (size_t i = begin; i < end; ++i) {
+    const HotEntry& entry = *node_states.hot_entries[i];
+    if (entry.hash == hash &&
+        std::equal(entry.signature.begin(), entry.signature.end(), signature.begin(), signature.end())) {
+      return entry.state.get();
+    }
+  }
+
+  return nullptr;
+}
+
+Status ShapeSpecializationCache::GetOrCreateState(NodeIndex node_index, gsl::span<const int64_t> signature,
+                                                  const StateFactory& create_fn, const void*& state) {
+  state = nullptr;
+  // nodes added after the session state was finalized, such as by a kernel creating a subgraph, aren't cached.
+  if (node_index >= num_nodes_ || signature.size() > kMaxSignatureLength) {
+    return Status::OK();
+  }
+
+  auto& node_states = node_states_[node_index];
+  const size_t hash = Hash(signature);
+
+  // the published entries are never modified or removed, so they are read without the lock
+  const size_t num_hot = node_states.num_hot.load(std::memory_order_acquire);
+  state = FindHotState(node_states, 0, num_hot, hash, signature);
+  if (state != nullptr || num_hot == kMaxHotSignaturesPerNode) {
+    return Status::OK();
+  }
+
+  std::lock_guard<OrtMutex> lock(node_states.mutex);
+
+  // another thread may have published the signature meanwhile
+  const size_t num_hot_locked = node_states.num_hot.load(std::memory_order_relaxed);
+  state = FindHotState(node_states, num_hot, num_hot_locked, hash, signature);
+  if (state != nullptr || num_hot_locked == kMaxHotSignaturesPerNode) {
+    return Status::OK();
+  }
+
+  auto& cold_entries = node_states.cold_entries;
+  auto cold_entry = std::find_if(cold_entries.begin(), cold_entries.end(),
+                                 [hash](const ColdEntry& entry) { return entry.hash == hash; });
+  if (cold_entry == cold_entries.end()) {
+    if (cold_entries.size() < kMaxColdSignaturesPerNode) {
+      cold_entry = cold_entries.insert(cold_entries.end(), ColdEntry{hash, 0});
+    } else {
+      // evict the least looked up signature
+      cold_entry = std::min_element(cold_entries.begin(), cold_entries.end(),
+                                    [](const ColdEntry& a, const ColdEntry& b) { return a.lookups < b.lookups; });
+      *cold_entry = ColdEntry{hash, 0};
+    }
+  }
+
+  if (++cold_entry->lookups < hot_threshold_) {
+    return Status::OK();
+  }
+
+  auto hot_entry = std::make_unique<HotEntry>();
+  ORT_RETURN_IF_ERROR(create_fn.create(create_fn.context, hot_entry->state));
+  hot_entry->hash = hash;
+  hot_entry->signature.assign(signature.begin(), signature.end());
+  cold_entries.erase(cold_entry);
+
+  // the state is owned by the entry, which is never removed, so it outlives the lookup
+  state = hot_entry->state.get();
+  node_states.hot_entries[num_hot_locked] = std::move(hot_entry);
+  node_states.num_hot.store(num_hot_locked + 1, std::memory_order_release);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
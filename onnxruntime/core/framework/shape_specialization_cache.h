@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Caches the state kernels derive from the shapes of their inputs, such as broadcast plans or GEMM parameters,
+ * for the input shapes a node sees repeatedly. Kernels use it through OpKernelContext::GetShapeSpecializedState.
+ *
+ * The state for an input shape signature is created on its hot_threshold-th lookup, so shapes seen only a few times
+ * don't use memory. Until then the lookups of a signature are counted in a separate table of kMaxColdSignaturesPerNode
+ * entries per node, which evicts the least looked up signature when full, so the shapes seen during warm-up don't
+ * prevent the later hot shapes from being cached. A node keeps the state of at most kMaxHotSignaturesPerNode
+ * signatures for the lifetime of the session, and looking up a cached state takes no lock.
+ */
+class ShapeSpecializationCache {
+ public:
+  // Creates the state of a signature. A function pointer and its context rather than a std::function, so that
+  // looking up the state doesn't allocate.
+  struct StateFactory {
+    Status (*create)(const void* context, std::shared_ptr<const void>& state);
+    const void* context;
+  };
+
+  // The longest signature that is cached, so kernels can build it on the stack.
+  static constexpr size_t kMaxSignatureLength = 32;
+
+  ShapeSpecializationCache(size_t num_nodes, int64_t hot_threshold);
+  ~ShapeSpecializationCache();
+
+  /**
+   * Looks up the state of a node for the shapes of its inputs.
+   * @param signature The ranks and dimensions of the inputs of the node.
+   * @param create_fn Creates the state if the signature becomes hot with this lookup.
+   * @param state Set to the state if the signature is hot, or nullptr.
+   */
+  Status GetOrCreateState(NodeIndex node_index, gsl::span<const int64_t> signature,
+                          const StateFactory& create_fn, const void*& state);
+
+ private:
+  // Bounds the memory used by the nodes whose input shapes vary.
+  static constexpr size_t kMaxHotSignaturesPerNode = 8;
+  static constexpr size_t kMaxColdSignaturesPerNode = 16;
+
+  struct HotEntry {
+    size_t hash;
+    InlinedVector<int64_t> signature;
+    std::shared_ptr<const void> state;
+  };
+
+  // The lookups of a signature that is not hot yet. Only the hash is kept, so a collision makes a signature hot
+  // earlier but doesn't share the state of another signature.
+  struct ColdEntry {
+    size_t hash;
+    int64_t lookups;
+  };
+
+  struct NodeStates {
+    // hot_entries[0, num_hot) are immutable once published by the release store of num_hot
+    std::array<std::unique_ptr<const HotEntry>, kMaxHotSignaturesPerNode> hot_entries;
+    std::atomic<size_t> num_hot{0};
+
+    // guards cold_entries and the publication of hot entries
+    OrtMutex mutex;
+    InlinedVector<ColdEntry, kMaxColdSignaturesPerNode> cold_entries;
+  };
+
+  static size_t Hash(gsl::span<const int64_t> signature);
+
+  // Returns the published state of the signature in hot_entries[begin, end), or nullptr.
+  static const void* FindHotState(const NodeStates& node_states, size_t begin, size_t end, size_t hash,
+                                  gsl::span<const int64_t> signature);
+
+  const int64_t hot_threshold_;
+  const size_t num_nodes_;
+  std::unique_ptr<NodeStates[]> node_states_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,184 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_registry.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iterator>
+#include <optional>
+
+#include "core/framework/callback.h"
+#include "core/framework/endian.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// MurmurHash3 of a sequence of buffers, chaining the full 128 bits of state between them
+class ContentHasher {
+ public:
+  void Add(const void* data, size_t len) {
+    // MurmurHash3 takes an int length, so hash large buffers in chunks
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    do {
+      const int chunk = static_cast<int>(std::min<size_t>(len, INT_MAX));
+      uint32_t chained[8];
+      std::copy(std::begin(hash_), std::end(hash_), chained);
+      MurmurHash3::x86_128(bytes, chunk, 0, chained + 4);
+      MurmurHash3::x86_128(chained, static_cast<int>(sizeof(chained)), 0, &hash_);
+      bytes += chunk;
+      len -= chunk;
+    } while (len > 0);
+  }
+
+  uint64_t Value() const { return uint64_t(hash_[0]) | (uint64_t(hash_[1]) << 32); }
+
+ private:
+  uint32_t hash_[4] = {0, 0, 0, 0};
+};
+
+uint64_t Hash(int32_t elem_type, gsl::span<const int64_t> dims, gsl::span<const uint8_t> bytes) {
+  ContentHasher hasher;
+  hasher.Add(&elem_type, sizeof(elem_type));
+  hasher.Add(dims.data(), dims.size_bytes());
+  hasher.Add(bytes.data(), bytes.size());
+  return hasher.Value();
+}
+
+gsl::span<const uint8_t> GetBytes(const Tensor& tensor) {
+  return gsl::make_span(static_cast<const uint8_t*>(tensor.DataRaw()), tensor.SizeInBytes());
+}
+
+// Gets the bytes of the raw or external data of tensor_proto, which have the layout of the deserialized tensor on
+// little-endian hosts. Returns an empty span if the data is in the typed fields and must be deserialized.
+Status GetSerializedBytes(const ONNX_NAMESPACE::TensorProto& tensor_proto, const Path& model_path,
+                          gsl::span<const uint8_t>& bytes, std::optional<ScopedOrtCallbackInvoker>& release_bytes) {
+  bytes = {};
+  if constexpr (endian::native != endian::little) {
+    return Status::OK();
+  }
+
+  size_t size_in_bytes = 0;
+  ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes));
+
+  if (utils::HasExternalData(tensor_proto)) {
+    void* ext_data_buf = nullptr;
+    SafeInt<size_t> ext_data_len = 0;
+    OrtCallback ext_data_deleter{nullptr, nullptr};
+    ORT_RETURN_IF_ERROR(utils::GetExtDataFromTensorProto(
+        Env::Default(), model_path.IsEmpty() ? nullptr : model_path.ToPathString().c_str(), tensor_proto,
+        ext_data_buf, ext_data_len, ext_data_deleter));
+    release_bytes.emplace(ext_data_deleter);
+    bytes = gsl::make_span(static_cast<const uint8_t*>(ext_data_buf), static_cast<size_t>(ext_data_len));
+  } else if (utils::HasRawData(tensor_proto)) {
+    bytes = gsl::make_span(reinterpret_cast<const uint8_t*>(tensor_proto.raw_data().data()),
+                           tensor_proto.raw_data().size());
+  } else {
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_NOT(bytes.size() == size_in_bytes, "The data of initializer ", tensor_proto.name(), " has ",
+                    bytes.size(), " bytes but its shape and type need ", size_in_bytes);
+  return Status::OK();
+}
+
+}  // namespace
+
+SharedInitializerRegistry::SharedInitializerRegistry() : allocator_(std::make_shared<CPUAllocator>()) {}
+
+std::shared_ptr<const OrtValue> SharedInitializerRegistry::FindLocked(uint64_t hash, int32_t elem_type,
+                                                                      gsl::span<const int64_t> dims,
+                                                                      gsl::span<const uint8_t> bytes) {
+  auto [begin, end] = initializers_.equal_range(hash);
+  for (auto it = begin; it != end;) {
+    std::shared_ptr<const OrtValue> registered = it->second.lock();
+    if (registered == nullptr) {
+      // all the sessions holding it were released
+      it = initializers_.erase(it);
+      continue;
+    }
+
+    const auto& tensor = registered->Get<Tensor>();
+    const auto registered_dims = tensor.Shape().GetDims();
+    if (tensor.GetElementType() == elem_type &&
+        std::equal(registered_dims.begin(), registered_dims.end(), dims.begin(), dims.end()) &&
+        tensor.SizeInBytes() == bytes.size() &&
+        std::memcmp(tensor.DataRaw(), bytes.data(), bytes.size()) == 0) {
+      return registered;
+    }
+    ++it;
+  }
+
+  return nullptr;
+}
+
+Status SharedInitializerRegistry::GetOrAddInitializer(const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                                      const Path& model_path,
+                                                      std::shared_ptr<const OrtValue>& initializer) {
+  ORT_RETURN_IF(tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING,
+                "String initializers cannot be shared by content: ", tensor_proto.name());
+
+  gsl::span<const uint8_t> bytes;
+  std::optional<ScopedOrtCallbackInvoker> release_bytes;
+  ORT_RETURN_IF_ERROR(GetSerializedBytes(tensor_proto, model_path, bytes, release_bytes));
+
+  std::shared_ptr<OrtValue> ort_value;
+  const auto deserialize = [&]() {
+    ort_value = std::make_shared<OrtValue>();
+    return utils::TensorProtoToOrtValue(Env::Default(),
+                                        model_path.IsEmpty() ? nullptr : model_path.ToPathString().c_str(),
+                                        tensor_proto, allocator_, *ort_value);
+  };
+
+  const auto elem_type = static_cast<int32_t>(tensor_proto.data_type());
+  const InlinedVector<int64_t> dims(tensor_proto.dims().begin(), tensor_proto.dims().end());
+  if (bytes.empty()) {
+    // the data is in the typed fields of the TensorProto
+    ORT_RETURN_IF_ERROR(deserialize());
+    bytes = GetBytes(ort_value->Get<Tensor>());
+  }
+  const uint64_t hash = Hash(elem_type, dims, bytes);
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (auto registered = FindLocked(hash, elem_type, dims, bytes); registered != nullptr) {
+      initializer = std::move(registered);
+      return Status::OK();
+    }
+  }
+
+  if (ort_value == nullptr) {
+    // deserialize out of the lock, so that sessions loading other initializers don't wait
+    ORT_RETURN_IF_ERROR(deserialize());
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  // another session may have registered the same content meanwhile
+  auto registered = FindLocked(hash, elem_type, dims, GetBytes(ort_value->Get<Tensor>()));
+  if (registered != nullptr) {
+    initializer = std::move(registered);
+    return Status::OK();
+  }
+
+  initializers_.emplace(hash, ort_value);
+  initializer = std::move(ort_value);
+  return Status::OK();
+}
+
+std::shared_ptr<PrepackedWeightsContainer> SharedInitializerRegistry::GetPrepackedWeightsContainer() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto container = prepacked_weights_container_.lock();
+  if (container == nullptr) {
+    container = std::make_shared<PrepackedWeightsContainer>();
+    prepacked_weights_container_ = container;
+  }
+
+  return container;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/path.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/prepacked_weights_container.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Content addressed store of the constant initializers shared by the sessions of an environment, so that the sessions
+ * of models with identical weights, such as fine-tuned variants of a base model, hold a single copy of each.
+ *
+ * The initializers are keyed by a MurmurHash3 of their type, shape and bytes, and compared in full when the hashes
+ * match. The bytes are read from the raw or external data of the TensorProto, so an initializer is only deserialized
+ * when it is not registered yet. An initializer is released when the last session holding it releases it.
+ *
+ * The pre-packed forms of the shared initializers are cached in a PrepackedWeightsContainer, whose keys are also
+ * content hashes. The container is released with the last session holding it, so the pre-packed forms of an
+ * initializer outlive it as long as other sessions sharing initializers by content are alive.
+ */
+class SharedInitializerRegistry {
+ public:
+  SharedInitializerRegistry();
+
+  /**
+   * Returns the shared initializer with the same content as tensor_proto, registering it if there is none.
+   * @param model_path The path of the model, used to read the data of tensor_proto if it is external.
+   */
+  Status GetOrAddInitializer(const ONNX_NAMESPACE::TensorProto& tensor_proto, const Path& model_path,
+                             std::shared_ptr<const OrtValue>& initializer);
+
+  /**
+   * Returns the container of the pre-packed forms of the shared initializers, creating it if no session holds it.
+   */
+  std::shared_ptr<PrepackedWeightsContainer> GetPrepackedWeightsContainer();
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerRegistry);
+
+ private:
+  // Returns the registered initializer with the given content, or nullptr. The caller must hold mutex_.
+  std::shared_ptr<const OrtValue> FindLocked(uint64_t hash, int32_t elem_type, gsl::span<const int64_t> dims,
+                                             gsl::span<const uint8_t> bytes);
+
+  AllocatorPtr allocator_;
+
+  OrtMutex mutex_;
+  std::unordered_multimap<uint64_t, std::weak_ptr<const OrtValue>> initializers_;
+  std::weak_ptr<PrepackedWeightsContainer> prepacked_weights_container_;
+};
+
+}  // namespace onnxruntime
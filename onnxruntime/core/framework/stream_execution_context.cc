@@ -20,7 +20,8 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
                                                const std::unordered_map<size_t, IExecutor::CustomAllocator>&
                                                    fetch_allocators,
                                                const logging::Logger& sess_logger,
-                                               bool single_thread_mode)
+                                               bool single_thread_mode,
+                                               const InlinedHashSet<NodeIndex>* node_to_execute)
     : session_state_(&sess_state),
       frame_(feed_mlvalue_idxs,
              feeds,
@@ -28,8 +29,10 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
              fetches,
              fetch_allocators,
              device_stream_map,
-             sess_state),
+             sess_state,
+             node_to_execute),
       logger_(&sess_logger),
+      node_to_execute_(node_to_execute),
       single_thread_mode_(single_thread_mode),
       device_stream_map_(device_stream_map),
       count_down_barriers_(num_barriers) {
@@ -88,15 +91,18 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
                                                const std::unordered_map<size_t, IExecutor::CustomAllocator>&
                                                    fetch_allocators,
                                                const logging::Logger& sess_logger,
-                                               bool single_thread_mode)
+                                               bool single_thread_mode,
+                                               const InlinedHashSet<NodeIndex>* node_to_execute)
     : session_state_(&sess_state),
       frame_(feed_mlvalue_idxs,
              feeds,
              fetch_mlvalue_idxs,
              fetches,
              fetch_allocators,
-             sess_state),
+             sess_state,
+             node_to_execute),
       logger_(&sess_logger),
+      node_to_execute_(node_to_execute),
       single_thread_mode_(single_thread_mode) {
 #ifdef _WIN32
 #pragma warning(push)
@@ -249,10 +255,12 @@ void ScheduleDownstream(StreamExecutionContext& ctx, size_t trigger, bool single
   auto* tp = single_thread_mode ? nullptr : ctx.GetSessionState().GetInterOpThreadPool();
   auto it = downstream_map.find(trigger);
   if (it != downstream_map.end()) {
+    const int loop_thread_limit = concurrency::ThreadPool::ScopedLoopThreadLimit::Current();
     for (auto downstream : it->second) {
       // increase the task count before schedule down-stream
       ctx.AddTask();
-      concurrency::ThreadPool::Schedule(tp, [&ctx, downstream, &terminate_flag, &session_scope]() {
+      concurrency::ThreadPool::Schedule(tp, [&ctx, downstream, &terminate_flag, &session_scope, loop_thread_limit]() {
+        concurrency::ThreadPool::ScopedLoopThreadLimit scoped_loop_thread_limit(loop_thread_limit);
         RunSince(downstream.first, ctx, session_scope, terminate_flag, downstream.second);
       });
     }
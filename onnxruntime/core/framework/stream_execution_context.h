@@ -70,7 +70,8 @@ class StreamExecutionContext {
                          std::vector<OrtValue>& fetches,
                          const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                          const logging::Logger& sess_logger,
-                         bool single_thread_mode);
+                         bool single_thread_mode,
+                         const InlinedHashSet<NodeIndex>* node_to_execute = nullptr);
 
   const SessionState& GetSessionState() const;
 
@@ -136,17 +137,13 @@ class StreamExecutionContext {
   void SetCurrentRange(const ProgramRegion* range) {
     program_range_ = range;
   }
+#endif
 
+  // The nodes to execute, nullptr to execute all of them. See SessionState::GetToBeExecutedRange.
   const InlinedHashSet<NodeIndex>* GetNodeToExecute() {
     return node_to_execute_;
   }
 
-  void SetNodeToExecute(const InlinedHashSet<NodeIndex>* node_to_execute) {
-    node_to_execute_ = node_to_execute;
-  }
-
-#endif
-
  private:
   const SessionState* session_state_;
 
@@ -164,11 +161,9 @@ class StreamExecutionContext {
   const ProgramRegion* program_range_{nullptr};
 
   OrtValueCachePtr cache_{nullptr};
-
-  // TODO: this is mainly for ort trainer
-  // Should we deprecate it?
-  const InlinedHashSet<NodeIndex>* node_to_execute_{nullptr};
 #endif
+
+  const InlinedHashSet<NodeIndex>* const node_to_execute_;
   const bool single_thread_mode_;
 
 #ifdef ORT_ENABLE_STREAM
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/string_buffer.h"
+
+namespace onnxruntime {
+
+Status StringBufferView::Create(const char* data, size_t data_len, gsl::span<const size_t> offsets,
+                                StringBufferView& view) {
+  size_t prev = 0;
+  for (const size_t offset : offsets) {
+    ORT_RETURN_IF(offset < prev || offset > data_len,
+                  "String offsets must be non-decreasing and within the buffer of ", data_len, " bytes. Got ",
+                  offset, " after ", prev);
+    prev = offset;
+  }
+
+  view = StringBufferView(data, data_len, offsets);
+  return Status::OK();
+}
+
+void StringBufferView::CopyTo(size_t first, gsl::span<std::string> dst) const {
+  ORT_ENFORCE(first + dst.size() <= Size(), "Copying strings past the end of the buffer");
+  for (size_t i = 0; i < dst.size(); ++i) {
+    const std::string_view str = (*this)[first + i];
+    dst[i].assign(str.data(), str.size());
+  }
+}
+
+}  // namespace onnxruntime
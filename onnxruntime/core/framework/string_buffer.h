@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+
+namespace onnxruntime {
+
+/**
+ * A read-only view of strings stored in one contiguous byte buffer, given the start offset of each string.
+ * Each string ends where the next one starts, and the last one at the end of the buffer. This is the layout of
+ * OrtApi::GetStringTensorContent and OrtApi::FillStringTensorFromBuffer.
+ */
+class StringBufferView {
+ public:
+  StringBufferView() = default;
+
+  /**
+   * Creates a view of external data.
+   * @param data The strings written sequentially. Not null terminated.
+   * @param data_len The number of bytes of data.
+   * @param offsets The start offset of each string in data. Must be non-decreasing and within data.
+   */
+  static Status Create(const char* data, size_t data_len, gsl::span<const size_t> offsets, StringBufferView& view);
+
+  size_t Size() const noexcept { return offsets_.size(); }
+
+  std::string_view operator[](size_t i) const noexcept {
+    const size_t end = (i + 1 < offsets_.size()) ? offsets_[i + 1] : data_len_;
+    return std::string_view(data_ + offsets_[i], end - offsets_[i]);
+  }
+
+  // Copies the strings [first, first + dst.size()) to the elements of a string tensor. Each element is assigned
+  // with a single copy of the exact size, which allocates only if it doesn't fit in the element.
+  void CopyTo(size_t first, gsl::span<std::string> dst) const;
+
+ private:
+  StringBufferView(const char* data, size_t data_len, gsl::span<const size_t> offsets) noexcept
+      : data_(data), data_len_(data_len), offsets_(offsets) {}
+
+  const char* data_ = nullptr;
+  size_t data_len_ = 0;
+  gsl::span<const size_t> offsets_;
+};
+
+}  // namespace onnxruntime
@@ -617,6 +617,12 @@ ExecuteGraphImpl(const SessionState& session_state,
   //    deadlock when we reach the limitation of thread pool.
   bool single_thread_mode = execution_mode == ExecutionMode::ORT_SEQUENTIAL || is_subgraph;
 
+  // skip the nodes not needed by the fetches
+  const InlinedHashSet<NodeIndex>* node_to_execute = nullptr;
+  if (only_execute_path_to_fetches || session_state.GetPruneToFetches()) {
+    node_to_execute = feeds_fetches_manager.GetNodesToExecute(session_state);
+  }
+
   // see if we can skip copies due to the types of execution providers available
   if (device_copy_checks.status == DeviceCopyCheck::NoCopy) {
     // no device copies are needed so simple execute
@@ -628,7 +634,7 @@ ExecuteGraphImpl(const SessionState& session_state,
                                   device_stream_collection,
 #endif
                                   terminate_flag,
-                                  only_execute_path_to_fetches,
+                                  node_to_execute,
                                   // single thread mode
                                   single_thread_mode));
     ORT_RETURN_IF_ERROR(status);
@@ -698,7 +704,7 @@ ExecuteGraphImpl(const SessionState& session_state,
                                   device_stream_collection,
 #endif
                                   terminate_flag,
-                                  only_execute_path_to_fetches,
+                                  node_to_execute,
                                   single_thread_mode));
     ORT_RETURN_IF_ERROR(status);
     InlinedVector<Stream*> fetches_streams;
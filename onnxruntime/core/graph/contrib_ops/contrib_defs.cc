@@ -628,6 +628,41 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           return true;
         }));
 
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Evaluates a chain of elementwise operators in a single pass over the output. Created by the ElementwiseChainFusion
+graph transformer.
+
+The chain is a program over registers. Registers 0 to N - 1 hold the N inputs, and register N + i holds the result
+of the i-th operator in `ops`, whose operands are the registers listed at positions 3 * i to 3 * i + 2 of `operands`
+(-1 for unused positions). The output is the result of the last operator.
+
+Supported operators are Add, Sub, Mul, Div, Relu, Neg, Sigmoid, Tanh, Erf, Where and Cast, with the ONNX semantics
+of these operators for float values. The inputs are multidirectionally broadcast to the shape of the output. Boolean
+inputs are only used as the condition of Where or the input of Cast.)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    FusedElementwise, 1,
+    OpSchema()
+        .SetDoc(FusedElementwise_ver1_doc)
+        .Attr("ops", "The operator types of the chain, in execution order.", AttributeProto::STRINGS)
+        .Attr("operands", "The registers of the operands of each operator, 3 per operator.", AttributeProto::INTS)
+        .Input(0, "inputs", "The inputs of the chain.", "T", OpSchema::Variadic, false)
+        .Output(0, "Y", "The result of the last operator.", "tensor(float)")
+        .TypeConstraint("T", {"tensor(float)", "tensor(bool)"}, "Constrain inputs to float and bool tensors.")
+        .TypeAndShapeInferenceFunction([](InferenceContext& ctx) {
+          updateOutputElemType(ctx, 0, TensorProto::FLOAT);
+          const size_t num_inputs = ctx.getNumInputs();
+          if (hasNInputShapes(ctx, static_cast<int>(num_inputs))) {
+            std::vector<const TensorShapeProto*> shapes;
+            shapes.reserve(num_inputs);
+            for (size_t i = 0; i < num_inputs; ++i) {
+              shapes.push_back(&ctx.getInputType(i)->tensor_type().shape());
+            }
+            multidirectionalBroadcastShapeInference(shapes,
+                                                    *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape());
+          }
+        }));
+
 // Used to be ONNX 1.7 Inverse(12)
 // Comment out docs not to increase the binary size
 //
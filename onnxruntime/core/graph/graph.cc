@@ -3,6 +3,7 @@
 
 #include "core/graph/graph.h"
 
+#include <atomic>
 #include <cassert>
 #include <fstream>
 #include <iostream>
@@ -12,6 +13,7 @@
 
 #include "core/common/common.h"
 #include "core/common/gsl.h"
+#include "core/common/hash_combine.h"
 #include "core/common/inlined_containers.h"
 #include "core/common/logging/logging.h"
 #include "core/common/narrow.h"
@@ -2515,7 +2517,61 @@ common::Status Graph::TypeCheckInputsAndInitializers() {
   return Status::OK();
 }
 
+void Graph::OnInitializerChanged(const std::string& name) {
+  // unique across graphs, so an initializer moved between a graph and its subgraphs gets a new generation too
+  static std::atomic<uint64_t> next_generation{1};
+  initializer_generations_[name] = next_generation++;
+}
+
+// Initializer inputs are identified by their TensorProto and generation as inferencing may read their data.
+size_t Graph::HashNodeInferenceInputs(const Node& node, const NodeProto& node_proto) const {
+  size_t hash = std::hash<std::string>{}(node_proto.SerializeAsString());
+  HashCombine(node.Op(), hash);
+  HashCombine(node.SinceVersion(), hash);
+  for (const auto* input_def : node.InputDefs()) {
+    const auto* type = input_def->TypeAsProto();
+    HashCombine(type ? type->SerializeAsString() : std::string{}, hash);
+    if (!input_def->Exists()) {
+      continue;
+    }
+
+    const auto& name = input_def->Name();
+    HashCombine(GetInitializer(name, true), hash);
+    for (const Graph* graph = this; graph != nullptr; graph = graph->parent_graph_) {
+      const auto generation = graph->initializer_generations_.find(name);
+      if (generation != graph->initializer_generations_.end()) {
+        HashCombine(generation->second, hash);
+        break;
+      }
+    }
+  }
+
+  return hash;
+}
+
+static size_t HashNodeOutputTypes(const Node& node) {
+  size_t hash = 0;
+  for (const auto* output_def : node.OutputDefs()) {
+    const auto* type = output_def->TypeAsProto();
+    HashCombine(type ? type->SerializeAsString() : std::string{}, hash);
+  }
+
+  return hash;
+}
+
 Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
+  const Graph* root_graph = this;
+  while (root_graph->parent_graph_ != nullptr) {
+    root_graph = root_graph->parent_graph_;
+  }
+
+  // overriding types changes the result of inferencing without changing its inputs
+  const auto incremental_resolve_mode = options.override_types ? IncrementalResolveMode::kDisabled
+                                                               : root_graph->incremental_resolve_mode_;
+  if (incremental_resolve_mode == IncrementalResolveMode::kDisabled) {
+    node_inference_signatures_.clear();
+  }
+
   CheckerContext ctx;
   ctx.set_ir_version(gsl::narrow_cast<int>(IrVersion()));
   ctx.set_opset_imports(DomainToVersionMap());
@@ -2627,7 +2683,29 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
       }
     }
 
-    NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+    if (incremental_resolve_mode == IncrementalResolveMode::kDisabled || node.ContainsSubgraph()) {
+      NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+    } else {
+      // skip the inferencing of a node whose inputs to it, and whose outputs from it, are unchanged since the last time
+      const size_t inputs_hash = HashNodeInferenceInputs(node, node_proto);
+      const auto signature_it = node_inference_signatures_.find(node_index);
+      const bool unchanged = signature_it != node_inference_signatures_.end() &&
+                             signature_it->second.inputs_hash == inputs_hash &&
+                             signature_it->second.outputs_hash == HashNodeOutputTypes(node);
+
+      if (!unchanged || incremental_resolve_mode == IncrementalResolveMode::kVerified) {
+        NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+      }
+
+      const size_t outputs_hash = HashNodeOutputTypes(node);
+      if (unchanged && outputs_hash != signature_it->second.outputs_hash) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                               "Incremental resolve skipped the type and shape inferencing of node ", node,
+                               " which changes its output types.");
+      }
+
+      node_inference_signatures_[node_index] = {inputs_hash, outputs_hash};
+    }
 
     // Accumulate output names of the iterated Node
     for (auto& output_name : node_proto.output()) {
@@ -2838,6 +2916,9 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
   *(tensor_added) = tensor;
   name_to_initial_tensor_[tensor.name()] = tensor_added;
   SetGraphResolveNeeded();
+#if !defined(ORT_MINIMAL_BUILD)
+  OnInitializerChanged(tensor.name());
+#endif
   if (!is_loaded_from_model_file_ && GetNodeArg(tensor.name()) == nullptr) {
     // make sure there is a NodeArg for the initializer as SetGraphInputsOutputs may add it to the graph inputs.
     // the shape will be set to the correct value in TypeCheckInputsAndInitializers as we don't yet know whether there
@@ -2896,6 +2977,9 @@ void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
     sparse_tensor_names_.erase(tensor_name);
 #endif
     SetGraphResolveNeeded();
+#if !defined(ORT_MINIMAL_BUILD)
+    OnInitializerChanged(tensor_name);
+#endif
   } else {
 #if !defined(DISABLE_SPARSE_TENSORS)
     ORT_ENFORCE(sparse_tensor_names_.count(tensor_name) == 0, "sparse_tensor_names_ not in sync with name_to_initial_tensor_");
@@ -2951,6 +3035,10 @@ Status Graph::ReplaceInitializedTensorImpl(ONNX_NAMESPACE::TensorProto new_initi
 
   **existing_entry = std::move(new_initializer);
 
+  // the type and shape inferencing of the consumers of the initializer, including those in subgraphs, may have read
+  // its data, which is replaced at the same address.
+  OnInitializerChanged((*existing_entry)->name());
+
   return Status::OK();
 }
 
@@ -4045,6 +4133,9 @@ Status Graph::AddConstantProtoAsInitializer(const ONNX_NAMESPACE::NodeProto& nod
   auto insert_result = name_to_initial_tensor_.emplace(tensor->name(), tensor);
   ORT_ENFORCE(insert_result.second, "Constant node name: ", tensor->name(),
               " conflicts with graph initializer. Check that the node names have been made unique.");
+#if !defined(ORT_MINIMAL_BUILD)
+  OnInitializerChanged(tensor->name());
+#endif
   if (GetNodeArg(tensor->name()) == nullptr) {
     TypeProto t{TypeProtoFromTensorProto(*tensor)};
     ORT_IGNORE_RETURN_VALUE(GetOrCreateNodeArg(tensor->name(), &t));
@@ -4178,6 +4269,9 @@ Status Graph::InlineIfSubgraph(bool condition_value, Node& if_node, const loggin
     auto insert_result = name_to_initial_tensor_.emplace(tensor->name(), tensor);
     ORT_ENFORCE(insert_result.second, "Initializer name: ", tensor->name(), " from graph: ",
                 graph_to_inline.Name(), " conflicts with graph initializer. Check name generation above.");
+#if !defined(ORT_MINIMAL_BUILD)
+    OnInitializerChanged(tensor->name());
+#endif
 
 #if !defined(DISABLE_SPARSE_TENSORS)
     if (has_sparse_origin) {
@@ -4495,6 +4589,9 @@ Status Graph::InlineFunction(Node& callnode) {
       auto insert_result = name_to_initial_tensor_.emplace(tensor->name(), tensor);
       ORT_ENFORCE(insert_result.second, "Initializer name: ", tensor->name(), " in inlined subgraph: ",
                   subgraph.Name(), " conflicts with graph initializer. Check Specializing code.");
+#if !defined(ORT_MINIMAL_BUILD)
+      OnInitializerChanged(tensor->name());
+#endif
       if (GetNodeArg(tensor->name()) == nullptr) {
         TypeProto t{TypeProtoFromTensorProto(*tensor)};
         ORT_IGNORE_RETURN_VALUE(GetOrCreateNodeArg(tensor->name(), &t));
@@ -11,6 +11,7 @@
 #include "core/optimizer/utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/threadpool.h"
 
 using namespace onnxruntime::common;
 
@@ -19,13 +20,80 @@ namespace onnxruntime {
 ConstantFolding::ConstantFolding(const IExecutionProvider& execution_provider,
                                  bool skip_dequantize_linear,
                                  const InlinedHashSet<std::string_view>& compatible_execution_providers,
-                                 const InlinedHashSet<std::string>& excluded_initializers) noexcept
+                                 const InlinedHashSet<std::string>& excluded_initializers,
+                                 concurrency::ThreadPool* thread_pool,
+                                 double max_size_ratio) noexcept
     : GraphTransformer("ConstantFolding", compatible_execution_providers),
       skip_dequantize_linear_(skip_dequantize_linear),
       excluded_initializers_(excluded_initializers),
-      execution_provider_(execution_provider) {
+      execution_provider_(execution_provider),
+      thread_pool_(thread_pool),
+      max_size_ratio_(max_size_ratio) {
 }
 
+namespace {
+
+// A node being constant folded. The kernels of the pending folds are computed concurrently, then their outputs are
+// added to the graph in topological order.
+struct PendingFold {
+  Node* node;
+  std::unique_ptr<OptimizerExecutionFrame::Info> info;
+  std::unique_ptr<const OpKernel> kernel;
+  std::vector<int> fetch_mlvalue_idxs;
+  size_t input_size_in_bytes;
+  std::vector<OrtValue> fetches;
+  Status status;
+};
+
+// Returns the size in bytes of a tensor whose shape is known statically, or -1.
+int64_t GetStaticSizeInBytes(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  const auto* shape = node_arg.Shape();
+  if (type == nullptr || shape == nullptr || !utils::HasTensorType(*type) ||
+      type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED ||
+      type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+    return -1;
+  }
+
+  int64_t size = static_cast<int64_t>(
+      DataTypeImpl::TensorTypeFromONNXEnum(type->tensor_type().elem_type())->GetElementType()->Size());
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim)) {
+      return -1;
+    }
+    size *= dim.dim_value();
+  }
+  return size;
+}
+
+bool UsesOutputOf(const Node& node, const InlinedHashSet<NodeIndex>& producers) {
+  for (auto it = node.InputNodesBegin(), end = node.InputNodesEnd(); it != end; ++it) {
+    if (producers.count(it->Index()) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Removes a node converted to constants, along with the single-output node chains of its inputs.
+void RemoveFoldedNode(Graph& graph, Node& node) {
+  auto p_ip_node = node.InputNodesBegin();
+  const auto p_ip_node_end = node.InputNodesEnd();
+  while (p_ip_node != p_ip_node_end) {
+    const auto& input_node = *p_ip_node;
+    // Update the node iterator before removing the corresponding node because removing
+    // the node will invalidate the node iterator
+    ++p_ip_node;
+    graph_utils::RemoveNodesWithOneOutputBottomUp(graph, input_node);
+  }
+
+  // Remove the output edges of the constant node and then remove the node itself.
+  graph_utils::RemoveNodeOutputEdges(graph, node);
+  graph.RemoveNode(node.Index());
+}
+
+}  // namespace
+
 // We need to handle a Shape node separately as the input doesn't need to be a constant initializer for
 // Shape to be able to be constant folded.
 static bool ConstantFoldShapeNode(Graph& graph, Node& node) {
@@ -139,14 +207,105 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
   std::function<bool(const std::string&)> is_sparse_initializer_check = [&graph](const std::string& name) -> bool {
     return graph.IsSparseInitializer(name);
   };
+#else
+  std::function<bool(const std::string&)> is_sparse_initializer_check = [](const std::string&) { return false; };
 #endif
 
+  // Without a thread pool each fold is applied before moving to the next node.
+  const size_t max_pending_folds =
+      thread_pool_ != nullptr ? static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool_)) : 1;
+  std::vector<PendingFold> pending_folds;
+  InlinedHashSet<NodeIndex> pending_nodes;
+
+  const auto exceeds_size_ratio = [this](size_t input_size, size_t output_size) {
+    return max_size_ratio_ > 0.0 &&
+           static_cast<double>(output_size) > max_size_ratio_ * static_cast<double>(input_size);
+  };
+
+  const auto apply_pending_folds = [&]() -> Status {
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        thread_pool_, static_cast<std::ptrdiff_t>(pending_folds.size()),
+        [&pending_folds, &logger](std::ptrdiff_t fold_idx) {
+          auto& fold = pending_folds[fold_idx];
+          ORT_TRY {
+            OptimizerExecutionFrame frame(*fold.info, fold.fetch_mlvalue_idxs);
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable : 6387)
+#endif
+            OpKernelContext op_kernel_context(&frame, fold.kernel.get(), /*stream*/ nullptr, nullptr, logger);
+            fold.status = fold.kernel->Compute(&op_kernel_context);
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+            if (fold.status.IsOK()) {
+              fold.status = frame.GetOutputs(fold.fetches);
+            }
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              fold.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+            });
+          }
+        });
+
+    for (auto& fold : pending_folds) {
+      ORT_RETURN_IF_ERROR(fold.status);
+      Node& node = *fold.node;
+
+      // Go over all output node args and substitute them with the newly computed tensors, which will be
+      // added to the graph as initializers.
+      ORT_ENFORCE(fold.fetches.size() == node.OutputDefs().size());
+      size_t output_size = 0;
+      for (const auto& fetch : fold.fetches) {
+        output_size += fetch.Get<Tensor>().SizeInBytes();
+      }
+      if (exceeds_size_ratio(fold.input_size_in_bytes, output_size)) {
+        LOGS(logger, INFO) << "Not constant folding " << node.OpType() << " node '" << node.Name()
+                           << "' as its outputs are " << output_size << " bytes";
+        continue;
+      }
+
+      for (size_t fetch_idx = 0; fetch_idx < fold.fetches.size(); ++fetch_idx) {
+        OrtValue& ort_value = fold.fetches[fetch_idx];
+        // Build the TensorProto that corresponds to the computed OrtValue and add it as initializer to the graph.
+        auto* constant_arg_out = node.MutableOutputDefs()[fetch_idx];
+        const Tensor& out_tensor = ort_value.Get<Tensor>();
+        ONNX_NAMESPACE::TensorProto out_tensorproto = utils::TensorToTensorProto(out_tensor, constant_arg_out->Name());
+
+        ONNX_NAMESPACE::TensorShapeProto result_shape;
+        for (auto& dim : out_tensor.Shape().GetDims()) {
+          result_shape.add_dim()->set_dim_value(dim);
+        }
+
+        constant_arg_out->SetShape(result_shape);
+        graph.AddInitializedTensor(out_tensorproto);
+        // release the computed tensor as soon as it is copied to the graph
+        ort_value = OrtValue();
+      }
+
+      RemoveFoldedNode(graph, node);
+      modified = true;
+      have_updated_nodes = true;
+    }
+
+    pending_folds.clear();
+    pending_nodes.clear();
+    return Status::OK();
+  };
+
   for (NodeIndex i : order) {
     auto* node = graph.GetNode(i);
     if (!node) {
       continue;
     }
 
+    // A node that uses the output of a pending fold, or whose subgraphs may, is processed once the pending folds
+    // are applied, so the graph is updated in the same way as if the nodes were folded one by one.
+    if (!pending_nodes.empty() && (node->ContainsSubgraph() || UsesOutputOf(*node, pending_nodes))) {
+      ORT_RETURN_IF_ERROR(apply_pending_folds());
+    }
+
     ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
 
     // Updating a node may allow shape inferencing to infer output shapes of following nodes,
@@ -223,19 +382,14 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         }
       }
 
-#if !defined(DISABLE_SPARSE_TENSORS)
-      // Create execution frame for executing constant nodes.
-      OptimizerExecutionFrame::Info info({node}, constant_inputs, graph.ModelPath(), execution_provider_,
-                                         is_sparse_initializer_check);
-#else
       // Create execution frame for executing constant nodes.
-      OptimizerExecutionFrame::Info info({node}, constant_inputs, graph.ModelPath(), execution_provider_,
-                                         [](std::string const&) { return false; });
-#endif
+      auto info = std::make_unique<OptimizerExecutionFrame::Info>(std::vector<const Node*>{node}, constant_inputs,
+                                                                   graph.ModelPath(), execution_provider_,
+                                                                   is_sparse_initializer_check);
 
       std::vector<int> fetch_mlvalue_idxs;
       for (const auto* node_out : node->OutputDefs()) {
-        fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
+        fetch_mlvalue_idxs.push_back(info->GetMLValueIndex(node_out->Name()));
       }
 
       const bool node_on_cpu_ep = node->GetExecutionProviderType() == kCpuExecutionProvider;
@@ -250,12 +404,12 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         // override the EP assigned to the node so that it will use the CPU kernel for Compute.
         node->SetExecutionProviderType(kCpuExecutionProvider);
 
-        kernel = info.CreateKernel(node);
+        kernel = info->CreateKernel(node);
 
         // undo the EP change to the value that was assigned at graph partitioning time
         node->SetExecutionProviderType(ep_type);
       } else {
-        kernel = info.CreateKernel(node);
+        kernel = info->CreateKernel(node);
       }
 
       // We currently constant fold using the CPU EP only.
@@ -271,74 +425,54 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         continue;
       }
 
-      OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs);
-#ifdef _WIN32
-#pragma warning(push)
-#pragma warning(disable : 6387)
-#endif
-      OpKernelContext op_kernel_context(&frame, kernel.get(), /*stream*/ nullptr, nullptr, logger);
-      ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
-#ifdef _WIN32
-#pragma warning(pop)
-#endif
-
-      std::vector<OrtValue> fetches;
-      ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
-
-      // Go over all output node args and substitute them with the newly computed tensors, which will be
-      // added to the graph as initializers.
-      ORT_ENFORCE(fetches.size() == node->OutputDefs().size());
-      converted_to_constant = true;
-      for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-        const auto& constant_arg_out = *node->OutputDefs()[fetch_idx];
+      bool supported_outputs = true;
+      for (const auto* constant_arg_out : node->OutputDefs()) {
         // XXX: Add support for SparseTensors outputs when we have sparse outputs
-        if (!utils::HasTensorType(*constant_arg_out.TypeAsProto())) {
-          LOGS(logger, INFO) << "Unsupported output type of " << constant_arg_out.Type()
+        if (!utils::HasTensorType(*constant_arg_out->TypeAsProto())) {
+          LOGS(logger, INFO) << "Unsupported output type of " << constant_arg_out->Type()
                              << ". Can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
-          converted_to_constant = false;
+          supported_outputs = false;
           break;
         }
       }
+      if (!supported_outputs) {
+        continue;
+      }
 
-      if (converted_to_constant) {
-        for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-          OrtValue& ort_value = fetches[fetch_idx];
-          // Build the TensorProto that corresponds to the computed OrtValue and add it as initializer to the graph.
-          auto* constant_arg_out = node->MutableOutputDefs()[fetch_idx];
-          const Tensor& out_tensor = ort_value.Get<Tensor>();
-          ONNX_NAMESPACE::TensorProto out_tensorproto = utils::TensorToTensorProto(out_tensor, constant_arg_out->Name());
-
-          ONNX_NAMESPACE::TensorShapeProto result_shape;
-          for (auto& dim : out_tensor.Shape().GetDims()) {
-            result_shape.add_dim()->set_dim_value(dim);
-          }
-
-          constant_arg_out->SetShape(result_shape);
-          graph.AddInitializedTensor(out_tensorproto);
+      // Skip the nodes whose outputs are known to exceed the size budget without computing them.
+      size_t input_size = 0;
+      for (const auto& constant_input : constant_inputs) {
+        size_t size = 0;
+        if (utils::GetSizeInBytesFromTensorProto<0>(*constant_input.second, &size).IsOK()) {
+          input_size += size;
         }
       }
-    }
+      int64_t static_output_size = 0;
+      for (const auto* constant_arg_out : node->OutputDefs()) {
+        const int64_t size = GetStaticSizeInBytes(*constant_arg_out);
+        static_output_size = size < 0 || static_output_size < 0 ? -1 : static_output_size + size;
+      }
+      if (static_output_size >= 0 && exceeds_size_ratio(input_size, static_cast<size_t>(static_output_size))) {
+        LOGS(logger, INFO) << "Not constant folding " << node->OpType() << " node '" << node->Name()
+                           << "' as its outputs are " << static_output_size << " bytes";
+        continue;
+      }
 
-    if (converted_to_constant) {
-      // Remove single-output node chain for inputs of the node
-      auto p_ip_node = node->InputNodesBegin();
-      const auto p_ip_node_end = node->InputNodesEnd();
-      while (p_ip_node != p_ip_node_end) {
-        const auto& input_node = *p_ip_node;
-        // Update the node iterator before removing the corresponding node because removing
-        // the node will invalidate the node iterator
-        ++p_ip_node;
-        graph_utils::RemoveNodesWithOneOutputBottomUp(graph, input_node);
+      pending_nodes.insert(node->Index());
+      pending_folds.push_back(PendingFold{node, std::move(info), std::move(kernel), std::move(fetch_mlvalue_idxs),
+                                          input_size, {}, Status::OK()});
+      if (pending_folds.size() >= max_pending_folds) {
+        ORT_RETURN_IF_ERROR(apply_pending_folds());
       }
+    }
 
-      // Remove the output edges of the constant node and then remove the node itself.
-      graph_utils::RemoveNodeOutputEdges(graph, *node);
-      graph.RemoveNode(node->Index());
+    if (converted_to_constant) {
+      RemoveFoldedNode(graph, *node);
       modified = true;
       have_updated_nodes = true;
     }
   }
 
-  return Status::OK();
+  return apply_pending_folds();
 }
 }  // namespace onnxruntime
@@ -9,6 +9,9 @@
 #include "core/framework/execution_provider.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
 
 /**
 @class ConstantFolding
@@ -21,11 +24,16 @@ class ConstantFolding : public GraphTransformer {
   /*! Constant folding will not be applied to nodes that have one of initializers from excluded_initializers as input.
       For pre-training, the trainable weights are those initializers to be excluded.
       \param execution_provider Execution provider instance to execute constant folding.
+      \param thread_pool If not null, the independent nodes are computed concurrently on this thread pool.
+      \param max_size_ratio If positive, a node is not folded if the size of its outputs exceeds the size of its
+             constant inputs by more than this ratio, so folding does not grow the initializers of the model.
   */
   ConstantFolding(const IExecutionProvider& execution_provider,
                   bool skip_dequantize_linear,
                   const InlinedHashSet<std::string_view>& compatible_execution_providers = {},
-                  const InlinedHashSet<std::string>& excluded_initializers = {}) noexcept;
+                  const InlinedHashSet<std::string>& excluded_initializers = {},
+                  concurrency::ThreadPool* thread_pool = nullptr,
+                  double max_size_ratio = 0.0) noexcept;
 
  private:
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
@@ -33,6 +41,8 @@ class ConstantFolding : public GraphTransformer {
   bool skip_dequantize_linear_;
   const InlinedHashSet<std::string> excluded_initializers_;
   const IExecutionProvider& execution_provider_;
+  concurrency::ThreadPool* thread_pool_;
+  double max_size_ratio_;
 };
 
 }  // namespace onnxruntime
@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_chain_fusion.h"
+
+#include <algorithm>
+#include <array>
+
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+// Limits the size of a group so the registers of a tile of the fused kernel stay in cache.
+constexpr size_t kMaxGroupSize = 32;
+
+int32_t GetElementType(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return TensorProto_DataType_UNDEFINED;
+  }
+  return type->tensor_type().elem_type();
+}
+
+bool IsFloat(const NodeArg& node_arg) {
+  return GetElementType(node_arg) == TensorProto_DataType_FLOAT;
+}
+
+// Returns true if the node is an elementwise node producing float values that FusedElementwise can compute.
+bool IsFusible(const Node& node, const InlinedHashSet<std::string_view>& compatible_providers) {
+  if (!graph_utils::IsSupportedProvider(node, compatible_providers) || node.OutputDefs().size() != 1 ||
+      !IsFloat(*node.OutputDefs()[0])) {
+    return false;
+  }
+
+  const auto& inputs = node.InputDefs();
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14})) {
+    return inputs.size() == 2 && IsFloat(*inputs[0]) && IsFloat(*inputs[1]);
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9, 13})) {
+    return inputs.size() == 1 && IsFloat(*inputs[0]);
+  }
+
+  // the condition is never produced in the group, as no fusible node produces bool values
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Where", {9, 16})) {
+    return inputs.size() == 3 && GetElementType(*inputs[0]) == TensorProto_DataType_BOOL &&
+           IsFloat(*inputs[1]) && IsFloat(*inputs[2]);
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9, 13, 19})) {
+    const auto input_type = GetElementType(*inputs[0]);
+    return input_type == TensorProto_DataType_FLOAT || input_type == TensorProto_DataType_BOOL;
+  }
+
+  return false;
+}
+
+}  // namespace
+
+/**
+Each group grows from the node producing its value, the root, by adding the producers of the inputs of the group
+whose output is only consumed by the group. The nodes are visited from the graph outputs to the graph inputs, so
+a node becomes a root only if its consumers could not take it in their group.
+*/
+Status ElementwiseChainFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                         const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedHashMap<NodeIndex, size_t> topological_positions;
+  topological_positions.reserve(node_topology_list.size());
+  for (size_t i = 0; i < node_topology_list.size(); ++i) {
+    topological_positions[node_topology_list[i]] = i;
+  }
+
+  InlinedHashSet<NodeIndex> visited;
+  for (auto it = node_topology_list.rbegin(); it != node_topology_list.rend(); ++it) {
+    auto* p_node = graph.GetNode(*it);
+    if (p_node == nullptr) continue;  // node was removed
+
+    Node& root = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(root, modified, graph_level, logger));
+
+    if (!visited.insert(root.Index()).second || !IsFusible(root, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    InlinedVector<Node*> group{&root};
+    InlinedHashSet<NodeIndex> group_indices{root.Index()};
+    for (size_t i = 0; i < group.size() && group.size() < kMaxGroupSize; ++i) {
+      for (auto edge = group[i]->InputEdgesBegin(), end = group[i]->InputEdgesEnd(); edge != end; ++edge) {
+        Node& producer = *graph.GetNode(edge->GetNode().Index());
+        if (visited.count(producer.Index()) > 0 || !IsFusible(producer, GetCompatibleExecutionProviders()) ||
+            producer.GetExecutionProviderType() != root.GetExecutionProviderType() ||
+            graph.NodeProducesGraphOutput(producer)) {
+          continue;
+        }
+
+        // a producer with consumers outside of the group is added by a later consumer or stays out of the group
+        bool consumed_by_group = true;
+        for (auto output_edge = producer.OutputEdgesBegin(), output_end = producer.OutputEdgesEnd();
+             output_edge != output_end; ++output_edge) {
+          consumed_by_group = consumed_by_group && group_indices.count(output_edge->GetNode().Index()) > 0;
+        }
+        if (!consumed_by_group) {
+          continue;
+        }
+
+        visited.insert(producer.Index());
+        group_indices.insert(producer.Index());
+        group.push_back(&producer);
+        if (group.size() == kMaxGroupSize) {
+          break;
+        }
+      }
+    }
+
+    if (group.size() < 2) {
+      continue;
+    }
+
+    // the root is the last node of the group in topological order
+    std::sort(group.begin(), group.end(), [&topological_positions](const Node* a, const Node* b) {
+      return topological_positions[a->Index()] < topological_positions[b->Index()];
+    });
+
+    // the registers of the values produced by the group follow the registers of the inputs of the group
+    InlinedHashMap<const NodeArg*, int64_t> registers;
+    InlinedVector<NodeArg*> fused_inputs;
+    for (Node* node : group) {
+      for (NodeArg* input : node->MutableInputDefs()) {
+        const Node* producer = graph.GetProducerNode(input->Name());
+        if ((producer == nullptr || group_indices.count(producer->Index()) == 0) &&
+            registers.emplace(input, static_cast<int64_t>(fused_inputs.size())).second) {
+          fused_inputs.push_back(input);
+        }
+      }
+    }
+
+    std::vector<std::string> ops;
+    std::vector<int64_t> operands;
+    ops.reserve(group.size());
+    operands.reserve(group.size() * 3);
+    for (Node* node : group) {
+      ops.push_back(node->OpType());
+      const auto& inputs = node->InputDefs();
+      for (size_t i = 0; i < 3; ++i) {
+        operands.push_back(i < inputs.size() ? registers.at(inputs[i]) : -1);
+      }
+      registers[node->OutputDefs()[0]] = static_cast<int64_t>(fused_inputs.size() + ops.size() - 1);
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedElementwise"), "FusedElementwise",
+                                     "fused elementwise chain", fused_inputs,
+                                     std::array{root.MutableOutputDefs()[0]}, nullptr, kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+    fused_node.AddAttribute("operands", operands);
+    fused_node.SetExecutionProviderType(root.GetExecutionProviderType());
+
+    for (int i = 0; i < static_cast<int>(fused_inputs.size()); ++i) {
+      const std::string& input_name = fused_inputs[i]->Name();
+      if (const Node* producer = graph.GetProducerNode(input_name)) {
+        graph.AddEdge(producer->Index(), fused_node.Index(),
+                      graph_utils::GetNodeOutputIndexFromOutputName(*producer, input_name), i);
+      }
+    }
+
+    graph_utils::ReplaceDownstreamNodeInput(graph, root, 0, fused_node, 0);
+    for (Node* node : group) {
+      graph_utils::RemoveNodeOutputEdges(graph, *node);
+    }
+    for (Node* node : group) {
+      graph.RemoveNode(node->Index());
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
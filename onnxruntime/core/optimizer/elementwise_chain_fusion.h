@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseChainFusion
+
+Fuse each maximal group of float elementwise nodes (Add, Sub, Mul, Div, Relu, Neg, Sigmoid, Tanh, Erf, Where and
+Cast to float) that produces a single value into a FusedElementwise node, which computes the group in one pass over
+its output instead of writing and reading back every intermediate value.
+
+It runs after the pattern specific fusions, so these take precedence.
+*/
+class ElementwiseChainFusion : public GraphTransformer {
+ public:
+  ElementwiseChainFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseChainFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <deque>
+#include <utility>
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/nchwc_transformer.h"
@@ -1218,14 +1219,228 @@ void NchwcTransformerImpl::Finalize(bool& modified) {
   }
 }
 
+// Estimates whether converting each region of connected nodes to NCHWc pays
+// off. The costs are in multiply-adds: a NCHWc convolution is estimated to save
+// a fraction of the multiply-adds of the NCHW convolution, and reordering a
+// tensor to or from NCHWc to cost a number of multiply-adds per element.
+class NchwcCostModel {
+ public:
+  NchwcCostModel(const Graph& graph) noexcept : graph_(graph) {}
+
+  // Returns the nodes of the regions estimated to be slower in NCHWc than in
+  // NCHW.
+  InlinedHashSet<NodeIndex> FindNchwNodes(const GraphViewer& graph_viewer);
+
+ private:
+  static constexpr double kConvSavedFraction = 0.25;
+  static constexpr double kReorderCostPerElement = 8.0;
+
+  struct Region {
+    double savings_{0.0};
+    double reorder_cost_{0.0};
+    bool has_unknown_shape_{false};
+  };
+
+  const ONNX_NAMESPACE::TensorProto* GetConvWeights(const Node& node) const;
+  NodeIndex FindRoot(NodeIndex index);
+  bool IsInRegion(const Node* node, NodeIndex root);
+  static void AddReorderCost(Region& region, const NodeArg& node_arg);
+
+  const Graph& graph_;
+
+  // Parent of each node in the union-find forest of the regions.
+  InlinedHashMap<NodeIndex, NodeIndex> parents_;
+};
+
+const ONNX_NAMESPACE::TensorProto* NchwcCostModel::GetConvWeights(const Node& node) const {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11}) &&
+      !graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain)) {
+    return nullptr;
+  }
+
+  const ONNX_NAMESPACE::TensorProto* conv_W_tensor_proto = nullptr;
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() < 2 ||
+      !graph_utils::NodeArgIsConstant(graph_, *input_defs[1]) ||
+      !graph_.GetInitializedTensor(input_defs[1]->Name(), conv_W_tensor_proto) ||
+      (conv_W_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+      (conv_W_tensor_proto->dims_size() != 4)) {
+    return nullptr;
+  }
+  return conv_W_tensor_proto;
+}
+
+NodeIndex NchwcCostModel::FindRoot(NodeIndex index) {
+  NodeIndex root = index;
+  while (parents_[root] != root) {
+    root = parents_[root];
+  }
+  while (parents_[index] != root) {
+    index = std::exchange(parents_[index], root);
+  }
+  return root;
+}
+
+bool NchwcCostModel::IsInRegion(const Node* node, NodeIndex root) {
+  return node != nullptr && parents_.count(node->Index()) != 0 && FindRoot(node->Index()) == root;
+}
+
+void NchwcCostModel::AddReorderCost(Region& region, const NodeArg& node_arg) {
+  const auto* shape = node_arg.Shape();
+  if (shape == nullptr) {
+    region.has_unknown_shape_ = true;
+    return;
+  }
+
+  // Symbolic dimensions count as one, as the batch and spatial dimensions
+  // scale the savings and the reorder costs of a region alike.
+  double element_count = 1.0;
+  for (const auto& dim : shape->dim()) {
+    if (utils::HasDimValue(dim)) {
+      element_count *= static_cast<double>(dim.dim_value());
+    }
+  }
+  region.reorder_cost_ += element_count * kReorderCostPerElement;
+}
+
+InlinedHashSet<NodeIndex> NchwcCostModel::FindNchwNodes(const GraphViewer& graph_viewer) {
+  const auto& node_indices = graph_viewer.GetNodesInTopologicalOrder();
+
+  // Group the nodes that may be converted to NCHWc into regions. Convolutions
+  // and pools start a region or join the region of their input, while the other
+  // nodes are only converted if their inputs are produced in NCHWc.
+  for (auto index : node_indices) {
+    const auto& node = *graph_.GetNode(index);
+    if (node.GetExecutionProviderType() != kCpuExecutionProvider) {
+      continue;
+    }
+
+    size_t region_input_count;
+    bool starts_region = false;
+    if (GetConvWeights(node) != nullptr ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {1, 8, 10, 11, 12}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {1, 7, 10, 11})) {
+      region_input_count = 1;
+      starts_region = true;
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {6, 8, 13}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11, 13})) {
+      region_input_count = node.InputDefs().size();
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9, 14}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Upsample", {9, 13}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Resize", {10, 11, 13}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalMaxPool", {1}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", {1})) {
+      region_input_count = 1;
+    } else {
+      continue;
+    }
+
+    InlinedVector<NodeIndex> producer_indices;
+    const auto& input_defs = node.InputDefs();
+    for (size_t i = 0; i < region_input_count && i < input_defs.size(); i++) {
+      const Node* producer = graph_.GetProducerNode(input_defs[i]->Name());
+      if (producer != nullptr && parents_.count(producer->Index()) != 0) {
+        producer_indices.push_back(producer->Index());
+      }
+    }
+    if (!starts_region && (input_defs.empty() || producer_indices.size() != region_input_count)) {
+      continue;
+    }
+
+    parents_[index] = index;
+    for (auto producer_index : producer_indices) {
+      parents_[FindRoot(producer_index)] = index;
+    }
+  }
+
+  // Estimate the savings and the reorder costs of each region.
+  const int64_t nchwc_block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  InlinedHashMap<NodeIndex, Region> regions;
+  for (auto index : node_indices) {
+    if (parents_.count(index) == 0) {
+      continue;
+    }
+
+    const auto& node = *graph_.GetNode(index);
+    const NodeIndex root = FindRoot(index);
+    Region& region = regions[root];
+
+    const auto& input_defs = node.InputDefs();
+    const auto& output_defs = node.OutputDefs();
+    bool reorders_input = false;
+    if (const auto* conv_W_tensor_proto = GetConvWeights(node)) {
+      const auto* output_shape = output_defs[0]->Shape();
+      if (output_shape == nullptr) {
+        region.has_unknown_shape_ = true;
+      } else {
+        double multiply_adds = static_cast<double>(conv_W_tensor_proto->dims(1) *
+                                                   conv_W_tensor_proto->dims(2) *
+                                                   conv_W_tensor_proto->dims(3));
+        for (const auto& dim : output_shape->dim()) {
+          if (utils::HasDimValue(dim)) {
+            multiply_adds *= static_cast<double>(dim.dim_value());
+          }
+        }
+        region.savings_ += multiply_adds * kConvSavedFraction;
+      }
+
+      // A convolution with few input channels uses the NCHW input directly.
+      const auto* group_attr = graph_utils::GetNodeAttribute(node, "group");
+      const bool is_grouped = group_attr != nullptr && utils::HasInt(*group_attr) && group_attr->i() > 1;
+      reorders_input = is_grouped || conv_W_tensor_proto->dims(1) >= nchwc_block_size;
+    } else {
+      reorders_input = graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {1, 8, 10, 11, 12}) ||
+                       graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {1, 7, 10, 11});
+    }
+    if (reorders_input && !IsInRegion(graph_.GetProducerNode(input_defs[0]->Name()), root)) {
+      AddReorderCost(region, *input_defs[0]);
+    }
+
+    // The output is reordered if it is used outside of the region. A reorder
+    // to a Transpose node is not counted, as the transformer fuses the
+    // reorder with a transpose to NHWC.
+    bool reorders_output = graph_.NodeProducesGraphOutput(node);
+    for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+      if (it->GetSrcArgIndex() == 0 && !IsInRegion(&it->GetNode(), root) &&
+          it->GetNode().OpType() != "Transpose") {
+        reorders_output = true;
+      }
+    }
+    if (reorders_output) {
+      AddReorderCost(region, *output_defs[0]);
+    }
+  }
+
+  InlinedHashSet<NodeIndex> nchw_nodes;
+  for (auto index : node_indices) {
+    if (parents_.count(index) != 0) {
+      const Region& region = regions[FindRoot(index)];
+      if (!region.has_unknown_shape_ && region.reorder_cost_ > region.savings_) {
+        nchw_nodes.insert(index);
+      }
+    }
+  }
+  return nchw_nodes;
+}
+
 Status NchwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
   NchwcTransformerImpl impl(graph);
   GraphViewer graph_viewer(graph);
 
+  InlinedHashSet<NodeIndex> nchw_nodes;
+  if (use_cost_model_) {
+    nchw_nodes = NchwcCostModel(graph).FindNchwNodes(graph_viewer);
+  }
+
   for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
     auto& node = *graph.GetNode(index);
     ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
-    if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
+    if (node.GetExecutionProviderType() == kCpuExecutionProvider && nchw_nodes.count(index) == 0) {
       impl.Transform(node);
     }
   }
@@ -13,13 +13,20 @@ namespace onnxruntime {
 
 Transformer that optimizes the graph by using NCHWc nodes instead of NCHW nodes
 and inserts nodes to reorder tensors as needed.
+
+With the cost model enabled, the regions of connected nodes where the estimated
+cost of the reorders exceeds the estimated savings of the NCHWc convolutions are
+left in NCHW.
 */
 class NchwcTransformer : public GraphTransformer {
  public:
-  NchwcTransformer() noexcept : GraphTransformer("NchwcTransformer") {}
+  explicit NchwcTransformer(bool use_cost_model = false) noexcept
+      : GraphTransformer("NchwcTransformer"), use_cost_model_(use_cost_model) {}
 
  private:
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  bool use_cost_model_;
 };
 
 }  // namespace onnxruntime
@@ -91,6 +91,12 @@ struct ThreadOptions {
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
   int dynamic_block_base_ = 0;
+
+  // Use guided scheduling for the parallel loops on hybrid CPUs. See kOrtSessionOptionsConfigIntraOpGuidedScheduling.
+  bool guided_scheduling = false;
+
+  // Adapt the number of times a thread spins before blocking to the gaps between the work it receives.
+  bool adaptive_spinning = false;
 };
 
 std::ostream& operator<<(std::ostream& os, const LogicalProcessors&);
@@ -141,6 +147,11 @@ class Env {
 
   virtual std::vector<LogicalProcessors> GetDefaultThreadAffinities() const = 0;
 
+  /// \brief Returns the affinities of the physical cores that belong to a NUMA node,
+  /// in the same format as GetDefaultThreadAffinities.
+  /// Returns an empty vector if the node does not exist or the NUMA topology is not available on this platform.
+  virtual std::vector<LogicalProcessors> GetNumaNodeThreadAffinities(int /*numa_node*/) const { return {}; }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
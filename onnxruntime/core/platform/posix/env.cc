@@ -29,8 +29,12 @@ limitations under the License.
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <optional>
+#include <set>
+#include <string>
 #include <thread>
 #include <utility>  // for std::forward
 #include <vector>
@@ -47,6 +51,7 @@ limitations under the License.
 #include "core/common/gsl.h"
 #include "core/common/logging/logging.h"
 #include "core/common/narrow.h"
+#include "core/common/string_utils.h"
 #include "core/platform/scoped_resource.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 
@@ -328,6 +333,49 @@ class PosixEnv : public Env {
     return ret;
   }
 
+  std::vector<LogicalProcessors> GetNumaNodeThreadAffinities(int numa_node) const override {
+    std::vector<LogicalProcessors> ret;
+#if defined(__linux__)
+    if (numa_node < 0) {
+      return ret;
+    }
+
+    // the logical processors of a node are listed as ranges, e.g. "0-15,32-47"
+    std::ifstream cpulist_file("/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist");
+    std::string cpulist;
+    if (!cpulist_file || !std::getline(cpulist_file, cpulist)) {
+      return ret;
+    }
+
+    std::set<int> node_processors;
+    for (const auto range : utils::SplitString(cpulist, ",")) {
+      const auto bounds = utils::SplitString(range, "-");
+      const int first = std::atoi(std::string{bounds.front()}.c_str());
+      const int last = std::atoi(std::string{bounds.back()}.c_str());
+      for (int id = first; id <= last; ++id) {
+        node_processors.insert(id);
+      }
+    }
+
+    for (auto& core : GetDefaultThreadAffinities()) {
+      if (!core.empty() && std::all_of(core.begin(), core.end(),
+                                       [&](int id) { return node_processors.count(id) != 0; })) {
+        ret.push_back(std::move(core));
+      }
+    }
+
+    // without per core information fall back to one affinity per logical processor of the node
+    if (ret.empty()) {
+      for (int id : node_processors) {
+        ret.push_back(LogicalProcessors{id});
+      }
+    }
+#else
+    ORT_UNUSED_PARAMETER(numa_node);
+#endif
+    return ret;
+  }
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
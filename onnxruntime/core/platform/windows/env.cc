@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "core/platform/windows/env.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <optional>
@@ -260,6 +261,29 @@ std::vector<LogicalProcessors> WindowsEnv::GetDefaultThreadAffinities() const {
   return cores_.empty() ? std::vector<LogicalProcessors>(DefaultNumCores(), LogicalProcessors{}) : cores_;
 }
 
+std::vector<LogicalProcessors> WindowsEnv::GetNumaNodeThreadAffinities(int numa_node) const {
+  std::vector<LogicalProcessors> ret;
+  GROUP_AFFINITY node_affinity{};
+  if (numa_node < 0 || numa_node > USHRT_MAX ||
+      !GetNumaNodeProcessorMaskEx(static_cast<USHORT>(numa_node), &node_affinity)) {
+    return ret;
+  }
+
+  // keep the cores whose logical processors all belong to the group and mask of the node
+  constexpr KAFFINITY bit = 1;
+  for (const auto& core : cores_) {
+    const bool in_node = !core.empty() && std::all_of(core.begin(), core.end(), [&](int global_processor_id) {
+      const auto processor_info = GetProcessorAffinityMask(global_processor_id);
+      return processor_info.group_id == static_cast<int>(node_affinity.Group) &&
+             (node_affinity.Mask & (bit << processor_info.local_processor_id)) != 0;
+    });
+    if (in_node) {
+      ret.push_back(core);
+    }
+  }
+  return ret;
+}
+
 WindowsEnv& WindowsEnv::Instance() {
   static WindowsEnv default_env;
   return default_env;
@@ -24,6 +24,7 @@
 #include "core/providers/utils.h"
 
 #include "core/common/gsl.h"
+#include "core/common/safeint.h"
 
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -181,6 +182,18 @@ Loop::Info::Info(const onnxruntime::Node& node, const GraphViewer& subgraph_in)
     auto& output = subgraph_outputs[i];
     subgraph_output_names.push_back(output->Name());
   }
+
+  const Node* cond_producer = subgraph.GetProducerNode(subgraph_output_names[0]);
+  condition_is_loop_invariant =
+      subgraph_output_names[0] == subgraph_input_names[1] ||
+      (cond_producer != nullptr && cond_producer->OpType() == "Identity" &&
+       cond_producer->InputDefs()[0]->Name() == subgraph_input_names[1]);
+
+  loop_outputs_produced_by_nodes = true;
+  for (int i = num_loop_carried_vars + 1; i < num_subgraph_outputs; ++i) {
+    loop_outputs_produced_by_nodes = loop_outputs_produced_by_nodes &&
+                                     subgraph.GetProducerNode(subgraph_output_names[i]) != nullptr;
+  }
 }
 
 class LoopImpl {
@@ -204,12 +217,23 @@ class LoopImpl {
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
 
+  // when the number of iterations is known upfront the subgraph writes the loop outputs of each iteration directly
+  // into the Loop outputs, which are allocated from the shapes of the first iteration.
+  // this Loop output preallocation is the only per-iteration saving: loop carried values are already passed on
+  // without copies, and each iteration still executes the subgraph with a new execution frame.
+  void SetupPreallocatedOutputFetches(int64_t iter_num, std::vector<OrtValue>& fetches,
+                                      std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  // the part of a preallocated Loop output written by an iteration
+  OrtValue GetIterationSlice(Tensor& output, int64_t iter_num) const;
+
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
   const Loop::Info& info_;
 
   int64_t max_trip_count_;
   bool condition_;
+  bool num_iterations_known_ = false;
 
   const std::vector<const OrtValue*>& implicit_inputs_;
 
@@ -220,6 +244,9 @@ class LoopImpl {
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
 
+  // the Loop outputs for the loop outputs if num_iterations_known_. null until the first iteration allocates them.
+  std::vector<Tensor*> preallocated_outputs_;
+
   const Loop::ConcatOutput& concat_output_func_;
 };
 
@@ -422,6 +449,16 @@ Status LoopImpl::Initialize() {
 
   loop_output_tensors_.resize(static_cast<size_t>(info_.num_outputs) - info_.num_loop_carried_vars);
 
+  // a loop with a max trip count whose condition is initially true and never changes runs max_trip_count_
+  // iterations. when the subgraph computes the condition, e.g. to stop at an end token, the shape of the Loop
+  // outputs is only known once it has finished, and as a kernel output can't be reallocated the per-iteration
+  // outputs are still concatenated at the end.
+  num_iterations_known_ = max_trip_count_tensor != nullptr && condition_ && info_.condition_is_loop_invariant &&
+                          info_.loop_outputs_produced_by_nodes;
+  if (num_iterations_known_) {
+    preallocated_outputs_.resize(loop_output_tensors_.size(), nullptr);
+  }
+
   return status;
 }
 
@@ -453,6 +490,11 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
     next_inputs[i] = last_outputs[i - 1];
   }
 
+  if (num_iterations_known_) {
+    // the loop outputs were written to the Loop outputs
+    return;
+  }
+
   // save loop outputs as we have to concatenate at the end
   for (ptrdiff_t j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
     ORT_ENFORCE(last_outputs[j + 1].IsTensor(), "All scan outputs MUST be tensors");
@@ -480,11 +522,63 @@ Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_outp
   return Status::OK();
 }
 
+OrtValue LoopImpl::GetIterationSlice(Tensor& output, int64_t iter_num) const {
+  TensorShape slice_shape(output.Shape().GetDims().subspan(1));
+  const ptrdiff_t offset = SafeInt<ptrdiff_t>(slice_shape.Size()) * output.DataType()->Size() * iter_num;
+
+  OrtValue slice;
+  Tensor::InitOrtValue(output.DataType(), slice_shape, output.MutableDataRaw(), output.Location(), slice, offset);
+  return slice;
+}
+
+void LoopImpl::SetupPreallocatedOutputFetches(
+    int64_t iter_num, std::vector<OrtValue>& fetches,
+    std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  fetches.resize(info_.num_subgraph_outputs);
+
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    const size_t fetch_idx = static_cast<size_t>(i) + 1;  // skip cond
+    Tensor*& output = preallocated_outputs_[static_cast<size_t>(i) - info_.num_loop_carried_vars];
+
+    if (output != nullptr) {
+      fetches[fetch_idx] = GetIterationSlice(*output, iter_num);
+      continue;
+    }
+
+    // allocate the Loop output when the first iteration allocates its output, adding the iterations dimension.
+    fetch_allocators[fetch_idx] = [this, i, fetch_idx, &output, &fetches](const TensorShape& shape,
+                                                                          const OrtDevice& location,
+                                                                          OrtValue& ort_value, bool& allocated) {
+      TensorShapeVector dims;
+      dims.reserve(shape.NumDimensions() + 1);
+      dims.push_back(max_trip_count_);
+      for (const auto dim : shape.GetDims()) {
+        dims.push_back(dim);
+      }
+
+      output = context_.Output(i, TensorShape(dims));
+      ORT_RETURN_IF(output == nullptr, "Failed to allocate output ", i, " of Loop");
+
+      OrtValue slice = GetIterationSlice(*output, 0);
+      if (output->Location().device == location) {
+        ort_value = slice;
+        allocated = true;
+      } else {
+        // the copy logic in utils::ExecuteGraphImpl copies the output of the subgraph into it
+        fetches[fetch_idx] = slice;
+      }
+
+      return Status::OK();
+    };
+  }
+}
+
 Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
   auto status = Status::OK();
 
   std::vector<OrtValue> feeds;
   std::vector<OrtValue> fetches;
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
 
   CreateInitialFeeds(feeds);
 
@@ -494,9 +588,14 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
     if (iter_num_value != 0) {
       SaveOutputsAndUpdateFeeds(fetches, feeds);
       fetches.clear();
+      fetch_allocators.clear();
+    }
+
+    if (num_iterations_known_) {
+      SetupPreallocatedOutputFetches(iter_num_value, fetches, fetch_allocators);
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger(),
                                     context_.GetComputeStream(),
                                     // because the fetch[0] is the loop condition which we need to access on CPU,
@@ -504,6 +603,12 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
                                     true);
     ORT_RETURN_IF_ERROR(status);
 
+    if (num_iterations_known_) {
+      ORT_RETURN_IF(std::find(preallocated_outputs_.begin(), preallocated_outputs_.end(), nullptr) !=
+                        preallocated_outputs_.end(),
+                    "Loop subgraph did not allocate all the loop outputs.");
+    }
+
     condition_mlvalue_ = fetches[0];
 
     ++iter_num_value;
@@ -581,7 +686,7 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       ORT_RETURN_IF_ERROR(copy_mlvalue_to_output(fetches[static_cast<ptrdiff_t>(i) + 1], i, iter_num_value, *info_.loop_carried_vars_types[static_cast<ptrdiff_t>(i)]));  // skip cond
     }
 
-    for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    for (int i = info_.num_loop_carried_vars; i < info_.num_outputs && !num_iterations_known_; ++i) {
       // add last output
       auto& per_iteration_outputs = loop_output_tensors_[static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars];
       per_iteration_outputs.push_back(fetches[static_cast<ptrdiff_t>(i) + 1]);  // skip cond
@@ -38,6 +38,13 @@ class Loop : public controlflow::IControlFlowKernel {
     std::vector<std::string> subgraph_output_names;
 
     std::vector<const ONNX_NAMESPACE::TypeProto*> loop_carried_vars_types;
+
+    // true if the subgraph passes 'cond' through unchanged, so the number of iterations is the max trip count
+    // if 'cond' is initially true, and 0 otherwise
+    bool condition_is_loop_invariant;
+
+    // true if the loop outputs are produced by nodes of the subgraph, so they can be written in place
+    bool loop_outputs_produced_by_nodes;
   };
 
   // function to concatenate the OrtValue instances from each Loop iteration into a single output buffer.
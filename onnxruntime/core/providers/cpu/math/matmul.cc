@@ -168,9 +168,19 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const bool trans_a = trans_a_attr_ && a->Shape().NumDimensions() != 1;
   const bool trans_b = trans_b_attr_ && b_shape.NumDimensions() != 1;
 
-  MatMulComputeHelper helper;
-  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape, trans_a, trans_b, trans_batch_a_, trans_batch_b_));
-  Tensor* y = ctx->Output(0, helper.OutputShape());
+  // the broadcast plan only depends on the shapes, so it is cached for the hot shapes
+  const MatMulComputeHelper* helper = nullptr;
+  ORT_RETURN_IF_ERROR(ctx->GetShapeSpecializedState<MatMulComputeHelper>(
+      [&](MatMulComputeHelper& state) {
+        return state.Compute(a->Shape(), b_shape, trans_a, trans_b, trans_batch_a_, trans_batch_b_);
+      },
+      helper));
+  MatMulComputeHelper local_helper;
+  if (helper == nullptr) {
+    ORT_RETURN_IF_ERROR(local_helper.Compute(a->Shape(), b_shape, trans_a, trans_b, trans_batch_a_, trans_batch_b_));
+    helper = &local_helper;
+  }
+  Tensor* y = ctx->Output(0, helper->OutputShape());
 
   // Bail out early if the output is going to be empty
   if (y->Shape().Size() == 0)
@@ -180,21 +190,21 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const auto* b_data = b ? b->Data<float>() : nullptr;
   auto* y_data = y->MutableData<float>();
 
-  const size_t max_len = helper.OutputOffsets().size();
-  const size_t M = static_cast<size_t>(helper.M());
-  const size_t N = static_cast<size_t>(helper.N());
-  const size_t K = static_cast<size_t>(helper.K());
-  const size_t lda = helper.Lda(trans_a);
-  const size_t ldb = helper.Ldb(trans_b);
+  const size_t max_len = helper->OutputOffsets().size();
+  const size_t M = static_cast<size_t>(helper->M());
+  const size_t N = static_cast<size_t>(helper->N());
+  const size_t K = static_cast<size_t>(helper->K());
+  const size_t lda = helper->Lda(trans_a);
+  const size_t ldb = helper->Ldb(trans_b);
 
   std::vector<MLAS_SGEMM_DATA_PARAMS> data(max_len);
   for (size_t i = 0; i < max_len; i++) {
     data[i].BIsPacked = bool(packed_b_);
-    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].A = a_data + helper->LeftOffsets()[i];
     data[i].lda = lda;
-    data[i].B = data[i].BIsPacked ? (float*)packed_b_.get() : b_data + helper.RightOffsets()[i];
+    data[i].B = data[i].BIsPacked ? (float*)packed_b_.get() : b_data + helper->RightOffsets()[i];
     data[i].ldb = ldb;
-    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].C = y_data + helper->OutputOffsets()[i];
     data[i].ldc = N;
     data[i].alpha = alpha_attr_;
     data[i].beta = 0.0f;
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/ml/linear_common.h"
+
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/gemm.h"
+#include "core/providers/cpu/math/gemm_helper.h"
+
+namespace onnxruntime {
+namespace ml {
+
+LinearGemm::LinearGemm(const OpKernelInfo& info, std::vector<float> coefficients, ptrdiff_t num_targets)
+    : coefficients_(std::move(coefficients)), num_targets_(num_targets) {
+  if (num_targets_ <= 0 || coefficients_.empty() || coefficients_.size() % static_cast<size_t>(num_targets_) != 0) {
+    // leave it to Compute to handle any inconsistency with the input the same way as the unpacked GEMM
+    return;
+  }
+
+  const size_t N = static_cast<size_t>(num_targets_);
+  const size_t K = coefficients_.size() / N;
+  const size_t packed_size = MlasGemmPackBSize(N, K);
+  if (packed_size == 0) {
+    return;
+  }
+
+  AllocatorPtr alloc = info.GetAllocator(OrtMemType::OrtMemTypeDefault);
+  if (alloc == nullptr) {
+    return;
+  }
+
+  packed_coefficients_ = IAllocator::MakeUniquePtr<void>(alloc, packed_size, true);
+  memset(packed_coefficients_.get(), 0, packed_size);
+  MlasGemmPackB(CblasTrans, N, K, coefficients_.data(), K, packed_coefficients_.get());
+  packed_num_features_ = static_cast<ptrdiff_t>(K);
+}
+
+void LinearGemm::Compute(const float* input, ptrdiff_t num_rows, ptrdiff_t num_features,
+                         const std::vector<float>* intercepts, float* scores,
+                         concurrency::ThreadPool* threadpool) const {
+  TensorShape intercepts_shape({num_targets_});
+  const float* intercepts_data = intercepts != nullptr ? intercepts->data() : nullptr;
+  const TensorShape* intercepts_shape_ptr = intercepts != nullptr ? &intercepts_shape : nullptr;
+
+  if (packed_coefficients_ == nullptr || num_features != packed_num_features_) {
+    onnxruntime::Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                          num_rows, num_targets_, num_features,
+                                          1.f, input, coefficients_.data(), 1.f,
+                                          intercepts_data, intercepts_shape_ptr,
+                                          scores,
+                                          threadpool);
+    return;
+  }
+
+  if (num_rows == 0) {
+    return;
+  }
+
+  GemmBroadcastBias(num_rows, num_targets_, 1.f, intercepts_data, intercepts_shape_ptr, scores);
+  MlasGemm(CblasNoTrans,
+           static_cast<size_t>(num_rows),
+           static_cast<size_t>(num_targets_),
+           static_cast<size_t>(num_features),
+           1.f,
+           input,
+           static_cast<size_t>(num_features),
+           packed_coefficients_.get(),
+           intercepts_data != nullptr ? 1.f : 0.f,
+           scores,
+           static_cast<size_t>(num_targets_),
+           threadpool);
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
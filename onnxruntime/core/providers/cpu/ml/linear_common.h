@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// The GEMM shared by LinearClassifier and LinearRegressor, with broadcasting of intercepts
+// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Gemm
+//
+// X: [num_batches, num_features]
+// coefficients: [num_targets, num_features]
+// intercepts: optional [num_targets]
+// scores: X * coefficients^T + intercepts: [num_batches, num_targets]
+//
+// The coefficients are attributes so they are packed for MLAS once when the kernel is created.
+class LinearGemm {
+ public:
+  LinearGemm(const OpKernelInfo& info, std::vector<float> coefficients, ptrdiff_t num_targets);
+
+  const std::vector<float>& Coefficients() const { return coefficients_; }
+
+  // Computes the scores of num_rows rows of float input.
+  void Compute(const float* input, ptrdiff_t num_rows, ptrdiff_t num_features,
+               const std::vector<float>* intercepts, float* scores,
+               concurrency::ThreadPool* threadpool) const;
+
+  // Splits the batch into blocks of rows that are processed in parallel. For each block the input is
+  // converted to float if needed, the scores are computed and post_process(first_row, num_rows, block_scores,
+  // block_threadpool) is called while the block is still in cache. Batches with fewer blocks than threads are
+  // computed as a single block, with the threadpool.
+  template <typename T, typename PostProcess>
+  void ComputeBlocked(const T* input, ptrdiff_t num_batches, ptrdiff_t num_features,
+                      const std::vector<float>* intercepts, float* scores,
+                      concurrency::ThreadPool* threadpool, PostProcess&& post_process) const {
+    if (num_batches == 0 || num_targets_ == 0) {
+      return;
+    }
+
+    // aim for the input and scores of a block to fit in L1/L2 but keep enough rows for the GEMM kernels
+    constexpr ptrdiff_t kBlockElements = 8 * 1024;
+    constexpr ptrdiff_t kMinRowsPerBlock = 16;
+    const ptrdiff_t rows_per_block = std::max(kMinRowsPerBlock, kBlockElements / (num_features + num_targets_));
+    const ptrdiff_t num_blocks = (num_batches + rows_per_block - 1) / rows_per_block;
+
+    auto compute_block = [&](ptrdiff_t first_row, ptrdiff_t num_rows, concurrency::ThreadPool* block_threadpool) {
+      float* block_scores = scores + first_row * num_targets_;
+      const T* block_input = input + first_row * num_features;
+      if constexpr (std::is_same<T, float>::value) {
+        Compute(block_input, num_rows, num_features, intercepts, block_scores, block_threadpool);
+      } else {
+        std::vector<float> converted(static_cast<size_t>(num_rows * num_features));
+        std::transform(block_input, block_input + converted.size(), converted.begin(),
+                       [](T value) { return static_cast<float>(value); });
+        Compute(converted.data(), num_rows, num_features, intercepts, block_scores, block_threadpool);
+      }
+      post_process(first_row, num_rows, block_scores, block_threadpool);
+    };
+
+    if (num_blocks < concurrency::ThreadPool::DegreeOfParallelism(threadpool)) {
+      // too few blocks to keep the threads busy, so let the GEMM and the post processing parallelize internally
+      compute_block(0, num_batches, threadpool);
+      return;
+    }
+
+    concurrency::ThreadPool::TrySimpleParallelFor(threadpool, num_blocks, [&](std::ptrdiff_t block) {
+      const ptrdiff_t first_row = block * rows_per_block;
+      compute_block(first_row, std::min(rows_per_block, num_batches - first_row), nullptr);
+    });
+  }
+
+ private:
+  std::vector<float> coefficients_;
+  ptrdiff_t num_targets_;
+  // number of features the coefficients were packed for
+  ptrdiff_t packed_num_features_ = 0;
+  IAllocatorUniquePtr<void> packed_coefficients_;
+};
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -3,7 +3,6 @@
 
 #include "core/providers/cpu/ml/linearclassifier.h"
 #include "core/common/narrow.h"
-#include "core/providers/cpu/math/gemm.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -24,66 +23,79 @@ ONNX_CPU_OPERATOR_ML_KERNEL(
                               }),
     LinearClassifier);
 
+static std::vector<float> GetCoefficients(const OpKernelInfo& info) {
+  std::vector<float> coefficients;
+  if (!info.GetAttrs<float>("coefficients", coefficients).IsOK())
+    ORT_ENFORCE(!coefficients.empty());
+  return coefficients;
+}
+
 LinearClassifier::LinearClassifier(const OpKernelInfo& info)
     : OpKernel(info),
       multi_class_(info.GetAttrOrDefault<int64_t>("multi_class", 0)),
       post_transform_(MakeTransform(info.GetAttrOrDefault<std::string>("post_transform", "NONE"))),
       intercepts_(info.GetAttrsOrDefault<float>("intercepts")),
       classlabels_strings_(info.GetAttrsOrDefault<std::string>("classlabels_strings")),
-      classlabels_ints_(info.GetAttrsOrDefault<int64_t>("classlabels_ints")) {
-  if (!info.GetAttrs<float>("coefficients", coefficients_).IsOK())
-    ORT_ENFORCE(!coefficients_.empty());
-
+      classlabels_ints_(info.GetAttrsOrDefault<int64_t>("classlabels_ints")),
+      gemm_(info, GetCoefficients(info), static_cast<ptrdiff_t>(intercepts_.size())) {
   using_strings_ = !classlabels_strings_.empty();
   class_count_ = static_cast<ptrdiff_t>(intercepts_.size());
 }
 
-// Use GEMM for the calculations, with broadcasting of intercepts
-// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Gemm
-//
-// X: [num_batches, num_features]
-// coefficients_: [num_targets, num_features]
-// intercepts_: [num_targets]
-// scores: X * coefficients_^T + intercepts_: [num_batches, num_targets]
-void LinearClassifier::ComputeImpl(const gsl::span<const float> input,
+// The scores are computed by LinearGemm in blocks of rows. The labels and, unless a second class
+// has to be added, the post transform are applied to each block while its scores are in cache.
+template <typename T>
+void LinearClassifier::ComputeImpl(const T* input_data,
                                    ptrdiff_t num_batches, ptrdiff_t num_features, ptrdiff_t num_targets,
-                                   const std::vector<float>& coefficients,
                                    const std::vector<float>& intercepts,
                                    Tensor& labels_output, Tensor& scores_output,
                                    POST_EVAL_TRANSFORM post_transform,
                                    bool add_second_class,
                                    concurrency::ThreadPool* threadpool) const {
-  const float* input_data = input.data();
   auto scores_output_data = scores_output.MutableDataAsSpan<float>();
   size_t scores_output_size = SafeInt<size_t>(num_batches) * num_targets * (add_second_class ? 2 : 1);
   ORT_ENFORCE(scores_output_data.size() >= scores_output_size,
               "Scores output is incorrect size. Expected:", scores_output_size,
               " Found:", scores_output_data.size());
 
-  TensorShape intercepts_shape({num_targets});
-  onnxruntime::Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                        num_batches, num_targets, num_features,
-                                        1.f, input_data, coefficients.data(), 1.f,
-                                        intercepts.data(), &intercepts_shape,
-                                        scores_output_data.data(),
-                                        threadpool);
+  // adding the second class expands the scores in place so it has to run over the whole batch
+  const bool transform_blocks = post_transform != POST_EVAL_TRANSFORM::NONE && !add_second_class;
+
+  gemm_.ComputeBlocked(input_data, num_batches, num_features, &intercepts, scores_output_data.data(), threadpool,
+                       [&](ptrdiff_t first_row, ptrdiff_t num_rows, float* block_scores,
+                           concurrency::ThreadPool* block_threadpool) {
+                         SetLabels(first_row, num_rows, num_targets, block_scores, labels_output);
+                         if (transform_blocks) {
+                           ml::batched_update_scores_inplace(
+                               gsl::make_span(block_scores, SafeInt<size_t>(num_rows) * num_targets),
+                               num_rows, num_targets, post_transform, -1, false, block_threadpool);
+                         }
+                       });
+
+  if (add_second_class) {
+    ml::batched_update_scores_inplace(scores_output_data, num_batches, num_targets, post_transform,
+                                      1, false, threadpool);
+  }
+}
 
-  float* score = scores_output_data.data();
-  float* end_scores = score + (num_batches * num_targets);  // we haven't added extra targets yet so iterate the original scores
+void LinearClassifier::SetLabels(ptrdiff_t first_row, ptrdiff_t num_rows, ptrdiff_t num_targets,
+                                 const float* scores, Tensor& labels_output) const {
+  const float* score = scores;
+  const float* end_scores = score + (num_rows * num_targets);  // we haven't added extra targets yet so iterate the original scores
 
   if (num_targets == 1) {
     if (using_strings_) {
-      std::string* y_out = labels_output.MutableData<std::string>();
+      std::string* y_out = labels_output.MutableData<std::string>() + first_row;
       bool use_class_labels = classlabels_strings_.size() == 2;
-      std::string positive_label = use_class_labels ? classlabels_strings_[1] : "1";
-      std::string negative_label = use_class_labels ? classlabels_strings_[0] : "0";
+      const std::string positive_label = use_class_labels ? classlabels_strings_[1] : "1";
+      const std::string negative_label = use_class_labels ? classlabels_strings_[0] : "0";
 
       while (score < end_scores) {
         *y_out++ = (*score++ > 0) ? positive_label
                                   : negative_label;
       }
     } else {
-      int64_t* y_out = labels_output.MutableData<int64_t>();
+      int64_t* y_out = labels_output.MutableData<int64_t>() + first_row;
       bool use_class_labels = classlabels_ints_.size() == 2;
       int64_t positive_label = use_class_labels ? classlabels_ints_[1] : 1;
       int64_t negative_label = use_class_labels ? classlabels_ints_[0] : 0;
@@ -94,7 +106,7 @@ void LinearClassifier::ComputeImpl(const gsl::span<const float> input,
       }
     }
   } else {
-    for (int64_t i = 0; i < num_batches; ++i) {
+    for (ptrdiff_t i = first_row; i < first_row + num_rows; ++i) {
       int maxclass = 0;
       float maxweight = *score++;
 
@@ -112,24 +124,6 @@ void LinearClassifier::ComputeImpl(const gsl::span<const float> input,
       }
     }
   }
-
-  if (post_transform != POST_EVAL_TRANSFORM::NONE || add_second_class) {
-    ml::batched_update_scores_inplace(scores_output_data, num_batches, num_targets, post_transform,
-                                      add_second_class ? 1 : -1, false,
-                                      threadpool);
-  }
-}
-
-template <typename SrcType>
-static void CastInputToFloat(const Tensor& in, gsl::span<float>& out) {
-  size_t shape_size = static_cast<size_t>(in.Shape().Size());
-  ORT_ENFORCE(shape_size == out.size());
-
-  const SrcType* in_data = in.Data<SrcType>();
-  float* out_data = out.data();
-  for (size_t i = 0; i < shape_size; ++i) {
-    *out_data++ = static_cast<float>(*in_data++);
-  }
 }
 
 Status LinearClassifier::Compute(OpKernelContext* ctx) const {
@@ -160,47 +154,28 @@ Status LinearClassifier::Compute(OpKernelContext* ctx) const {
 
   concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
 
-  gsl::span<const float> input;
-  float* cast_buffer = nullptr;
-
+  // Inputs other than float are converted block by block inside the GEMM as output Z has type
+  // 'tensor(float)' and we have a fast GEMM implementation for float.
   auto element_type = X.GetElementType();
-  AllocatorPtr alloc;
-
-  if (element_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
-    input = X.DataAsSpan<float>();
-  } else {
-    // at some point we need to convert to float as output Z has type 'tensor(float)'.
-    // we have a fast GEMM implementation for float, so convert the input to float so we can use that.
-    auto status = ctx->GetTempSpaceAllocator(&alloc);
-    size_t num_elements = onnxruntime::narrow<size_t>(input_shape.Size());
-    cast_buffer = reinterpret_cast<float*>(alloc->AllocArray(num_elements, sizeof(float)));
-    auto cast_span = gsl::make_span<float>(cast_buffer, num_elements);
-
-    switch (element_type) {
-      case ONNX_NAMESPACE::TensorProto_DataType_INT32: {
-        CastInputToFloat<int32_t>(X, cast_span);
-        break;
-      }
-      case ONNX_NAMESPACE::TensorProto_DataType_INT64: {
-        CastInputToFloat<int64_t>(X, cast_span);
-        break;
-      }
-      case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE: {
-        CastInputToFloat<double>(X, cast_span);
-        break;
-      }
-      default:
-        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unsupported input element type of ", element_type);
-    }
-
-    input = cast_span;
-  }
-
-  ComputeImpl(input, num_batches, num_features, class_count_, coefficients_, intercepts_,
-              *Y, *Z, post_transform_, add_second_class, tp);
-
-  if (cast_buffer != nullptr) {
-    alloc->Free(cast_buffer);
+  switch (element_type) {
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+      ComputeImpl(X.Data<float>(), num_batches, num_features, class_count_, intercepts_,
+                  *Y, *Z, post_transform_, add_second_class, tp);
+      break;
+    case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+      ComputeImpl(X.Data<int32_t>(), num_batches, num_features, class_count_, intercepts_,
+                  *Y, *Z, post_transform_, add_second_class, tp);
+      break;
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+      ComputeImpl(X.Data<int64_t>(), num_batches, num_features, class_count_, intercepts_,
+                  *Y, *Z, post_transform_, add_second_class, tp);
+      break;
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+      ComputeImpl(X.Data<double>(), num_batches, num_features, class_count_, intercepts_,
+                  *Y, *Z, post_transform_, add_second_class, tp);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unsupported input element type of ", element_type);
   }
 
   return Status::OK();
@@ -7,6 +7,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
+#include "linear_common.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -17,8 +18,8 @@ class LinearClassifier final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  void ComputeImpl(const gsl::span<const float> input, ptrdiff_t num_batches, ptrdiff_t num_features, ptrdiff_t num_targets,
-                   const std::vector<float>& coefficients,
+  template <typename T>
+  void ComputeImpl(const T* input_data, ptrdiff_t num_batches, ptrdiff_t num_features, ptrdiff_t num_targets,
                    const std::vector<float>& intercepts,
                    Tensor& labels_output,
                    Tensor& scores_output,
@@ -26,14 +27,18 @@ class LinearClassifier final : public OpKernel {
                    bool add_second_class,
                    concurrency::ThreadPool* threadpool) const;
 
+  // Sets the labels of num_rows rows starting at first_row from their (untransformed) scores.
+  void SetLabels(ptrdiff_t first_row, ptrdiff_t num_rows, ptrdiff_t num_targets,
+                 const float* scores, Tensor& labels_output) const;
+
   int64_t multi_class_;
   ptrdiff_t class_count_;
   POST_EVAL_TRANSFORM post_transform_;
   bool using_strings_;
-  std::vector<float> coefficients_;
   std::vector<float> intercepts_;
   std::vector<std::string> classlabels_strings_;
   std::vector<int64_t> classlabels_ints_;
+  LinearGemm gemm_;
 };
 
 }  // namespace ml
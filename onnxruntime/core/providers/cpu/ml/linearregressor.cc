@@ -3,7 +3,6 @@
 
 #include "core/providers/cpu/ml/linearregressor.h"
 #include "core/common/narrow.h"
-#include "core/providers/cpu/math/gemm.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -17,54 +16,48 @@ ONNX_CPU_OPERATOR_ML_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     LinearRegressor);
 
+static int64_t GetNumTargets(const OpKernelInfo& info) {
+  int64_t num_targets = 0;
+  ORT_THROW_IF_ERROR(info.GetAttr<int64_t>("targets", &num_targets));
+  return num_targets;
+}
+
+static std::vector<float> GetCoefficients(const OpKernelInfo& info) {
+  std::vector<float> coefficients;
+  ORT_THROW_IF_ERROR(info.GetAttrs<float>("coefficients", coefficients));
+  return coefficients;
+}
+
 LinearRegressor::LinearRegressor(const OpKernelInfo& info)
     : OpKernel(info),
+      num_targets_(GetNumTargets(info)),
       intercepts_(info.GetAttrsOrDefault<float>("intercepts")),
-      post_transform_(MakeTransform(info.GetAttrOrDefault<std::string>("post_transform", "NONE"))) {
-  ORT_THROW_IF_ERROR(info.GetAttr<int64_t>("targets", &num_targets_));
-  ORT_THROW_IF_ERROR(info.GetAttrs<float>("coefficients", coefficients_));
-
+      post_transform_(MakeTransform(info.GetAttrOrDefault<std::string>("post_transform", "NONE"))),
+      gemm_(info, GetCoefficients(info), narrow<ptrdiff_t>(num_targets_)) {
   // use the intercepts_ if they're valid
   use_intercepts_ = intercepts_.size() == static_cast<size_t>(num_targets_);
 }
 
-// Use GEMM for the calculations, with broadcasting of intercepts
-// https://github.com/onnx/onnx/blob/main/docs/Operators.md#Gemm
-//
-// X: [num_batches, num_features]
-// coefficients_: [num_targets, num_features]
-// intercepts_: optional [num_targets].
-// Output: X * coefficients_^T + intercepts_: [num_batches, num_targets]
+// The scores are computed by LinearGemm in blocks of rows and the post transform is applied to each
+// block while it is in cache.
 template <typename T>
-static Status ComputeImpl(const Tensor& input, ptrdiff_t num_batches, ptrdiff_t num_features, ptrdiff_t num_targets,
-                          const std::vector<float>& coefficients,
+static Status ComputeImpl(const LinearGemm& gemm, const Tensor& input,
+                          ptrdiff_t num_batches, ptrdiff_t num_features, ptrdiff_t num_targets,
                           const std::vector<float>* intercepts, Tensor& output,
                           POST_EVAL_TRANSFORM post_transform,
                           concurrency::ThreadPool* threadpool) {
   const T* input_data = input.Data<T>();
   T* output_data = output.MutableData<T>();
 
-  if (intercepts != nullptr) {
-    TensorShape intercepts_shape({num_targets});
-    onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                      num_batches, num_targets, num_features,
-                                      1.f, input_data, coefficients.data(), 1.f,
-                                      intercepts->data(), &intercepts_shape,
-                                      output_data,
-                                      threadpool);
-  } else {
-    onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                      num_batches, num_targets, num_features,
-                                      1.f, input_data, coefficients.data(), 1.f,
-                                      nullptr, nullptr,
-                                      output_data,
-                                      threadpool);
-  }
-
-  if (post_transform != POST_EVAL_TRANSFORM::NONE) {
-    ml::batched_update_scores_inplace(gsl::make_span(output_data, SafeInt<size_t>(num_batches) * num_targets),
-                                      num_batches, num_targets, post_transform, -1, false, threadpool);
-  }
+  gemm.ComputeBlocked(input_data, num_batches, num_features, intercepts, output_data, threadpool,
+                      [&](ptrdiff_t /*first_row*/, ptrdiff_t num_rows, T* block_output,
+                          concurrency::ThreadPool* block_threadpool) {
+                        if (post_transform != POST_EVAL_TRANSFORM::NONE) {
+                          ml::batched_update_scores_inplace(
+                              gsl::make_span(block_output, SafeInt<size_t>(num_rows) * num_targets),
+                              num_rows, num_targets, post_transform, -1, false, block_threadpool);
+                        }
+                      });
 
   return Status::OK();
 }
@@ -90,7 +83,7 @@ Status LinearRegressor::Compute(OpKernelContext* ctx) const {
 
   switch (element_type) {
     case ONNX_NAMESPACE::TensorProto_DataType_FLOAT: {
-      status = ComputeImpl<float>(X, num_batches, num_features, narrow<ptrdiff_t>(num_targets_), coefficients_,
+      status = ComputeImpl<float>(gemm_, X, num_batches, num_features, narrow<ptrdiff_t>(num_targets_),
                                   use_intercepts_ ? &intercepts_ : nullptr,
                                   Y, post_transform_, tp);
 
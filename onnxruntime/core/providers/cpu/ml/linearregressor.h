@@ -7,6 +7,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
+#include "linear_common.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -18,10 +19,10 @@ class LinearRegressor final : public OpKernel {
 
  private:
   int64_t num_targets_;
-  std::vector<float> coefficients_;
   std::vector<float> intercepts_;
   bool use_intercepts_;
   POST_EVAL_TRANSFORM post_transform_;
+  LinearGemm gemm_;
 };
 
 }  // namespace ml
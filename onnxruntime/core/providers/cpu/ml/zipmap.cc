@@ -2,7 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/zipmap.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
+
+#include <algorithm>
+#include <numeric>
 /**
 https://github.com/onnx/onnx/blob/main/onnx/defs/traditionalml/defs.cc
 ONNX_OPERATOR_SCHEMA(ZipMap)
@@ -42,6 +46,53 @@ ZipMapOp::ZipMapOp(const OpKernelInfo& info)
   ORT_ENFORCE(classlabels_strings_.empty() ^ classlabels_int64s_.empty(),
               "Must provide classlabels_strings or classlabels_int64s but not both.");
   using_strings_ = !classlabels_strings_.empty();
+
+  auto init_sorted_indices = [this](const auto& labels) {
+    sorted_label_indices_.resize(labels.size());
+    std::iota(sorted_label_indices_.begin(), sorted_label_indices_.end(), size_t{0});
+    std::stable_sort(sorted_label_indices_.begin(), sorted_label_indices_.end(),
+                     [&labels](size_t a, size_t b) { return labels[a] < labels[b]; });
+    // keep the last occurrence of each duplicated label
+    std::vector<size_t> unique_indices;
+    unique_indices.reserve(sorted_label_indices_.size());
+    for (size_t i = 0; i < sorted_label_indices_.size(); ++i) {
+      if (i + 1 < sorted_label_indices_.size() &&
+          !(labels[sorted_label_indices_[i]] < labels[sorted_label_indices_[i + 1]])) {
+        continue;
+      }
+      unique_indices.push_back(sorted_label_indices_[i]);
+    }
+    sorted_label_indices_ = std::move(unique_indices);
+  };
+
+  if (using_strings_) {
+    init_sorted_indices(classlabels_strings_);
+  } else {
+    init_sorted_indices(classlabels_int64s_);
+  }
+}
+
+template <typename TKey>
+void ZipMapOp::ZipRows(const std::vector<TKey>& classlabels, const float* x_data, int64_t batch_size,
+                       std::vector<std::map<TKey, float>>& output, concurrency::ThreadPool* threadpool) const {
+  const size_t features_per_batch = classlabels.size();
+  output.resize(onnxruntime::narrow<size_t>(batch_size));
+
+  // each row allocates one tree node per class so the cost is dominated by the allocator rather than the copy
+  const double cost_per_row = static_cast<double>(features_per_batch) * 64.0;
+  concurrency::ThreadPool::TryParallelFor(
+      threadpool, onnxruntime::narrow<std::ptrdiff_t>(batch_size),
+      TensorOpCost{static_cast<double>(features_per_batch * sizeof(float)), cost_per_row, cost_per_row},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t n = first; n < last; ++n) {
+          const float* row = x_data + static_cast<size_t>(n) * features_per_batch;
+          std::map<TKey, float> row_map;
+          for (size_t idx : sorted_label_indices_) {
+            row_map.emplace_hint(row_map.end(), classlabels[idx], row[idx]);
+          }
+          output[static_cast<size_t>(n)] = std::move(row_map);
+        }
+      });
 }
 
 common::Status ZipMapOp::Compute(OpKernelContext* context) const {
@@ -77,17 +128,7 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     auto* y_data = context->Output<std::vector<std::map<std::string, float>>>(0);
     if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
 
-    // auto* y_data = Y->MutableData<std::vector<std::map<std::string, float>>>();
-    y_data->resize(onnxruntime::narrow<size_t>(batch_size));
-    int64_t current_weight_0 = 0;
-    for (int64_t n = 0; n < batch_size; n++) {
-      std::map<std::string, float> map1;
-      for (int64_t j = 0; j < features_per_batch; j++) {
-        map1[classlabels_strings_[onnxruntime::narrow<size_t>(j)]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[onnxruntime::narrow<size_t>(n)] = std::move(map1);
-    }
+    ZipRows(classlabels_strings_, x_data, batch_size, *y_data, context->GetOperatorThreadPool());
   } else {
     if (features_per_batch != static_cast<int64_t>(classlabels_int64s_.size())) {
       return Status(ONNXRUNTIME,
@@ -97,17 +138,8 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     }
     auto* y_data = context->Output<std::vector<std::map<std::int64_t, float>>>(0);
     if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
-    // auto* y_data = Y->MutableData<std::vector<std::map<int64_t, float>>>();
-    y_data->resize(onnxruntime::narrow<size_t>(batch_size));
-    int64_t current_weight_0 = 0;
-    for (int n = 0; n < batch_size; n++) {
-      std::map<int64_t, float> map2;
-      for (int j = 0; j < features_per_batch; j++) {
-        map2[classlabels_int64s_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map2);
-    }
+
+    ZipRows(classlabels_int64s_, x_data, batch_size, *y_data, context->GetOperatorThreadPool());
   }
   return common::Status::OK();
 }
@@ -4,6 +4,9 @@
 #pragma once
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+
+#include <map>
+
 namespace onnxruntime {
 namespace ml {
 
@@ -13,9 +16,18 @@ class ZipMapOp final : public OpKernel {
   common::Status Compute(OpKernelContext* context) const override;
 
  private:
+  template <typename TKey>
+  void ZipRows(const std::vector<TKey>& classlabels, const float* x_data, int64_t batch_size,
+               std::vector<std::map<TKey, float>>& output, concurrency::ThreadPool* threadpool) const;
+
   bool using_strings_;
   std::vector<int64_t> classlabels_int64s_;
   std::vector<std::string> classlabels_strings_;
+
+  // Indices into the class labels ordered by key. When a label is repeated only its last index is kept, matching
+  // the assignment semantics of the original per-element insertion. Inserting in key order lets every row's map be
+  // built with end-hinted insertions (amortized constant time, no key comparisons during rebalancing).
+  std::vector<size_t> sorted_label_indices_;
 };
 
 }  // namespace ml
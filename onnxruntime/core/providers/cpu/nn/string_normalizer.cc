@@ -17,6 +17,7 @@
 
 #endif  // _MSC_VER
 
+#include <cstring>
 #include <locale>
 #include <functional>
 #include <unordered_set>
@@ -67,6 +68,11 @@ class Locale {
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Locale);
 
+  wchar_t ChangeCase(StringNormalizer::CaseAction caseaction, wchar_t ch) const {
+    assert(caseaction != StringNormalizer::NONE);
+    return (caseaction == StringNormalizer::LOWER) ? ::_towlower_l(ch, loc_) : ::_towupper_l(ch, loc_);
+  }
+
   void ChangeCase(StringNormalizer::CaseAction caseaction,
                   std::wstring& wstr) const {
     assert(caseaction != StringNormalizer::NONE);
@@ -105,6 +111,11 @@ class Locale {
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Locale);
 
+  wchar_t ChangeCase(StringNormalizer::CaseAction caseaction, wchar_t ch) const {
+    assert(caseaction != StringNormalizer::NONE);
+    return (caseaction == StringNormalizer::LOWER) ? std::tolower(ch, loc_) : std::toupper(ch, loc_);
+  }
+
   void ChangeCase(StringNormalizer::CaseAction caseaction,
                   std::wstring& wstr) const {
     assert(caseaction != StringNormalizer::NONE);
@@ -128,20 +139,34 @@ using Utf8Converter = std::wstring_convert<std::codecvt_utf8<wchar_t>>;
 #else
 
 // All others (not Windows, Apple, or Android)
+// The iconv descriptors are opened on first use and reused for all the strings
+// converted by this instance, so an instance must not be shared between threads.
 class Utf8Converter {
  public:
   Utf8Converter(const std::string&, const std::wstring&) {}
 
-  std::wstring from_bytes(const std::string& s) const {
+  ~Utf8Converter() {
+    if (IsOpen(from_utf8_)) {
+      iconv_close(from_utf8_);
+    }
+    if (IsOpen(to_utf8_)) {
+      iconv_close(to_utf8_);
+    }
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Utf8Converter);
+
+  std::wstring from_bytes(const std::string& s) {
     std::wstring result;
     if (s.empty()) {
       return result;
     }
     // Order of arguments is to, from
-    auto icvt = iconv_open("WCHAR_T", "UTF-8");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
-      return wconv_error;
+    if (!IsOpen(from_utf8_)) {
+      from_utf8_ = iconv_open("WCHAR_T", "UTF-8");
+      if (!IsOpen(from_utf8_)) {
+        return wconv_error;
+      }
     }
 
     char* iconv_in = const_cast<char*>(s.c_str());
@@ -149,54 +174,66 @@ class Utf8Converter {
     // Temporary buffer assumes 1 byte to 1 wchar_t
     // to make sure it is enough.
     const size_t buffer_len = iconv_in_bytes * sizeof(wchar_t);
-    auto buffer = std::make_unique<char[]>(buffer_len);
-    char* iconv_out = buffer.get();
+    buffer_.resize(buffer_len);
+    char* iconv_out = buffer_.data();
     size_t iconv_out_bytes = buffer_len;
-    auto ret = iconv(icvt, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
+    // reset the conversion state in case a previous call failed midway
+    iconv(from_utf8_, nullptr, nullptr, nullptr, nullptr);
+    auto ret = iconv(from_utf8_, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
     if (static_cast<size_t>(-1) == ret) {
       result = wconv_error;
     } else {
       size_t converted_bytes = buffer_len - iconv_out_bytes;
       assert((converted_bytes % sizeof(wchar_t)) == 0);
-      result.assign(reinterpret_cast<const wchar_t*>(buffer.get()), converted_bytes / sizeof(wchar_t));
+      result.resize(converted_bytes / sizeof(wchar_t));
+      memcpy(result.data(), buffer_.data(), converted_bytes);
     }
-    iconv_close(icvt);
     return result;
   }
 
-  std::string to_bytes(const std::wstring& wstr) const {
+  std::string to_bytes(const std::wstring& wstr) {
     std::string result;
     if (wstr.empty()) {
       return result;
     }
     // Order of arguments is to, from
-    auto icvt = iconv_open("UTF-8", "WCHAR_T");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
-      return conv_error;
+    if (!IsOpen(to_utf8_)) {
+      to_utf8_ = iconv_open("UTF-8", "WCHAR_T");
+      if (!IsOpen(to_utf8_)) {
+        return conv_error;
+      }
     }
 
     // I hope this does not modify the incoming buffer
     wchar_t* non_const_in = const_cast<wchar_t*>(wstr.c_str());
     char* iconv_in = reinterpret_cast<char*>(non_const_in);
     size_t iconv_in_bytes = wstr.length() * sizeof(wchar_t);
-    // Temp buffer, assume every code point converts into 3 bytes, this should be enough
+    // Temp buffer, assume every code point converts into 4 bytes, this should be enough
     // We do not convert terminating zeros
-    const size_t buffer_len = wstr.length() * 3;
-    auto buffer = std::make_unique<char[]>(buffer_len);
+    const size_t buffer_len = wstr.length() * 4;
+    buffer_.resize(buffer_len);
 
-    char* iconv_out = buffer.get();
+    char* iconv_out = buffer_.data();
     size_t iconv_out_bytes = buffer_len;
-    auto ret = iconv(icvt, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
+    iconv(to_utf8_, nullptr, nullptr, nullptr, nullptr);
+    auto ret = iconv(to_utf8_, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
     if (static_cast<size_t>(-1) == ret) {
       result = conv_error;
     } else {
       size_t converted_len = buffer_len - iconv_out_bytes;
-      result.assign(buffer.get(), converted_len);
+      result.assign(buffer_.data(), converted_len);
     }
-    iconv_close(icvt);
     return result;
   }
+
+ private:
+  // CentOS is not happy with -1
+  static bool IsOpen(iconv_t icvt) { return icvt != kNotOpen && std::numeric_limits<iconv_t>::max() != icvt; }
+
+  static inline const iconv_t kNotOpen = reinterpret_cast<iconv_t>(static_cast<intptr_t>(-1));
+  iconv_t from_utf8_ = kNotOpen;
+  iconv_t to_utf8_ = kNotOpen;
+  std::vector<char> buffer_;
 };
 
 #endif
@@ -214,9 +251,80 @@ const std::string default_locale("en_US.UTF-8");  // All non-MS and not Apple
 
 #endif  // _MSC_VER
 
+// Returns true if the string consists of 7-bit ASCII characters only.
+// Checks 8 bytes at a time.
+inline bool IsAscii(const std::string& s) {
+  const char* p = s.data();
+  size_t len = s.size();
+  uint64_t acc = 0;
+  for (; len >= sizeof(uint64_t); p += sizeof(uint64_t), len -= sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(uint64_t));
+    acc |= word;
+  }
+  for (; len > 0; ++p, --len) {
+    acc |= static_cast<unsigned char>(*p);
+  }
+  return (acc & 0x8080808080808080ULL) == 0;
+}
+
+// Changes the case of UTF-8 strings.
+// ASCII strings are mapped directly in UTF-8 with lookup tables derived from the locale.
+// Other strings, or all strings if the locale maps some ASCII character outside of ASCII
+// (e.g. 'I' in Turkish locales), go through a wide character conversion.
+class CaseMapper {
+ public:
+  explicit CaseMapper(const std::string& locale_name) : locale_(locale_name) {
+    BuildAsciiTable(StringNormalizer::LOWER, ascii_lower_);
+    BuildAsciiTable(StringNormalizer::UPPER, ascii_upper_);
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CaseMapper);
+
+  // Writes str with the case changed into out. Returns false if str has invalid utf8 chars.
+  bool ChangeCase(StringNormalizer::CaseAction caseaction, const std::string& str, std::string& out,
+                  Utf8Converter& converter) const {
+    assert(caseaction != StringNormalizer::NONE);
+    const std::string& table = (caseaction == StringNormalizer::LOWER) ? ascii_lower_ : ascii_upper_;
+    if (!table.empty() && IsAscii(str)) {
+      out.resize(str.size());
+      std::transform(str.begin(), str.end(), out.begin(),
+                     [&table](char ch) { return table[static_cast<unsigned char>(ch)]; });
+      return true;
+    }
+
+    std::wstring wstr = converter.from_bytes(str);
+    if (wstr == wconv_error) {
+      return false;
+    }
+    // In place transform
+    locale_.ChangeCase(caseaction, wstr);
+    out = converter.to_bytes(wstr);
+    return true;
+  }
+
+ private:
+  void BuildAsciiTable(StringNormalizer::CaseAction caseaction, std::string& table) const {
+    table.resize(128);
+    for (size_t ch = 0; ch < table.size(); ++ch) {
+      const wchar_t mapped = locale_.ChangeCase(caseaction, static_cast<wchar_t>(ch));
+      if (static_cast<uint32_t>(mapped) >= table.size()) {
+        table.clear();
+        return;
+      }
+      table[ch] = static_cast<char>(mapped);
+    }
+  }
+
+  Locale locale_;
+  // Empty if the locale maps an ASCII character outside of ASCII
+  std::string ascii_lower_;
+  std::string ascii_upper_;
+};
+
 template <class ForwardIter>
 Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
-                      const Locale& loc,
+                      const CaseMapper& case_mapper,
                       Utf8Converter& converter,
                       size_t N, size_t C,
                       StringNormalizer::CaseAction caseaction) {
@@ -244,16 +352,12 @@ Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
   while (first != end) {
     auto& s = *first;
     if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
-      std::wstring wstr = converter.from_bytes(s);
-      if (wstr == wconv_error) {
+      if (!case_mapper.ChangeCase(caseaction, s, *(output_data + output_idx), converter)) {
         // Please do not include the input text in the error message as it could
         // be deemed as a compliance violation by teams using this operator
         return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                       "Input contains invalid utf8 chars");
       }
-      // In place transform
-      loc.ChangeCase(caseaction, wstr);
-      *(output_data + output_idx) = converter.to_bytes(wstr);
     } else {
       assert(caseaction == StringNormalizer::NONE);
       // Simple copy or move if the iterator points to a non-const string
@@ -295,26 +399,28 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
     compare_caseaction_ = (case_change_action_ == UPPER) ? UPPER : LOWER;
   }
 
-  locale_name_ = info.GetAttrOrDefault("locale", default_locale);
-  Locale locale(locale_name_);
+  case_mapper_ = std::make_unique<CaseMapper>(info.GetAttrOrDefault("locale", default_locale));
   Utf8Converter converter(conv_error, wconv_error);
 
   std::vector<std::string> swords = info.GetAttrsOrDefault<std::string>("stopwords");
+  stopwords_.reserve(swords.size());
   for (auto& sw : swords) {
     ORT_ENFORCE(!sw.empty(), "Empty stopwords not allowed");
     if (is_case_sensitive_) {
       auto p = stopwords_.insert(std::move(sw));
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     } else {
-      std::wstring wstr = converter.from_bytes(sw);
-      ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
-      locale.ChangeCase(compare_caseaction_, wstr);
-      auto p = wstopwords_.insert(std::move(wstr));
+      std::string cased;
+      ORT_ENFORCE(case_mapper_->ChangeCase(compare_caseaction_, sw, cased, converter),
+                  "Stopword contains invalid utf8 chars");
+      auto p = stopwords_.insert(std::move(cased));
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     }
   }
 }
 
+StringNormalizer::~StringNormalizer() = default;
+
 Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   using namespace string_normalizer;
 
@@ -343,7 +449,6 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   }
 
   Status status;
-  Locale locale(locale_name_);
   Utf8Converter converter(conv_error, wconv_error);
   auto* const input_data = X->Data<std::string>();
   using StrRef = std::reference_wrapper<const std::string>;
@@ -360,52 +465,57 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
         }
         ++first;
       }
-      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
+      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, *case_mapper_, converter,
                               N, filtered_strings.size(), case_change_action_);
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, *case_mapper_, converter, N, C, case_change_action_);
     }
   } else {
-    if (!wstopwords_.empty()) {
+    if (!stopwords_.empty()) {
       // Filter input. When no case action is required
       // we simply store original string references.
-      // Otherwise, we store converted strings.
+      // Otherwise, we store converted strings, which are moved to the output.
       InlinedVector<StrRef> filtered_orignal_strings;
       InlinedVector<std::string> filtered_cased_strings;
-      filtered_orignal_strings.reserve(C);
-      filtered_cased_strings.reserve(C);
+      if (case_change_action_ == NONE) {
+        filtered_orignal_strings.reserve(C);
+      } else {
+        filtered_cased_strings.reserve(C);
+      }
+      // Reused across the stopwords so that they are compared without allocating
+      std::string cased;
       auto first = input_data;
       auto const last = input_data + C;
       while (first != last) {
         const std::string& s = *first;
-        std::wstring wstr = converter.from_bytes(s);
-        if (wstr == wconv_error) {
+        if (!case_mapper_->ChangeCase(compare_caseaction_, s, cased, converter)) {
           // Please do not include the input text in the error message as it could
           // be deemed as a compliance violation by teams using this operator
           return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                         "Input contains invalid utf8 chars");
         }
-        locale.ChangeCase(compare_caseaction_, wstr);
-        if (0 == wstopwords_.count(wstr)) {
+        if (0 == stopwords_.count(cased)) {
           if (case_change_action_ == NONE) {
             filtered_orignal_strings.push_back(std::cref(s));
           } else {
-            filtered_cased_strings.push_back(converter.to_bytes(wstr));
+            // the compare case is the case change action, so the string compared is the output
+            filtered_cased_strings.push_back(std::move(cased));
+            cased.clear();
           }
         }
         ++first;
       }
       if (case_change_action_ == NONE) {
-        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
-                                N, filtered_orignal_strings.size(), NONE);
+        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, *case_mapper_,
+                                converter, N, filtered_orignal_strings.size(), NONE);
       } else {
-        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
-                                N, filtered_cased_strings.size(), NONE);
+        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, *case_mapper_,
+                                converter, N, filtered_cased_strings.size(), NONE);
       }
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, *case_mapper_, converter, N, C, case_change_action_);
     }
   }
   return status;
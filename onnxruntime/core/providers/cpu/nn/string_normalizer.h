@@ -6,11 +6,15 @@
 #include "core/common/inlined_containers.h"
 #include "core/framework/op_kernel.h"
 
-#include <locale>
+#include <memory>
 #include <string>
 
 namespace onnxruntime {
 
+namespace string_normalizer {
+class CaseMapper;
+}  // namespace string_normalizer
+
 class StringNormalizer : public OpKernel {
  public:
   enum CaseAction {
@@ -20,7 +24,7 @@ class StringNormalizer : public OpKernel {
   };
 
   explicit StringNormalizer(const OpKernelInfo& info);
-  ~StringNormalizer() override = default;
+  ~StringNormalizer() override;
 
   Status Compute(OpKernelContext* ctx) const override;
 
@@ -28,10 +32,9 @@ class StringNormalizer : public OpKernel {
   bool is_case_sensitive_;
   CaseAction case_change_action_;
   CaseAction compare_caseaction_;  // used for case-insensitive compare
-  std::string locale_name_;
-  // Either if these are populated but not both
+  std::unique_ptr<string_normalizer::CaseMapper> case_mapper_;
+  // UTF-8 stopwords. For case-insensitive compare they are stored after compare_caseaction_ is applied.
   InlinedHashSet<std::string> stopwords_;
-  InlinedHashSet<std::wstring> wstopwords_;
 };
 
 }  // namespace onnxruntime
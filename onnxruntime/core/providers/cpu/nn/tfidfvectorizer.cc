@@ -6,7 +6,10 @@
 #include "core/framework/tensor.h"
 #include "core/platform/threadpool.h"
 
+#include <algorithm>
 #include <functional>
+#include <limits>
+#include <map>
 #include <unordered_map>
 #include <core/common/safeint.h>
 
@@ -24,61 +27,106 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 namespace ngram_details {
 
-// NgrampPart implements a Trie like structure
-// for a unigram (1) it would insert into a root map with a valid id.
-// for (1,2,3) node 2 would be a child of 1 but have id == 0
-// because (1,2) does not exists. Node 3 would have a valid id.
-template <class T>
-struct NgramPart;
-
-template <>
-struct NgramPart<int64_t>;
+// NgramTrie is a flattened trie over integer tokens.
+// For a unigram (1) the root has a child with a valid id.
+// For (1,2,3) node 2 is a child of 1 but has id == 0
+// because (1,2) does not exist. Node 3 has a valid id.
+//
+// All nodes live in contiguous arrays: children of the root are found through a hash map
+// since there is typically one per vocabulary entry, while the (small) child lists of the inner
+// nodes are stored as sorted runs of a single edge array and searched in place.
+// String pools are interned to integer tokens first so both input kinds share the same trie.
+class NgramTrie {
+ public:
+  using NodeIndex = uint32_t;
+  static constexpr NodeIndex kRoot = 0;
+  static constexpr NodeIndex kNoNode = std::numeric_limits<NodeIndex>::max();
+
+  NgramTrie() : ngram_ids_(1, 0) {}
+
+  bool Empty() const noexcept { return ngram_ids_.size() == 1; }
+
+  // Adds ngram_size tokens starting at first and assigns the ngram_id to the last node.
+  template <class ForwardIter>
+  void Insert(ForwardIter first, size_t ngram_size, size_t ngram_id) {
+    NodeIndex node = kRoot;
+    for (size_t n = 0; n < ngram_size; ++n, ++first) {
+      auto p = build_edges_.emplace(std::make_pair(node, static_cast<int64_t>(*first)),
+                                    static_cast<NodeIndex>(ngram_ids_.size()));
+      if (p.second) {
+        ORT_ENFORCE(ngram_ids_.size() < kNoNode, "Too many n-gram nodes");
+        ngram_ids_.push_back(0);
+      }
+      node = p.first->second;
+    }
+    ORT_ENFORCE(ngram_ids_[node] == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
+    ngram_ids_[node] = ngram_id;
+  }
 
-template <>
-struct NgramPart<std::string>;
+  // Converts the build time edge map into the flat lookup structures.
+  void Finalize() {
+    edge_offsets_.assign(ngram_ids_.size() + 1, 0);
+    edge_tokens_.reserve(build_edges_.size());
+    edge_targets_.reserve(build_edges_.size());
+    // build_edges_ is ordered by (parent, token) so every node's children form a sorted run
+    for (const auto& edge : build_edges_) {
+      const NodeIndex parent = edge.first.first;
+      if (parent == kRoot) {
+        root_children_.emplace(edge.first.second, edge.second);
+      } else {
+        ++edge_offsets_[parent + 1];
+        edge_tokens_.push_back(edge.first.second);
+        edge_targets_.push_back(edge.second);
+      }
+    }
+    for (size_t i = 1; i < edge_offsets_.size(); ++i) {
+      edge_offsets_[i] += edge_offsets_[i - 1];
+    }
+    build_edges_.clear();
+  }
 
-using NgramPartInt = NgramPart<int64_t>;
-using NgramPartString = NgramPart<std::string>;
+  NodeIndex Find(NodeIndex node, int64_t token) const {
+    if (node == kRoot) {
+      auto hit = root_children_.find(token);
+      return hit == root_children_.end() ? kNoNode : hit->second;
+    }
+    const auto* begin = edge_tokens_.data() + edge_offsets_[node];
+    const auto* end = edge_tokens_.data() + edge_offsets_[node + 1];
+    const auto* hit = std::lower_bound(begin, end, token);
+    if (hit == end || *hit != token) {
+      return kNoNode;
+    }
+    return edge_targets_[static_cast<size_t>(hit - edge_tokens_.data())];
+  }
 
-// Avoid recursive class definitions using unique_ptr + forward declaration
-using IntMap = std::unordered_map<int64_t, std::unique_ptr<NgramPartInt>>;
+  bool HasChildren(NodeIndex node) const {
+    return node == kRoot ? !root_children_.empty() : edge_offsets_[node] != edge_offsets_[node + 1];
+  }
 
-using StrMap = std::unordered_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                  std::hash<std::string>, std::equal_to<std::string>>;
+  // 0 - means no entry, search for a bigger N
+  size_t NgramId(NodeIndex node) const { return ngram_ids_[node]; }
 
-template <>
-struct NgramPart<int64_t> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  IntMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
+ private:
+  std::vector<size_t> ngram_ids_;
+  std::unordered_map<int64_t, NodeIndex> root_children_;
+  std::vector<size_t> edge_offsets_;
+  std::vector<int64_t> edge_tokens_;
+  std::vector<NodeIndex> edge_targets_;
+  std::map<std::pair<NodeIndex, int64_t>, NodeIndex> build_edges_;
 };
 
-template <>
-struct NgramPart<std::string> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  StrMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
-};
+// Maps pool_strings entries to the integer tokens used in the trie
+using StrTokenMap = std::unordered_map<std::reference_wrapper<const std::string>, int64_t,
+                                       std::hash<std::string>, std::equal_to<std::string>>;
 
 // Returns next ngram_id
-template <class K, class ForwardIter, class Map>
+template <class ForwardIter>
 inline size_t PopulateGrams(ForwardIter first, size_t ngrams, size_t ngram_size, size_t ngram_id,
-                            Map& c) {
+                            NgramTrie& trie) {
   for (; ngrams > 0; --ngrams) {
-    size_t n = 1;
-    Map* m = &c;
-    while (true) {
-      auto p = m->emplace(*first, std::make_unique<NgramPart<K>>(0));
-      ++first;
-      if (n == ngram_size) {
-        ORT_ENFORCE(p.first->second->id_ == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
-        p.first->second->id_ = ngram_id;
-        ++ngram_id;
-        break;
-      }
-      ++n;
-      m = &p.first->second->leafs_;
-    }
+    trie.Insert(first, ngram_size, ngram_id);
+    first += ngram_size;
+    ++ngram_id;
   }
   return ngram_id;
 }
@@ -128,11 +176,12 @@ struct TfIdfVectorizer::Impl {
   gsl::span<const int64_t> ngram_indexes_;
   gsl::span<const float> weights_;
 
-  // This map contains references to pool_string_ entries
-  // of pool_strings attribute
-  StrMap str_map_;
-  // This map contains pool_int64s entries
-  IntMap int64_map_;
+  // This map contains references to pool_strings entries
+  // and the tokens they were interned to
+  StrTokenMap str_tokens_;
+  bool pool_is_string_ = false;
+  // Contains the n-grams of the pool
+  NgramTrie trie_;
 
   size_t output_size_ = 0;
 
@@ -215,6 +264,17 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
     ORT_ENFORCE(status.IsOK() && !pool_int64s.empty(), "non-empty pool_int64s is required if pool_strings not provided");
   }
 
+  // Intern the string pool so strings are matched as integer tokens
+  std::vector<int64_t> pool_string_tokens;
+  impl_->pool_is_string_ = !pool_strings.empty();
+  if (impl_->pool_is_string_) {
+    pool_string_tokens.reserve(pool_strings.size());
+    for (const auto& str : pool_strings) {
+      auto p = impl_->str_tokens_.emplace(str, static_cast<int64_t>(impl_->str_tokens_.size()));
+      pool_string_tokens.push_back(p.first->second);
+    }
+  }
+
   // Iterator via the pool. Insert 1 item for 1-grams, 2 items for 2-grams, etc.
   const auto total_items = (pool_strings.empty()) ? pool_int64s.size() : pool_strings.size();
   size_t ngram_id = 1;  // start with 1, 0 - means no n-gram
@@ -235,9 +295,9 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
         if (pool_strings.empty()) {
-          ngram_id = PopulateGrams<int64_t>(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_map_);
+          ngram_id = PopulateGrams(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->trie_);
         } else {
-          ngram_id = PopulateGrams<std::string>(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_map_);
+          ngram_id = PopulateGrams(pool_string_tokens.cbegin() + start_idx, ngrams, ngram_size, ngram_id, impl_->trie_);
         }
       } else {
         ngram_id += ngrams;
@@ -245,73 +305,53 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
     }
     ++ngram_size;
   }
+  impl_->trie_.Finalize();
 }
 
 TfIdfVectorizer::~TfIdfVectorizer() = default;
 
-void TfIdfVectorizer::ComputeImpl(const void* x_data_raw, size_t elem_size, ptrdiff_t row_num, size_t row_size,
-                                  bool is_input_string, gsl::span<float> output_data,
+template <typename T>
+void TfIdfVectorizer::ComputeImpl(const T* row_begin, size_t row_size, gsl::span<float> output_data,
                                   std::function<void(size_t, gsl::span<float>&)>& fn_weight) const {
-  const void* const row_begin = AdvanceElementPtr(x_data_raw, row_num * row_size, elem_size);
-  const void* const row_end = AdvanceElementPtr(row_begin, row_size, elem_size);
+  const T* const row_end = row_begin + row_size;
 
   const auto& impl = *impl_;
+  const auto& trie = impl.trie_;
   const auto max_gram_length = impl.max_gram_length_;
   const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
   auto start_ngram_size = impl.min_gram_length_;
   size_t output_idx;
 
   for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = row_begin;
-    auto const ngram_row_end = row_end;
-
-    while (ngram_start < ngram_row_end) {
-      // We went far enough so no n-grams of any size can be gathered
-      auto at_least_this = AdvanceElementPtr(ngram_start, SafeInt<size_t>(skip_distance) * (start_ngram_size - 1), elem_size);
-      if (at_least_this >= ngram_row_end) {
-        break;
-      }
-
-      auto ngram_item = ngram_start;
-      if (is_input_string) {
-        const std::string* str_item = reinterpret_cast<const std::string*>(ngram_item);
-        const StrMap* str_map = &impl.str_map_;
-        for (auto ngram_size = 1;
-             !str_map->empty() &&
-             ngram_size <= max_gram_length &&
-             str_item < ngram_row_end;
-             ++ngram_size, str_item += skip_distance) {
-          auto hit = str_map->find(*str_item);
-          if (hit == str_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            output_idx = impl.OutputIdToIncrement(hit->second->id_);
-            fn_weight(output_idx, output_data);
-          }
-          str_map = &hit->second->leafs_;
+    // We went far enough so no n-grams of any size can be gathered
+    const size_t min_span = SafeInt<size_t>(skip_distance) * (start_ngram_size - 1);
+    if (min_span >= row_size) {
+      break;
+    }
+    const T* const last_start = row_end - min_span;
+
+    for (const T* ngram_start = row_begin; ngram_start < last_start; ++ngram_start) {
+      auto node = NgramTrie::kRoot;
+      const T* ngram_item = ngram_start;
+      for (auto ngram_size = 1;
+           trie.HasChildren(node) &&
+           ngram_size <= max_gram_length &&
+           ngram_item < row_end;
+           ++ngram_size) {
+        node = trie.Find(node, static_cast<int64_t>(*ngram_item));
+        if (node == NgramTrie::kNoNode) {
+          break;
         }
-      } else {
-        const IntMap* int_map = &impl.int64_map_;
-        for (auto ngram_size = 1;
-             !int_map->empty() &&
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item = AdvanceElementPtr(ngram_item, skip_distance, elem_size)) {
-          int64_t val = (elem_size == 4) ? int64_t{*reinterpret_cast<const int32_t*>(ngram_item)} : *reinterpret_cast<const int64_t*>(ngram_item);
-          auto hit = int_map->find(val);
-          if (hit == int_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            output_idx = impl.OutputIdToIncrement(hit->second->id_);
-            fn_weight(output_idx, output_data);
-          }
-          int_map = &hit->second->leafs_;
+        const auto ngram_id = trie.NgramId(node);
+        if (ngram_size >= start_ngram_size && ngram_id != 0) {
+          output_idx = impl.OutputIdToIncrement(ngram_id);
+          fn_weight(output_idx, output_data);
+        }
+        if (row_end - ngram_item <= skip_distance) {
+          break;
         }
+        ngram_item += skip_distance;
       }
-      // Sliding window shift
-      ngram_start = AdvanceElementPtr(ngram_start, 1, elem_size);
     }
     // We count UniGrams only once since they are not affected
     // by skip distance
@@ -366,9 +406,7 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   auto output_data = Y->MutableData<float>();
   const bool is_input_string = X->IsDataTypeString();
 
-  if (total_items == 0 ||
-      (is_input_string && impl_->str_map_.empty()) ||
-      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_map_.empty())) {
+  if (total_items == 0 || impl_->trie_.Empty() || is_input_string != impl_->pool_is_string_) {
     // TfidfVectorizer may receive an empty input when it follows a Tokenizer
     // (for example for a string containing only stopwords).
     // TfidfVectorizer returns a zero tensor of shape
@@ -410,13 +448,30 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
 
   std::function<void(ptrdiff_t)> fn = [this, C, output_data, x_data_raw, elem_size,
                                        is_input_string, num_batches, num_rows, &fn_weight](ptrdiff_t batch_num) {
-    // Frequency holder allocate [B..output_size_] and init all to zero.
     auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_batches, static_cast<size_t>(num_rows));
-    std::vector<uint32_t> frequencies(this->impl_->output_size_);
+    // Tokens of the current row when the input is strings, so each string is hashed only once
+    std::vector<int64_t> row_tokens;
+    if (is_input_string) {
+      row_tokens.resize(C);
+    }
     for (auto row_num = work.start; row_num < work.end; ++row_num) {
       auto out = gsl::span<float>(output_data + row_num * this->impl_->output_size_, this->impl_->output_size_);
       std::fill(out.begin(), out.end(), 0.0f);
-      ComputeImpl(x_data_raw, elem_size, row_num, C, is_input_string, out, fn_weight);
+      const void* row_begin = AdvanceElementPtr(x_data_raw, row_num * C, elem_size);
+      if (is_input_string) {
+        const auto& str_tokens = this->impl_->str_tokens_;
+        const std::string* str_row = reinterpret_cast<const std::string*>(row_begin);
+        for (size_t i = 0; i < C; ++i) {
+          auto hit = str_tokens.find(str_row[i]);
+          // interned tokens are non-negative so -1 never matches
+          row_tokens[i] = hit == str_tokens.end() ? int64_t{-1} : hit->second;
+        }
+        ComputeImpl(row_tokens.data(), C, out, fn_weight);
+      } else if (elem_size == sizeof(int32_t)) {
+        ComputeImpl(reinterpret_cast<const int32_t*>(row_begin), C, out, fn_weight);
+      } else {
+        ComputeImpl(reinterpret_cast<const int64_t*>(row_begin), C, out, fn_weight);
+      }
     }
   };
 
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/async_run_scheduler.h"
+
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+AsyncRunScheduler::AsyncRunScheduler(OrtThreadPoolParams thread_pool_params, size_t max_queue_depth)
+    : max_queue_depth_(max_queue_depth) {
+  ORT_ENFORCE(thread_pool_params.thread_pool_size > 0, "The async run scheduler needs at least one thread");
+  if (thread_pool_params.name) {
+    thread_pool_name_ = thread_pool_params.name;
+  }
+  thread_pool_params.name = thread_pool_name_.empty() ? nullptr : thread_pool_name_.c_str();
+  // requests arrive irregularly, don't burn CPU waiting for them
+  thread_pool_params.allow_spinning = false;
+  thread_pool_params.auto_set_affinity = false;
+  const int num_workers = thread_pool_params.thread_pool_size;
+  // the thread calling Schedule does not participate, so one extra slot gives thread_pool_size workers
+  ++thread_pool_params.thread_pool_size;
+  thread_pool_ = concurrency::CreateThreadPool(&Env::Default(), thread_pool_params,
+                                               concurrency::ThreadPoolType::INTER_OP);
+  ORT_ENFORCE(thread_pool_ != nullptr, "Failed to create the async run thread pool");
+
+  // one loop per worker. A worker runs a single loop until shutdown, so the loops queued behind a busy worker are
+  // stolen by the idle ones and every worker ends up running one.
+  for (int i = 0; i < num_workers; ++i) {
+    concurrency::ThreadPool::Schedule(thread_pool_.get(), [this]() { WorkerLoop(); });
+  }
+}
+
+AsyncRunScheduler::~AsyncRunScheduler() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    shutting_down_ = true;
+  }
+  queue_cv_.notify_all();
+  // joins the workers once their loops have completed the queued requests
+  thread_pool_.reset();
+}
+
+Status AsyncRunScheduler::Submit(int priority, std::optional<Clock::time_point> deadline, RunFn run_fn) {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (shutting_down_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The session is being destroyed, RunAsync is not accepting requests");
+    }
+    if (max_queue_depth_ != 0 && queue_.size() >= max_queue_depth_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "RunAsync queue is full (", max_queue_depth_,
+                             " requests waiting). Request rejected.");
+    }
+    queue_.push(Request{priority, next_sequence_++, deadline, std::move(run_fn)});
+  }
+
+  queue_cv_.notify_one();
+  return Status::OK();
+}
+
+size_t AsyncRunScheduler::QueueDepth() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return queue_.size();
+}
+
+void AsyncRunScheduler::WorkerLoop() {
+  for (;;) {
+    Request request;
+    bool shutting_down;
+    {
+      std::unique_lock<OrtMutex> lock(mutex_);
+      queue_cv_.wait(lock, [this]() { return shutting_down_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      // priority_queue::top is const, the request is popped right after so moving from it is safe
+      request = std::move(const_cast<Request&>(queue_.top()));
+      queue_.pop();
+      shutting_down = shutting_down_;
+    }
+
+    Status status;
+    if (shutting_down) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The session was destroyed before the RunAsync request started");
+    } else if (request.deadline.has_value() && Clock::now() > *request.deadline) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "RunAsync request deadline expired before it started");
+    }
+
+    request.run_fn(status);
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+#include "core/util/thread_utils.h"
+
+namespace onnxruntime {
+
+/**
+ * Runs the requests of InferenceSession::RunAsync on dedicated threads, so that an async request does not
+ * occupy one of the intra-op workers its own kernels need. Each thread runs a loop that waits for queued requests,
+ * so Submit only queues the request and never runs it on the calling thread.
+ *
+ * Queued requests are started in priority order, FIFO within a priority. The number of queued requests is
+ * bounded and Submit fails immediately when the queue is full so callers can shed load. A request whose
+ * deadline passes while it is queued is completed with an error instead of being run.
+ */
+class AsyncRunScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Called once per request. If the status is not OK the request must not be run, only completed with it.
+  using RunFn = std::function<void(const Status& status)>;
+
+  /**
+   * @param thread_pool_params parameters of the pool running the requests. thread_pool_size is the number of
+   *                           requests that can run concurrently.
+   * @param max_queue_depth maximum number of requests waiting to start. 0 means unbounded.
+   */
+  AsyncRunScheduler(OrtThreadPoolParams thread_pool_params, size_t max_queue_depth);
+  ~AsyncRunScheduler();
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(AsyncRunScheduler);
+
+  /**
+   * Queues a request.
+   * @param priority requests with a higher priority start first.
+   * @param deadline if set, the request is completed with an error if it has not started by then.
+   * @returns an error without queuing the request if the queue is full.
+   */
+  Status Submit(int priority, std::optional<Clock::time_point> deadline, RunFn run_fn);
+
+  size_t QueueDepth() const;
+
+ private:
+  struct Request {
+    int priority;
+    uint64_t sequence;
+    std::optional<Clock::time_point> deadline;
+    RunFn run_fn;
+  };
+
+  struct RequestOrder {
+    bool operator()(const Request& a, const Request& b) const {
+      // std::priority_queue puts the largest element first
+      return a.priority != b.priority ? a.priority < b.priority : a.sequence > b.sequence;
+    }
+  };
+
+  // Runs the queued requests until the scheduler is destroyed. Scheduled once per thread.
+  void WorkerLoop();
+
+  const size_t max_queue_depth_;
+  mutable OrtMutex mutex_;
+  // signaled when a request is queued or the scheduler is being destroyed
+  OrtCondVar queue_cv_;
+  std::priority_queue<Request, std::vector<Request>, RequestOrder> queue_;
+  uint64_t next_sequence_ = 0;
+  bool shutting_down_ = false;
+
+  std::basic_string<ORTCHAR_T> thread_pool_name_;
+  std::unique_ptr<concurrency::ThreadPool> thread_pool_;
+};
+
+}  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "core/session/environment.h"
 #include "core/session/allocator_adapters.h"
 #include "core/framework/allocator_utils.h"
+#include "core/framework/shared_initializer_registry.h"
 #include "core/graph/constants.h"
 #include "core/graph/op.h"
 
@@ -55,6 +56,10 @@ std::once_flag schemaRegistrationOnceFlag;
 ProviderInfo_CUDA& GetProviderInfo_CUDA();
 #endif  // USE_CUDA
 
+Environment::Environment() : shared_initializer_registry_(std::make_unique<SharedInitializerRegistry>()) {}
+
+Environment::~Environment() = default;
+
 Status Environment::Create(std::unique_ptr<logging::LoggingManager> logging_manager,
                            std::unique_ptr<Environment>& environment,
                            const OrtThreadingOptions* tp_options,
@@ -4,6 +4,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <filesystem>
 #include <memory>
 #include <sstream>
 #include <list>
@@ -28,6 +29,7 @@
 #include "core/framework/kernel_type_str_resolver_utils.h"
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/TensorSeq.h"
+#include "core/framework/shared_initializer_registry.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -64,6 +66,7 @@
 #include "core/session/user_logging_sink.h"
 #include "core/session/IOBinding.h"
 #include "core/session/inference_session_utils.h"
+#include "core/session/prepared_run.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
 #include "core/util/protobuf_parsing_utils.h"
@@ -118,6 +121,31 @@ inline std::basic_string<T> GetCurrentTimeString() {
   return std::basic_string<T>(time_str);
 }
 
+// Adds the trace events of the session's thread pools to the profile.
+// See kOrtSessionOptionsConfigEnableThreadPoolTracing.
+class ThreadPoolTraceProfiler : public profiling::EpProfiler {
+ public:
+  ThreadPoolTraceProfiler(concurrency::ThreadPool* intra_op_thread_pool,
+                          concurrency::ThreadPool* inter_op_thread_pool)
+      : intra_op_thread_pool_(intra_op_thread_pool), inter_op_thread_pool_(inter_op_thread_pool) {}
+
+  bool StartProfiling(TimePoint profiling_start_time) override {
+    const auto max_num_events = profiling::Profiler::GetGlobalMaxNumEvents();
+    concurrency::ThreadPool::StartTracing(intra_op_thread_pool_, profiling_start_time, max_num_events);
+    concurrency::ThreadPool::StartTracing(inter_op_thread_pool_, profiling_start_time, max_num_events);
+    return true;
+  }
+
+  void EndProfiling(TimePoint /*start_time*/, profiling::Events& events) override {
+    concurrency::ThreadPool::StopTracing(intra_op_thread_pool_, events);
+    concurrency::ThreadPool::StopTracing(inter_op_thread_pool_, events);
+  }
+
+ private:
+  concurrency::ThreadPool* intra_op_thread_pool_;
+  concurrency::ThreadPool* inter_op_thread_pool_;
+};
+
 #if !defined(ORT_MINIMAL_BUILD)
 
 static bool HasControlflowNodes(const Graph& graph) {
@@ -368,8 +396,20 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
     });
   }
 
+  int numa_node = -1;
+  ORT_THROW_IF_ERROR(ParseStringWithClassicLocale(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNumaNode, "-1"), numa_node));
+
   use_per_session_threads_ = session_options.use_per_session_threads;
   force_spinning_stop_between_runs_ = session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigForceSpinningStop, "0") == "1";
+  ORT_THROW_IF_ERROR(ParseStringWithClassicLocale(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpMaxDegreeOfParallelism, "0"),
+      intra_op_max_degree_of_parallelism_));
+
+  if (!use_per_session_threads_ && numa_node >= 0) {
+    LOGS(*session_logger_, WARNING) << "NUMA node " << numa_node
+                                    << " is ignored for the thread pools of the environment";
+  }
 
   if (use_per_session_threads_) {
     LOGS(*session_logger_, INFO) << "Creating and using per session threadpools since use_per_session_threads_ is true";
@@ -389,8 +429,12 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         // If the thread pool can use all the processors, then
         // we set affinity of each thread to each processor.
         to.allow_spinning = allow_intra_op_spinning;
+        to.adaptive_spinning =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAdaptiveIntraOpSpinning, "0") == "1";
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
         LOGS(*session_logger_, INFO) << "Dynamic block base set to " << to.dynamic_block_base_;
+        to.guided_scheduling =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpGuidedScheduling, "0") == "1";
 
         // Set custom threading functions
         to.custom_create_thread_fn = session_options_.custom_create_thread_fn;
@@ -399,6 +443,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, to.affinity_str)) {
           ORT_ENFORCE(!to.affinity_str.empty(), "Affinity string must not be empty");
         }
+        to.numa_node = numa_node;
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
                                to.affinity_str.empty();
@@ -426,12 +471,15 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         to.name = inter_thread_pool_name_.c_str();
         to.set_denormal_as_zero = set_denormal_as_zero;
         to.allow_spinning = allow_inter_op_spinning;
+        to.adaptive_spinning =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAdaptiveInterOpSpinning, "0") == "1";
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
 
         // Set custom threading functions
         to.custom_create_thread_fn = session_options_.custom_create_thread_fn;
         to.custom_thread_creation_options = session_options.custom_thread_creation_options;
         to.custom_join_thread_fn = session_options_.custom_join_thread_fn;
+        to.numa_node = numa_node;
 
         if (to.custom_create_thread_fn) {
           ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set for inter op thread pool");
@@ -453,7 +501,44 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
                 " threadpools, the env must be created with the the CreateEnvWithGlobalThreadPools API.");
   }
 
+  {
+    int async_run_num_threads = 0;
+    ORT_THROW_IF_ERROR(ParseStringWithClassicLocale(
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAsyncRunNumThreads, "0"),
+        async_run_num_threads));
+    if (async_run_num_threads > 0) {
+      size_t max_queue_depth = 0;
+      ORT_THROW_IF_ERROR(ParseStringWithClassicLocale(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAsyncRunMaxQueueDepth, "0"),
+          max_queue_depth));
+
+      OrtThreadPoolParams to;
+      to.thread_pool_size = async_run_num_threads;
+      std::basic_stringstream<ORTCHAR_T> ss;
+      ss << ORT_TSTR("session-") << session_id_ << ORT_TSTR("-async-run");
+      async_run_thread_pool_name_ = ss.str();
+      to.name = async_run_thread_pool_name_.c_str();
+      to.custom_create_thread_fn = session_options_.custom_create_thread_fn;
+      to.custom_thread_creation_options = session_options.custom_thread_creation_options;
+      to.custom_join_thread_fn = session_options_.custom_join_thread_fn;
+      to.numa_node = numa_node;
+      async_run_scheduler_ = std::make_unique<AsyncRunScheduler>(to, max_queue_depth);
+      LOGS(*session_logger_, INFO) << "RunAsync uses " << async_run_num_threads
+                                   << " dedicated threads, max queue depth " << max_queue_depth;
+    }
+  }
+
   session_profiler_.Initialize(session_logger_);
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableThreadPoolTracing, "0") == "1") {
+    // the thread pools of the environment are traced by a single session at a time, and other sessions stopping
+    // or starting their traces would interfere
+    if (use_per_session_threads_) {
+      session_profiler_.AddEpProfilers(std::make_unique<ThreadPoolTraceProfiler>(GetIntraOpThreadPoolToUse(),
+                                                                                 GetInterOpThreadPoolToUse()));
+    } else {
+      LOGS(*session_logger_, WARNING) << "Thread pool tracing is not supported for the thread pools of the environment";
+    }
+  }
   if (session_options_.enable_profiling) {
     StartProfiling(session_options_.profile_file_prefix);
   }
@@ -577,6 +662,9 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  // complete or fail any pending RunAsync request while the rest of the session is still alive
+  async_run_scheduler_.reset();
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -811,6 +899,108 @@ common::Status InferenceSession::SaveToOrtFormat(const PathString& filepath) con
   return Status::OK();
 }
 
+common::Status InferenceSession::LoadFromOptimizedModelCache() {
+  if (model_hash_for_optimized_model_cache_.empty()) {
+    return Status::OK();
+  }
+
+  if (!session_options_.optimized_model_filepath.empty()) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache is not used as optimized_model_filepath is set.";
+    return Status::OK();
+  }
+
+  // the cache entry holds the initializers of the optimized graph, which the key does not cover if the session
+  // supplies some of them
+  bool has_session_supplied_initializers = !session_options_.initializers_to_share_map.empty();
+#if !defined(DISABLE_EXTERNAL_INITIALIZERS)
+  has_session_supplied_initializers = has_session_supplied_initializers ||
+                                      !session_options_.external_initializers.empty();
+#endif
+  if (has_session_supplied_initializers) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache is not used as the session supplies initializers.";
+    return Status::OK();
+  }
+
+  // the weights in external data files are embedded in the cache entry, so key it by them too
+  inference_session_utils::OptimizedModelCacheKeyHasher hasher;
+  hasher.Add(model_hash_for_optimized_model_cache_);
+  Status external_data_status = hasher.AddExternalDataFiles(
+      model_->MainGraph(), std::filesystem::path{model_location_}.parent_path().native());
+  if (!external_data_status.IsOK()) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache is not used. "
+                                 << external_data_status.ErrorMessage();
+    return Status::OK();
+  }
+
+  const std::filesystem::path cache_dir{
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "")};
+  const PathString cache_entry =
+      (cache_dir / inference_session_utils::GetOptimizedModelCacheEntryName(
+                       hasher.HexDigest(), session_options_, optimizers_to_disable_, execution_providers_))
+          .native();
+
+  size_t cache_entry_length = 0;
+  if (!Env::Default().GetFileLength(cache_entry.c_str(), cache_entry_length).IsOK()) {
+    LOGS(*session_logger_, INFO) << "Optimized model cache miss. The optimized model will be saved to "
+                                 << ToUTF8String(cache_entry);
+    optimized_model_cache_entry_ = cache_entry;
+    return Status::OK();
+  }
+
+  // keep the ONNX model to fall back to if the cache entry fails to load
+  std::shared_ptr<Model> onnx_model = std::move(model_);
+  const PathString onnx_model_location = model_location_;
+  is_model_loaded_ = false;
+
+  Status status = LoadOrtModel(cache_entry);
+  model_location_ = onnx_model_location;
+  if (status.IsOK()) {
+    LOGS(*session_logger_, INFO) << "Loaded the optimized model from the cache entry " << ToUTF8String(cache_entry);
+    return Status::OK();
+  }
+
+  LOGS(*session_logger_, WARNING) << "Failed to load the optimized model cache entry " << ToUTF8String(cache_entry)
+                                  << ". " << status.ErrorMessage() << " The entry will be replaced.";
+  model_ = std::move(onnx_model);
+  ort_format_model_bytes_ = gsl::span<const uint8_t>();
+  std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+  using_ort_model_bytes_for_initializers_ = false;
+  ORT_RETURN_IF_ERROR(SaveModelMetadata(*model_));
+  is_model_loaded_ = true;
+  optimized_model_cache_entry_ = cache_entry;
+
+  return Status::OK();
+}
+
+void InferenceSession::SaveToOptimizedModelCache() const {
+  if (session_state_->GetFuncMgr().NumFuncs() > 0) {
+    LOGS(*session_logger_, INFO) << "The optimized model is not cached as it contains compiled nodes.";
+    return;
+  }
+
+  // write to a temporary file first so other sessions never load a partially written entry
+  const PathString temp_entry =
+      optimized_model_cache_entry_ +
+      ToPathString(MakeString(".", Env::Default().GetSelfPid(), ".", session_id_, ".tmp"));
+
+  std::error_code error;
+  std::filesystem::create_directories(std::filesystem::path{optimized_model_cache_entry_}.parent_path(), error);
+
+  Status status = SaveToOrtFormat(temp_entry);
+  if (status.IsOK()) {
+    std::filesystem::rename(temp_entry, optimized_model_cache_entry_, error);
+    if (error) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, error.message());
+    }
+  }
+
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to save the optimized model cache entry "
+                                    << ToUTF8String(optimized_model_cache_entry_) << ". " << status.ErrorMessage();
+    std::filesystem::remove(temp_entry, error);
+  }
+}
+
 common::Status InferenceSession::LoadWithLoader(std::function<common::Status(std::shared_ptr<Model>&)> loader,
                                                 const std::string& event_name) {
   Status status = Status::OK();
@@ -908,6 +1098,12 @@ common::Status InferenceSession::Load(const PathString& model_uri) {
                            "Invoke Load().");
   }
 
+  if (!session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "").empty()) {
+    inference_session_utils::OptimizedModelCacheKeyHasher hasher;
+    ORT_RETURN_IF_ERROR(hasher.AddFile(model_uri));
+    model_hash_for_optimized_model_cache_ = hasher.HexDigest();
+  }
+
   return LoadOnnxModel(model_uri);
 #else
   return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "ONNX format model is not supported in this build.");
@@ -937,6 +1133,12 @@ common::Status InferenceSession::Load(const void* model_data, int model_data_len
                            "Invoke Load().");
   }
 
+  if (!session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "").empty()) {
+    inference_session_utils::OptimizedModelCacheKeyHasher hasher;
+    hasher.Add(model_data, static_cast<size_t>(model_data_len));
+    model_hash_for_optimized_model_cache_ = hasher.HexDigest();
+  }
+
   auto loader = [this, model_data, model_data_len](std::shared_ptr<onnxruntime::Model>& model) {
     ModelProto model_proto;
 
@@ -1553,6 +1755,11 @@ common::Status InferenceSession::Initialize() {
       have_cpu_ep = execution_providers_.Get(onnxruntime::kCpuExecutionProvider) != nullptr;
     }
 
+#if !defined(ORT_MINIMAL_BUILD)
+    // now that the execution providers are known, swap in the cached optimized model if there is one
+    ORT_RETURN_IF_ERROR_SESSIONID_(LoadFromOptimizedModelCache());
+#endif
+
     // Verify that there are no external initializers in the graph if external data is disabled.
     onnxruntime::Graph& graph = model_->MainGraph();
 #ifdef DISABLE_EXTERNAL_INITIALIZERS
@@ -1590,6 +1797,17 @@ common::Status InferenceSession::Initialize() {
     session_activity_started_ = true;
 #endif
 
+    const bool share_initializers_by_content =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigShareInitializersByContent,
+                                                           "0") == "1";
+    if (share_initializers_by_content && prepacked_weights_container_ == nullptr) {
+      // the pre-packed weights are keyed by the content of the initializers, so sessions sharing an initializer
+      // share its pre-packed forms
+      content_shared_prepacked_weights_container_ =
+          environment_.GetSharedInitializerRegistry().GetPrepackedWeightsContainer();
+      prepacked_weights_container_ = content_shared_prepacked_weights_container_.get();
+    }
+
     // now that we have all the execution providers, create the session state
     session_state_ = std::make_unique<SessionState>(
         model_->MainGraph(),
@@ -1646,6 +1864,14 @@ common::Status InferenceSession::Initialize() {
 
     if (!loading_ort_format) {
 #if !defined(ORT_MINIMAL_BUILD)
+      const auto incremental_resolve_config_value = session_options_.config_options.GetConfigOrDefault(
+          kOrtSessionOptionsConfigIncrementalGraphResolve, "0");
+      if (incremental_resolve_config_value == "1") {
+        graph.SetIncrementalResolveMode(Graph::IncrementalResolveMode::kEnabled);
+      } else if (incremental_resolve_config_value == "2") {
+        graph.SetIncrementalResolveMode(Graph::IncrementalResolveMode::kVerified);
+      }
+
       const auto minimal_build_opt_config_value = session_options_.config_options.GetConfigOrDefault(
           kOrtSessionOptionsConfigMinimalBuildOptimizations, "");
       MinimalBuildOptimizationHandling minimal_build_optimization_handling{};
@@ -1843,10 +2069,22 @@ common::Status InferenceSession::Initialize() {
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
     }
 
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+    if (share_initializers_by_content) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(ShareInitializersByContent(graph));
+    }
+#endif
+
+#if !defined(ORT_MINIMAL_BUILD)
+    const bool saving_to_optimized_model_cache = !optimized_model_cache_entry_.empty();
+#else
+    const bool saving_to_optimized_model_cache = false;
+#endif
+
     ORT_RETURN_IF_ERROR_SESSIONID_(
         session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
                                              // need to keep the initializers if saving the optimized model
-                                             !saving_model,
+                                             !saving_model && !saving_to_optimized_model_cache,
                                              saving_ort_format));
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -1887,6 +2125,10 @@ common::Status InferenceSession::Initialize() {
       }
     }
 
+    if (saving_to_optimized_model_cache) {
+      SaveToOptimizedModelCache();
+    }
+
     std::vector<TuningResults> tuning_results;
     bool found_tuning_results = false;
     ORT_RETURN_IF_ERROR_SESSIONID_(inference_session_utils::ParseTuningResultsFromModelMetadata(
@@ -1896,6 +2138,17 @@ common::Status InferenceSession::Initialize() {
     }
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+    uint32_t sampled_profiling_interval = 0;
+    ORT_RETURN_IF_ERROR_SESSIONID_(ParseStringWithClassicLocale(
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSampledProfilingInterval, "0"),
+        sampled_profiling_interval));
+    if (sampled_profiling_interval > 0) {
+      // only the main graph is sampled, the time of a subgraph is included in the node that runs it
+      sampled_profiler_ = std::make_unique<SampledProfiler>(session_state_->GetGraphViewer(),
+                                                            sampled_profiling_interval);
+      session_state_->SetSampledProfiler(sampled_profiler_.get());
+    }
+
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
@@ -2183,6 +2436,73 @@ common::Status InferenceSession::ValidateOutputs(gsl::span<const std::string> ou
   return ValidateInputsOutputs(output_names, fetches, output_def_map_, ArgType::kOutput);
 }
 
+common::Status InferenceSession::ValidatePreparedRun(PreparedRun& prepared_run, gsl::span<const OrtValue> feeds,
+                                                     const std::vector<OrtValue>* p_fetches) const {
+  if (&prepared_run.session_ != this) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "PreparedRun was created by a different session.");
+  }
+
+  const auto feed_names = prepared_run.GetFeedNames();
+  if (feeds.size() != feed_names.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "PreparedRun has ", feed_names.size(),
+                           " feed names, but feeds has ", feeds.size(), " elements.");
+  }
+
+  const auto fetches = (p_fetches == nullptr) ? EmptySpan<const OrtValue>() : gsl::make_span(*p_fetches);
+  const auto output_names = prepared_run.GetOutputNames();
+  if (!fetches.empty() && fetches.size() != output_names.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "PreparedRun has ", output_names.size(),
+                           " output names, but fetches has ", fetches.size(), " elements.");
+  }
+
+  // names were validated by NewPreparedRun, so only values that differ from the last validated ones need checking
+  Status status;
+  for (size_t i = 0, end = feeds.size(); i < end && status.IsOK(); ++i) {
+    if (!PreparedRun::MatchesSignature(feeds[i], prepared_run.feed_signatures_[i])) {
+      status = ValidateInputsOutputs(feed_names.subspan(i, 1), feeds.subspan(i, 1), input_def_map_, ArgType::kInput);
+    }
+  }
+
+  for (size_t i = 0, end = fetches.size(); i < end && status.IsOK(); ++i) {
+    if (fetches[i].IsAllocated() &&
+        !PreparedRun::MatchesSignature(fetches[i], prepared_run.fetch_signatures_[i])) {
+      status = ValidateInputsOutputs(output_names.subspan(i, 1), fetches.subspan(i, 1), output_def_map_,
+                                     ArgType::kOutput);
+    }
+  }
+
+  if (!status.IsOK()) {
+    prepared_run.ResetSignatures();
+  }
+
+  return status;
+}
+
+common::Status InferenceSession::NewPreparedRun(gsl::span<const std::string> feed_names,
+                                                gsl::span<const std::string> output_names,
+                                                std::unique_ptr<PreparedRun>& prepared_run) const {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  for (const auto& name : feed_names) {
+    if (input_def_map_.count(name) == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid input name: ", name);
+    }
+  }
+
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, nullptr));
+
+  FeedsFetchesInfo info;
+  info.feed_names.assign(feed_names.begin(), feed_names.end());
+  info.output_names.assign(output_names.begin(), output_names.end());
+  ORT_RETURN_IF_ERROR_SESSIONID_(info.SetMLValueIdxs(session_state_->GetOrtValueNameIdxMap()));
+
+  prepared_run = std::make_unique<PreparedRun>(*this, std::move(info));
+  return Status::OK();
+}
+
 #ifdef ENABLE_TRAINING
 Status InferenceSession::PartialRun(onnxruntime::RunOptions& run_options,
                                     const std::vector<OrtValue>& feeds,
@@ -2288,6 +2608,20 @@ Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info, nullptr);
+}
+
+Status InferenceSession::Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>* p_fetches) {
+  return RunImpl(run_options, prepared_run.GetFeedNames(), feeds, prepared_run.GetOutputNames(), p_fetches, nullptr,
+                 &prepared_run);
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options,
+                                 gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info,
+                                 PreparedRun* prepared_run) {
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -2331,8 +2665,12 @@ Status InferenceSession::Run(const RunOptions& run_options,
       // log evaluation start to trace logging provider
       env.GetTelemetryProvider().LogEvaluationStart();
 
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+      if (prepared_run) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidatePreparedRun(*prepared_run, feeds, p_fetches));
+      } else {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+      }
 
       // shrink certain default memory arenas if the user has requested for it
       const std::string& shrink_memory_arenas =
@@ -2342,8 +2680,17 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_RETURN_IF_ERROR_SESSIONID_(ValidateAndParseShrinkArenaString(shrink_memory_arenas, arenas_to_shrink));
       }
 
-      FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-      FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+      std::optional<FeedsFetchesManager> owned_feeds_fetches_manager;
+      if (!prepared_run) {
+        owned_feeds_fetches_manager.emplace(
+            FeedsFetchesInfo(feed_names, output_names, session_state_->GetOrtValueNameIdxMap()));
+      } else {
+        // the feeds and fetches may live on different devices than in the previous run
+        prepared_run->feeds_fetches_manager_.ResetDeviceCopyChecks();
+      }
+
+      FeedsFetchesManager& feeds_fetches_manager = prepared_run ? prepared_run->feeds_fetches_manager_
+                                                                : *owned_feeds_fetches_manager;
 
       if (p_fetches_device_info) {
         // populate the target device info. ignored if pre-allocated fetches are provided
@@ -2364,6 +2711,16 @@ Status InferenceSession::Run(const RunOptions& run_options,
       std::unique_ptr<logging::Logger> owned_run_logger;
       const auto& run_logger = CreateLoggerForRun(run_options, owned_run_logger);
 
+      // bound the share of the intra op thread pool taken by this run
+      int max_degree_of_parallelism = intra_op_max_degree_of_parallelism_;
+      std::string run_max_degree_of_parallelism;
+      if (run_options.config_options.TryGetConfigEntry(kOrtRunOptionsConfigIntraOpMaxDegreeOfParallelism,
+                                                       run_max_degree_of_parallelism)) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ParseStringWithClassicLocale(run_max_degree_of_parallelism,
+                                                                    max_degree_of_parallelism));
+      }
+      concurrency::ThreadPool::ScopedLoopThreadLimit loop_thread_limit(max_degree_of_parallelism);
+
       std::optional<std::lock_guard<OrtMutex>> sequential_run_lock;
       if (is_concurrent_run_supported_ == false) {
         sequential_run_lock.emplace(session_mutex_);
@@ -2384,15 +2741,6 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_CHECK_AND_SET_RETVAL(start_func());
       }
 
-#ifdef ENABLE_TRAINING
-      if (run_options.only_execute_path_to_fetches) {
-        // TODO: this method is not thread safe, if multiple Run happened in parallel we might hit race condition issue.
-        // currently it only used in training, there is no parallel run execution in training so it is ok.
-        // but it is better we can fix it with a better solution.
-        session_state_->UpdateToBeExecutedRange(feeds_fetches_manager.GetFeedsFetchesInfo().fetches_mlvalue_idxs);
-      }
-#endif
-
       // execute the graph
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
       session_state_->IncrementGraphExecutionCounter();
@@ -2477,7 +2825,8 @@ Status InferenceSession::Run(const RunOptions& run_options,
   if (retval.IsOK() && cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled() &&
       !cached_execution_provider_for_graph_replay_.IsGraphCaptured()) {
     LOGS(*session_logger_, INFO) << "Start another run for necessary memory allocation or graph capture.";
-    ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info));
+    ORT_RETURN_IF_ERROR(RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                                prepared_run));
   }
   return retval;
 }
@@ -2553,6 +2902,54 @@ Status InferenceSession::Run(const RunOptions& run_options,
   return Status::OK();
 }
 
+Status InferenceSession::Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                             gsl::span<const OrtValue* const> feeds, gsl::span<OrtValue*> fetches) {
+  const size_t num_fetches = fetches.size();
+  if (num_fetches != prepared_run.GetOutputNames().size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "PreparedRun has ", prepared_run.GetOutputNames().size(),
+                           " output names, but fetches has ", num_fetches, " elements.");
+  }
+
+  InlinedVector<OrtValue> feed_vec;
+  feed_vec.reserve(feeds.size());
+  for (size_t i = 0, end = feeds.size(); i != end; ++i) {
+    if (!feeds[i]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NULL input supplied for input ", i);
+    }
+    feed_vec.emplace_back(*feeds[i]);
+  }
+
+  std::vector<OrtValue> fetch_vec;
+  fetch_vec.reserve(num_fetches);
+  for (size_t i = 0; i != num_fetches; ++i) {
+    if (fetches[i] != nullptr) {
+      fetch_vec.emplace_back(*fetches[i]);
+    } else {
+      fetch_vec.emplace_back();
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(Run(run_options, prepared_run, feed_vec, &fetch_vec));
+
+  // We do it in two loops to make sure copy __ctors does not throw
+  InlinedVector<std::unique_ptr<OrtValue>> fetch_unique_ptrs;
+  fetch_unique_ptrs.reserve(num_fetches);
+  for (size_t i = 0; i != num_fetches; ++i) {
+    if (fetches[i] == nullptr) {
+      fetch_unique_ptrs.emplace_back(std::make_unique<OrtValue>(fetch_vec[i]));
+    } else {
+      fetch_unique_ptrs.emplace_back();
+    }
+  }
+
+  for (size_t i = 0; i != num_fetches; ++i) {
+    if (fetches[i] == nullptr) {
+      fetches[i] = fetch_unique_ptrs[i].release();
+    }
+  }
+  return Status::OK();
+}
+
 common::Status InferenceSession::RunAsync(const RunOptions* run_options,
                                           gsl::span<const char* const> feed_names,
                                           gsl::span<const OrtValue* const> feeds,
@@ -2562,10 +2959,14 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
                                           void* user_data) {
   size_t num_fetches = fetch_names.size();
   auto* tp = GetIntraOpThreadPoolToUse();
-  if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
+  if (!async_run_scheduler_ && (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2)) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "intra op thread pool must have at least one thread for RunAsync");
   }
-  std::function<void()> run_fn = [=]() {
+  std::function<void(const Status&)> run_fn = [=](const Status& scheduler_status) {
+    if (!scheduler_status.IsOK()) {
+      callback(user_data, fetches.data(), 0, ToOrtStatus(scheduler_status));
+      return;
+    }
     Status status = Status::OK();
     ORT_TRY {
       if (run_options) {
@@ -2585,7 +2986,24 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
     }
     callback(user_data, fetches.data(), status.IsOK() ? num_fetches : 0, ToOrtStatus(status));
   };  // run_fn
-  concurrency::ThreadPool::Schedule(tp, run_fn);
+
+  if (async_run_scheduler_) {
+    int priority = 0;
+    std::optional<AsyncRunScheduler::Clock::time_point> deadline;
+    if (run_options) {
+      ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(
+          run_options->config_options.GetConfigOrDefault(kOrtRunOptionsConfigAsyncRunPriority, "0"), priority));
+      std::string deadline_ms;
+      if (run_options->config_options.TryGetConfigEntry(kOrtRunOptionsConfigAsyncRunDeadlineMs, deadline_ms)) {
+        int64_t ms = 0;
+        ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(deadline_ms, ms));
+        deadline = AsyncRunScheduler::Clock::now() + std::chrono::milliseconds(ms);
+      }
+    }
+    return async_run_scheduler_->Submit(priority, deadline, std::move(run_fn));
+  }
+
+  concurrency::ThreadPool::Schedule(tp, [run_fn = std::move(run_fn)]() { run_fn(Status::OK()); });
   return Status::OK();
 }
 
@@ -2724,6 +3142,56 @@ const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
 
+common::Status InferenceSession::GetSampledProfile(std::string& prometheus_text) const {
+  if (!sampled_profiler_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "Sampled profiling is not enabled. Set ", kOrtSessionOptionsConfigSampledProfilingInterval,
+                           " in the session options and initialize the session.");
+  }
+
+  prometheus_text = SampledProfiler::ToPrometheusText(sampled_profiler_->Snapshot());
+  return Status::OK();
+}
+
+common::Status InferenceSession::GetPeakMemoryUsage(gsl::span<const TensorShape> input_shapes,
+                                                    size_t& planned_peak_bytes, size_t& actual_peak_bytes) const {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  if (!session_state_->GetRecordMemoryUsage()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The session does not record the memory usage of its runs. ",
+                           "Set ", kOrtSessionOptionsConfigRecordPeakMemoryUsage, " to 1 to enable it.");
+  }
+
+  const auto& model_inputs = model_->MainGraph().GetInputs();
+  if (input_shapes.size() != model_inputs.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expected the shapes of ", model_inputs.size(),
+                           " inputs but got ", input_shapes.size());
+  }
+
+  InlinedVector<int> input_mlvalue_idxs;
+  input_mlvalue_idxs.reserve(model_inputs.size());
+  for (const auto* input : model_inputs) {
+    int idx;
+    ORT_RETURN_IF_ERROR(session_state_->GetOrtValueNameIdxMap().GetIdx(input->Name(), idx));
+    input_mlvalue_idxs.push_back(idx);
+  }
+
+  SessionState::MemoryUsage memory_usage;
+  if (!session_state_->GetMemoryUsage(input_mlvalue_idxs, input_shapes, memory_usage)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The session has no run with the given input shapes.");
+  }
+
+  planned_peak_bytes = memory_usage.planned_peak_bytes;
+  actual_peak_bytes = memory_usage.actual_peak_bytes;
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 std::vector<TuningResults> InferenceSession::GetTuningResults() const {
   std::vector<TuningResults> ret;
@@ -2859,6 +3327,67 @@ common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model)
 }
 #endif
 
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+namespace {
+// the initializers of subgraphs are in separate session states which also see initializers_to_share_map
+void GetSubgraphInitializerNames(const Graph& graph, InlinedHashSet<std::string>& names) {
+  for (const auto& node : graph.Nodes()) {
+    for (const auto& subgraph : node.GetSubgraphs()) {
+      for (const auto& [name, tensor_proto] : subgraph->GetAllInitializedTensors()) {
+        ORT_UNUSED_PARAMETER(tensor_proto);
+        names.insert(name);
+      }
+      GetSubgraphInitializerNames(*subgraph, names);
+    }
+  }
+}
+}  // namespace
+
+common::Status InferenceSession::ShareInitializersByContent(const Graph& graph) {
+  // smaller initializers are not worth hashing
+  constexpr size_t kMinSharedInitializerSizeInBytes = 1024;
+
+  InlinedHashSet<std::string> subgraph_initializer_names;
+  GetSubgraphInitializerNames(graph, subgraph_initializer_names);
+
+  auto& registry = environment_.GetSharedInitializerRegistry();
+  auto& initializers_to_share_map = session_options_.initializers_to_share_map;
+
+  for (const auto& [name, tensor_proto] : graph.GetAllInitializedTensors()) {
+    if (initializers_to_share_map.count(name) > 0 || subgraph_initializer_names.count(name) > 0 ||
+        graph.GetConstantInitializer(name, false) == nullptr ||
+        !utils::HasDataType(*tensor_proto) ||
+        tensor_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+      continue;
+    }
+
+    size_t size_in_bytes = 0;
+    if (!utils::GetSizeInBytesFromTensorProto<0>(*tensor_proto, &size_in_bytes).IsOK() ||
+        size_in_bytes < kMinSharedInitializerSizeInBytes) {
+      continue;
+    }
+
+    // the shared initializers are on CPU, so sharing them with nodes on other devices would copy them
+    const auto consumers = graph.GetConsumerNodes(name);
+    if (consumers.empty() ||
+        std::any_of(consumers.cbegin(), consumers.cend(), [](const Node* consumer) {
+          return consumer->GetExecutionProviderType() != onnxruntime::kCpuExecutionProvider;
+        })) {
+      continue;
+    }
+
+    std::shared_ptr<const OrtValue> initializer;
+    ORT_RETURN_IF_ERROR(registry.GetOrAddInitializer(*tensor_proto, model_->ModelPath(), initializer));
+    initializers_to_share_map[name] = initializer.get();
+    content_shared_initializers_.push_back(std::move(initializer));
+  }
+
+  LOGS(*session_logger_, INFO) << "Sharing " << content_shared_initializers_.size()
+                               << " initializers by content with the other sessions of the environment.";
+  return Status::OK();
+}
+#endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+
 common::Status InferenceSession::SaveModelMetadata(const onnxruntime::Model& model) {
   VLOGS(*session_logger_, 1) << "Saving model metadata";
   const onnxruntime::Graph& graph = model.MainGraph();
@@ -2986,8 +3515,12 @@ common::Status InferenceSession::AddPredefinedTransformers(
             minimal_build_optimization_handling == MinimalBuildOptimizationHandling::ApplyFullBuildOptimizations;
 
         if (use_full_build_optimizations) {
+          const bool parallel_initialization =
+              session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigParallelInitialization,
+                                                                 "0") == "1";
           return optimizer_utils::GenerateTransformers(level, session_options_, cpu_ep,
-                                                       optimizers_to_disable_);
+                                                       optimizers_to_disable_,
+                                                       parallel_initialization ? GetIntraOpThreadPoolToUse() : nullptr);
         } else {
           const auto sat_context =
               minimal_build_optimization_handling ==
@@ -18,6 +18,7 @@
 #include "core/framework/iexecutor.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/sampled_profiler.h"
 #include "core/framework/session_state.h"
 #include "core/framework/tuning_results.h"
 #include "core/framework/framework_provider_common.h"
@@ -26,6 +27,7 @@
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
 #include "core/framework/session_options.h"
+#include "core/session/async_run_scheduler.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
 #endif
@@ -44,6 +46,7 @@ class Environment;
 class GraphTransformer;
 class IExecutionProvider;
 class IOBinding;
+class PreparedRun;
 struct Notification;
 
 #ifdef ENABLE_TRAINING
@@ -368,6 +371,29 @@ class InferenceSession {
   [[nodiscard]] virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   [[nodiscard]] common::Status Run(IOBinding& io_binding);
 
+  /**
+   * Resolves feed and fetch names once for repeated calls to Run with a PreparedRun.
+   * @param feed_names names of the inputs that will be fed, in the order the values will be passed to Run.
+   * @param output_names names of the outputs to fetch, in the order they will be returned by Run.
+   * @param prepared_run the new PreparedRun. It must not outlive this session.
+   * @return OK if all names are valid.
+   */
+  [[nodiscard]] common::Status NewPreparedRun(gsl::span<const std::string> feed_names,
+                                              gsl::span<const std::string> output_names,
+                                              std::unique_ptr<PreparedRun>& prepared_run) const;
+
+  /**
+   * Run with feed and fetch names resolved by NewPreparedRun.
+   * @param feeds values in the order of the feed names of prepared_run.
+   * @param p_fetches values in the order of the output names of prepared_run. May be empty, or contain
+   *        pre-allocated values.
+   */
+  [[nodiscard]] common::Status Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                                   gsl::span<const OrtValue> feeds, std::vector<OrtValue>* p_fetches);
+
+  [[nodiscard]] common::Status Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                                   gsl::span<const OrtValue* const> feeds, gsl::span<OrtValue*> fetches);
+
 #ifdef ENABLE_TRAINING
   /**
    * Partially run a pre-loaded and pre-intialized model.
@@ -474,6 +500,28 @@ class InferenceSession {
     */
   const profiling::Profiler& GetProfiling() const;
 
+  /**
+    * Get the per node latency histograms of the sampled runs so far.
+    * Requires sampled profiling to be enabled with kOrtSessionOptionsConfigSampledProfilingInterval.
+    @param prometheus_text The histograms in the Prometheus text exposition format.
+    @return OK if success.
+    */
+  common::Status GetSampledProfile(std::string& prometheus_text) const;
+
+  /**
+    * Get the peak activation memory of the runs with the given input shapes.
+    * Requires recording to be enabled with kOrtSessionOptionsConfigRecordPeakMemoryUsage.
+    * Memory allocated by subgraphs and by kernels for their scratch buffers is not included.
+    @param input_shapes The shapes of the inputs of the runs, in the order of the model inputs.
+    @param planned_peak_bytes The size of the memory pattern planned for the input shapes, 0 if memory patterns
+      are disabled or not yet generated.
+    @param actual_peak_bytes The maximum of the peaks of the runs.
+    @return OK if success, or INVALID_ARGUMENT if recording is disabled or the session has no run with the input
+      shapes.
+    */
+  common::Status GetPeakMemoryUsage(gsl::span<const TensorShape> input_shapes,
+                                    size_t& planned_peak_bytes, size_t& actual_peak_bytes) const;
+
 #if !defined(ORT_MINIMAL_BUILD)
   /**
    * Get the TuningResults of TunableOp for every execution providers.
@@ -602,6 +650,12 @@ class InferenceSession {
 
   [[nodiscard]] common::Status SaveModelMetadata(const onnxruntime::Model& model);
 
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+  // Replaces the constant initializers of the partitioned graph with the ones shared by content
+  // between the sessions of the environment. See kOrtSessionOptionsConfigShareInitializersByContent.
+  [[nodiscard]] common::Status ShareInitializersByContent(const Graph& graph);
+#endif
+
 #if !defined(ORT_MINIMAL_BUILD)
 
   [[nodiscard]] common::Status LoadOnnxModel(const PathString& model_uri);
@@ -611,6 +665,13 @@ class InferenceSession {
   }
 
   common::Status SaveToOrtFormat(const PathString& filepath) const;
+
+  // Replaces the loaded ONNX model with its cached optimized model, if any. On a cache miss, sets
+  // optimized_model_cache_entry_ so Initialize saves the optimized model.
+  common::Status LoadFromOptimizedModelCache();
+
+  // Saves the optimized model to optimized_model_cache_entry_. Failures are logged, not returned.
+  void SaveToOptimizedModelCache() const;
 #endif
 
   /**
@@ -658,6 +719,18 @@ class InferenceSession {
                                                      const InputOutputDefMetaMap& input_output_meta_map,
                                                      ArgType arg_type) const;
 
+  // Validate only the values whose tensor type and shape differ from the previous run of prepared_run.
+  [[nodiscard]] common::Status ValidatePreparedRun(PreparedRun& prepared_run, gsl::span<const OrtValue> feeds,
+                                                   const std::vector<OrtValue>* p_fetches) const;
+
+  // Implementation of Run. prepared_run is nullptr unless called with a PreparedRun, in which case feed_names and
+  // output_names are the names it was created with.
+  [[nodiscard]] common::Status RunImpl(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                       gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                       std::vector<OrtValue>* p_fetches,
+                                       const std::vector<OrtDevice>* p_fetches_device_info,
+                                       PreparedRun* prepared_run);
+
   [[nodiscard]] common::Status WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms);
 
   template <typename T>
@@ -691,6 +764,12 @@ class InferenceSession {
   onnxruntime::GraphTransformerManager graph_transformer_mgr_;
 
   InlinedHashSet<gsl::not_null<const ONNX_NAMESPACE::OpSchema*>> saved_runtime_optimization_produced_node_op_schemas_;
+
+  // Hash of the loaded ONNX model bytes. Empty if the optimized model cache is not used.
+  std::string model_hash_for_optimized_model_cache_;
+
+  // The cache entry to save the optimized model to. Empty unless there was a cache miss.
+  PathString optimized_model_cache_entry_;
 #endif
   // Any GraphTransformer/RewriteRule name in this set will not be enabled.
   InlinedHashSet<std::string> optimizers_to_disable_;
@@ -712,10 +791,17 @@ class InferenceSession {
   // Profiler for this session.
   profiling::Profiler session_profiler_;
 
+  // Aggregates node latencies over a sample of the runs, if enabled.
+  std::unique_ptr<SampledProfiler> sampled_profiler_;
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   MemoryProfiler memory_profiler_;
 #endif
 
+  // The container of the pre-packed weights shared by content with the other sessions of the environment, released
+  // with the last of them. Declared before session_state_ as its kernels use the pre-packed buffers.
+  std::shared_ptr<PrepackedWeightsContainer> content_shared_prepacked_weights_container_;
+
   // Immutable state for each op in the model. Shared by all executors.
   // It has a dependency on execution_providers_.
   std::unique_ptr<SessionState> session_state_;
@@ -731,9 +817,17 @@ class InferenceSession {
   // Spinning is restarted on the next Run()
   bool force_spinning_stop_between_runs_ = false;
 
+  // Limit of the threads used by a parallel loop of a run, 0 if there is none.
+  // See kOrtSessionOptionsConfigIntraOpMaxDegreeOfParallelism.
+  int intra_op_max_degree_of_parallelism_ = 0;
+
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
+  // Runs RunAsync requests on dedicated threads when kOrtSessionOptionsConfigAsyncRunNumThreads is set.
+  std::basic_string<ORTCHAR_T> async_run_thread_pool_name_;
+  std::unique_ptr<AsyncRunScheduler> async_run_scheduler_;
+
   // Global threadpools. These are intialized and used when use_per_session_threads is false *and*
   // the environment is created with create_global_thread_pools = true.
   onnxruntime::concurrency::ThreadPool* intra_op_thread_pool_from_env_{};
@@ -840,6 +934,10 @@ class InferenceSession {
   // the cache is valid until any session reliant on it is still in scope.
   PrepackedWeightsContainer* prepacked_weights_container_ = nullptr;
 
+  // The initializers shared by content with the other sessions of the environment, held for the lifetime of the
+  // session so that sessions created later share them.
+  std::vector<std::shared_ptr<const OrtValue>> content_shared_initializers_;
+
   // Cache the EP instance if the user has configured the EP to capture a graph
   // for the model and all the necessary criteria for graph capture has been met.
   // At Run() time, if this member is not nullptr and the captured graph is ready
@@ -5,6 +5,21 @@
 
 #include "core/session/inference_session_utils.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+#include "core/common/cpuid_info.h"
+#include "core/flatbuffers/ort_format_version.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor_external_data_info.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
 namespace onnxruntime {
 
 //---------------------
@@ -264,6 +279,153 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
   return Status::OK();
 }
 
+void OptimizedModelCacheKeyHasher::Add(const void* data, size_t length) {
+  // MurmurHash3 takes an int length, so hash large buffers in chunks
+  constexpr size_t kMaxChunkLength = size_t{1} << 30;
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  do {
+    const size_t chunk_length = std::min(length, kMaxChunkLength);
+
+    // the seed of MurmurHash3 is 32 bits, so chain the chunks by hashing the 128-bit state with the hash of each
+    // chunk, to carry the whole state forward
+    uint32_t chained[8];
+    std::copy(std::begin(hash_), std::end(hash_), chained);
+    MurmurHash3::x86_128(bytes, gsl::narrow_cast<int>(chunk_length), 0, chained + 4);
+    MurmurHash3::x86_128(chained, static_cast<int>(sizeof(chained)), 0, &hash_);
+
+    bytes += chunk_length;
+    length -= chunk_length;
+  } while (length > 0);
+}
+
+Status OptimizedModelCacheKeyHasher::AddFile(const PathString& file_path) {
+  std::ifstream file(file_path, std::ifstream::in | std::ifstream::binary);
+  ORT_RETURN_IF_NOT(file, "Failed to open ", ToUTF8String(file_path), " to hash it.");
+
+  std::vector<char> buffer(size_t{1} << 20);
+  while (file) {
+    file.read(buffer.data(), buffer.size());
+    Add(buffer.data(), static_cast<size_t>(file.gcount()));
+  }
+
+  ORT_RETURN_IF_NOT(file.eof(), "Failed to read ", ToUTF8String(file_path), " to hash it.");
+  return Status::OK();
+}
+
+namespace {
+Status CollectExternalDataFiles(const Graph& graph, std::set<PathString>& files) {
+  for (const auto& [name, tensor_proto] : graph.GetAllInitializedTensors()) {
+    if (utils::HasExternalData(*tensor_proto)) {
+      std::unique_ptr<ExternalDataInfo> external_data_info;
+      ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto->external_data(), external_data_info));
+      files.insert(external_data_info->GetRelPath());
+    }
+  }
+
+  for (const auto& node : graph.Nodes()) {
+    for (const auto& subgraph : node.GetSubgraphs()) {
+      ORT_RETURN_IF_ERROR(CollectExternalDataFiles(*subgraph, files));
+    }
+  }
+
+  return Status::OK();
+}
+}  // namespace
+
+Status OptimizedModelCacheKeyHasher::AddExternalDataFiles(const Graph& graph, const PathString& model_dir) {
+  std::set<PathString> files;
+  ORT_RETURN_IF_ERROR(CollectExternalDataFiles(graph, files));
+
+  Add(files.size());
+  for (const auto& file : files) {
+    ORT_RETURN_IF(file == utils::kTensorProtoMemoryAddressTag, "The model has initializers with data in memory.");
+
+    const std::filesystem::path file_path = std::filesystem::path{model_dir} / file;
+    std::error_code error;
+    const auto file_size = std::filesystem::file_size(file_path, error);
+    ORT_RETURN_IF(error, "Failed to get the size of ", ToUTF8String(file_path.native()), ". ", error.message());
+    const auto write_time = std::filesystem::last_write_time(file_path, error);
+    ORT_RETURN_IF(error, "Failed to get the write time of ", ToUTF8String(file_path.native()), ". ",
+                  error.message());
+
+    const auto write_time_ticks = write_time.time_since_epoch().count();
+    Add(ToUTF8String(file_path.lexically_normal().native()));
+    Add(static_cast<size_t>(file_size));
+    Add(&write_time_ticks, sizeof(write_time_ticks));
+  }
+
+  return Status::OK();
+}
+
+std::string OptimizedModelCacheKeyHasher::HexDigest() const {
+  std::ostringstream ss;
+  for (const uint32_t part : hash_) {
+    ss << std::hex << std::setfill('0') << std::setw(8) << part;
+  }
+  return ss.str();
+}
+
+std::string GetOptimizedModelCacheEntryName(const std::string& model_hash,
+                                            const SessionOptions& session_options,
+                                            const InlinedHashSet<std::string>& optimizers_to_disable,
+                                            const ExecutionProviders& execution_providers) {
+  OptimizedModelCacheKeyHasher hasher;
+  hasher.Add(model_hash);
+  hasher.Add(std::string{ORT_VERSION});
+  hasher.Add(static_cast<size_t>(kOrtModelVersion));
+
+  hasher.Add(static_cast<size_t>(session_options.graph_optimization_level));
+
+  // hash the unordered values in a fixed order
+  const auto add_sorted = [&hasher](std::vector<std::string>&& values) {
+    std::sort(values.begin(), values.end());
+    hasher.Add(values.size());
+    for (const auto& value : values) {
+      hasher.Add(value);
+    }
+  };
+
+  std::vector<std::string> config_entries;
+  for (const auto& entry : session_options.config_options.configurations) {
+    // the location of the cache does not change its contents
+    if (entry.first != kOrtSessionOptionsConfigOptimizedModelCacheDir) {
+      config_entries.push_back(entry.first + "=" + entry.second);
+    }
+  }
+  add_sorted(std::move(config_entries));
+
+  add_sorted(std::vector<std::string>(optimizers_to_disable.begin(), optimizers_to_disable.end()));
+
+  hasher.Add(session_options.free_dimension_overrides.size());
+  for (const auto& dim_override : session_options.free_dimension_overrides) {
+    hasher.Add(dim_override.dim_identifier);
+    hasher.Add(static_cast<size_t>(dim_override.dim_identifer_type));
+    hasher.Add(static_cast<size_t>(dim_override.dim_value));
+  }
+
+  for (const auto& execution_provider : execution_providers) {
+    hasher.Add(execution_provider->Type());
+    std::vector<std::string> provider_options;
+    for (const auto& option : execution_provider->GetProviderOptions()) {
+      provider_options.push_back(option.first + "=" + option.second);
+    }
+    add_sorted(std::move(provider_options));
+  }
+
+  // the optimizers that depend on the hardware, e.g. the NchwcTransformer, check these
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  const bool cpu_features[] = {
+      cpuid_info.HasAVX(), cpuid_info.HasAVX2(), cpuid_info.HasAVX512f(), cpuid_info.HasAVX512_BF16(),
+      cpuid_info.HasAVX512Skylake(), cpuid_info.HasAMX_BF16(), cpuid_info.HasF16C(), cpuid_info.HasSSE3(),
+      cpuid_info.HasSSE4_1(), cpuid_info.HasArmNeonDot(), cpuid_info.HasArmNeon_I8MM(), cpuid_info.HasArmSVE_I8MM(),
+      cpuid_info.HasFp16VectorAcceleration()};
+  for (const bool has_feature : cpu_features) {
+    hasher.Add(static_cast<size_t>(has_feature));
+  }
+
+  return hasher.HexDigest() + ".ort";
+}
+
 }  // namespace inference_session_utils
 }  // namespace onnxruntime
 
@@ -62,6 +62,45 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
                                            /*out*/ std::vector<TuningResults>& results,
                                            /*out*/ bool& key_found);
 
+//
+// Code to key the entries of the optimized model cache, see kOrtSessionOptionsConfigOptimizedModelCacheDir
+//
+
+// Incrementally computes a 128-bit hash of a sequence of values, chaining the MurmurHash3 of each chunk of data with
+// the hash of the previous chunks.
+class OptimizedModelCacheKeyHasher {
+ public:
+  void Add(const void* data, size_t length);
+
+  // the length is hashed too so the boundaries between the values are part of the key
+  void Add(const std::string& value) {
+    Add(value.size());
+    Add(value.data(), value.size());
+  }
+
+  void Add(size_t value) { Add(&value, sizeof(value)); }
+
+  // Hashes the contents of a file.
+  Status AddFile(const PathString& file_path);
+
+  // Hashes the paths, sizes and write times of the files holding the external data of the initializers of graph and
+  // its subgraphs, so the key changes when they are updated. Fails if an initializer has its data in memory.
+  Status AddExternalDataFiles(const Graph& graph, const PathString& model_dir);
+
+  std::string HexDigest() const;
+
+ private:
+  uint32_t hash_[4] = {0, 0, 0, 0};
+};
+
+// Returns the name of the cache entry holding the optimized model for a model with the given hash, from everything
+// else that affects the optimized graph: the ORT and ORT format versions, the session options, the disabled
+// optimizers, the execution providers and their options, and the instruction set of the CPU.
+std::string GetOptimizedModelCacheEntryName(const std::string& model_hash,
+                                            const SessionOptions& session_options,
+                                            const InlinedHashSet<std::string>& optimizers_to_disable,
+                                            const ExecutionProviders& execution_providers);
+
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 }  // namespace inference_session_utils
@@ -8,6 +8,7 @@
 #include "core/framework/allocator.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/string_buffer.h"
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/utils.h"
 #include <cassert>
@@ -31,6 +32,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/session/inference_session.h"
+#include "core/session/prepared_run.h"
 #include "core/session/ort_apis.h"
 #include "core/session/ort_env.h"
 #include "core/framework/data_types.h"
@@ -895,6 +897,68 @@ ORT_API_STATUS_IMPL(OrtApis::RunWithBinding, _Inout_ OrtSession* sess, _In_ cons
   API_IMPL_END
 }
 
+struct OrtPreparedRun {
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run_;
+  explicit OrtPreparedRun(std::unique_ptr<::onnxruntime::PreparedRun>&& prepared_run)
+      : prepared_run_(std::move(prepared_run)) {}
+  OrtPreparedRun(const OrtPreparedRun&) = delete;
+  OrtPreparedRun& operator=(const OrtPreparedRun&) = delete;
+};
+
+ORT_API_STATUS_IMPL(OrtApis::CreatePreparedRun, _In_ const OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+
+  auto to_names = [](const char* const* names, size_t len, const char* moniker, InlinedVector<std::string>& result) {
+    result.reserve(len);
+    for (size_t i = 0; i != len; ++i) {
+      if (names[i] == nullptr || names[i][0] == '\0') {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, moniker, " name cannot be empty");
+      }
+      result.emplace_back(names[i]);
+    }
+    return Status::OK();
+  };
+
+  InlinedVector<std::string> input_name_vec;
+  InlinedVector<std::string> output_name_vec;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(to_names(input_names, input_len, "input", input_name_vec));
+  ORT_API_RETURN_IF_STATUS_NOT_OK(to_names(output_names, output_names_len, "output", output_name_vec));
+
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->NewPreparedRun(input_name_vec, output_name_vec, prepared_run));
+  *out = std::make_unique<OrtPreparedRun>(std::move(prepared_run)).release();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ReleasePreparedRun, _Frees_ptr_opt_ OrtPreparedRun* prepared_run) {
+  delete prepared_run;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    size_t output_len, _Inout_updates_all_(output_len) OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  gsl::span<const OrtValue* const> input_span(input, input_len);
+  gsl::span<OrtValue*> output_span(output, output_len);
+
+  Status status;
+  if (run_options) {
+    status = session->Run(*run_options, *prepared_run->prepared_run_, input_span, output_span);
+  } else {
+    const RunOptions default_run_options;
+    status = session->Run(default_run_options, *prepared_run->prepared_run_, input_span, output_span);
+  }
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::CreateIoBinding, _Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out) {
   API_IMPL_BEGIN
   auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
@@ -1104,6 +1168,23 @@ ORT_API_STATUS_IMPL(OrtApis::FillStringTensor, _Inout_ OrtValue* value, _In_ con
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::FillStringTensorFromBuffer, _Inout_ OrtValue* value, _In_reads_bytes_(s_len) const void* s,
+                    size_t s_len, _In_reads_(offsets_len) const size_t* offsets, size_t offsets_len) {
+  TENSOR_READWRITE_API_BEGIN
+  auto* dst = tensor->MutableData<std::string>();
+  const auto len = static_cast<size_t>(tensor->Shape().Size());
+  if (offsets_len != len) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "offsets array doesn't equal tensor size");
+  }
+
+  StringBufferView strings;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(StringBufferView::Create(static_cast<const char*>(s), s_len,
+                                                          gsl::make_span(offsets, offsets_len), strings));
+  strings.CopyTo(0, gsl::make_span(dst, len));
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::FillStringTensorElement, _Inout_ OrtValue* value, _In_ const char* s, size_t index) {
   TENSOR_READWRITE_API_BEGIN
   auto* dst = tensor->MutableData<std::string>();
@@ -1364,6 +1445,33 @@ ORT_API_STATUS_IMPL(OrtApis::SessionEndProfiling, _In_ OrtSession* sess, _Inout_
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetSampledProfile, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string prometheus_text;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetSampledProfile(prometheus_text));
+  *out = StrDup(prometheus_text, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetPeakMemoryUsage, _In_ const OrtSession* sess,
+                    _In_reads_(num_inputs) const int64_t* const* input_shapes,
+                    _In_reads_(num_inputs) const size_t* input_shape_lens, size_t num_inputs,
+                    _Out_ size_t* planned_peak_bytes, _Out_ size_t* actual_peak_bytes) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  InlinedVector<TensorShape> shapes;
+  shapes.reserve(num_inputs);
+  for (size_t i = 0; i != num_inputs; ++i) {
+    shapes.emplace_back(input_shapes[i], input_shape_lens[i]);
+  }
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetPeakMemoryUsage(shapes, *planned_peak_bytes, *actual_peak_bytes));
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::SessionGetModelMetadata, _In_ const OrtSession* sess,
                     _Outptr_ OrtModelMetadata** out) {
   API_IMPL_BEGIN
@@ -2721,6 +2829,12 @@ static constexpr OrtApi ort_api_1_to_17 = {
     &OrtApis::ShapeInferContext_SetOutputTypeShape,
     &OrtApis::SetSymbolicDimensions,
     &OrtApis::ReadOpAttr,
+    &OrtApis::FillStringTensorFromBuffer,
+    &OrtApis::CreatePreparedRun,
+    &OrtApis::ReleasePreparedRun,
+    &OrtApis::RunPrepared,
+    &OrtApis::SessionGetSampledProfile,
+    &OrtApis::SessionGetPeakMemoryUsage,
 };
 
 // OrtApiBase can never change as there is no way to know what version of OrtApiBase is returned by OrtGetApiBase.
@@ -500,5 +500,22 @@ ORT_API_STATUS_IMPL(ShapeInferContext_GetAttribute, _In_ const OrtShapeInferCont
 ORT_API_STATUS_IMPL(ShapeInferContext_SetOutputTypeShape, _In_ const OrtShapeInferContext* context, _In_ size_t index, _In_ const OrtTensorTypeAndShapeInfo* info);
 ORT_API_STATUS_IMPL(SetSymbolicDimensions, _In_ OrtTensorTypeAndShapeInfo* info, _In_ const char* dim_params[], _In_ size_t dim_params_length);
 ORT_API_STATUS_IMPL(ReadOpAttr, _In_ const OrtOpAttr* op_attr, _In_ OrtOpAttrType type, _Inout_ void* data, _In_ size_t len, _Out_ size_t* out);
+ORT_API_STATUS_IMPL(FillStringTensorFromBuffer, _Inout_ OrtValue* value, _In_reads_bytes_(s_len) const void* s,
+                    size_t s_len, _In_reads_(offsets_len) const size_t* offsets, size_t offsets_len);
+ORT_API_STATUS_IMPL(CreatePreparedRun, _In_ const OrtSession* session,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out);
+ORT_API(void, ReleasePreparedRun, _Frees_ptr_opt_ OrtPreparedRun* prepared_run);
+ORT_API_STATUS_IMPL(RunPrepared, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    size_t output_len, _Inout_updates_all_(output_len) OrtValue** output);
+ORT_API_STATUS_IMPL(SessionGetSampledProfile, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+ORT_API_STATUS_IMPL(SessionGetPeakMemoryUsage, _In_ const OrtSession* session,
+                    _In_reads_(num_inputs) const int64_t* const* input_shapes,
+                    _In_reads_(num_inputs) const size_t* input_shape_lens, size_t num_inputs,
+                    _Out_ size_t* planned_peak_bytes, _Out_ size_t* actual_peak_bytes);
 
 }  // namespace OrtApis
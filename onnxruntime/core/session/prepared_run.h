@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/data_types.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+class InferenceSession;
+
+/**
+ * The feed and fetch names of a Run resolved against an InferenceSession once.
+ *
+ * Runs with a PreparedRun take values in the order of the names it was created with and skip the name lookups,
+ * the creation of a FeedsFetchesManager and the validation of any value whose type and shape match the previous
+ * run. Create with InferenceSession::NewPreparedRun.
+ *
+ * As with IOBinding, an instance holds per-run state and must not be used by concurrent Run calls.
+ * Create one per thread instead.
+ */
+class PreparedRun {
+ public:
+  PreparedRun(const InferenceSession& session, FeedsFetchesInfo&& info)
+      : session_(session),
+        feeds_fetches_manager_(std::move(info)),
+        feed_signatures_(feeds_fetches_manager_.GetFeedsFetchesInfo().feed_names.size()),
+        fetch_signatures_(feeds_fetches_manager_.GetFeedsFetchesInfo().output_names.size()) {}
+
+  gsl::span<const std::string> GetFeedNames() const {
+    return feeds_fetches_manager_.GetFeedsFetchesInfo().feed_names;
+  }
+
+  gsl::span<const std::string> GetOutputNames() const {
+    return feeds_fetches_manager_.GetFeedsFetchesInfo().output_names;
+  }
+
+ private:
+  friend class InferenceSession;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+
+  // Type and shape of a tensor value that was last validated at a given position.
+  struct ValueSignature {
+    MLDataType element_type = nullptr;
+    TensorShape shape;
+  };
+
+  // Returns true if value is a tensor with the same element type and shape as the one last recorded in signature.
+  // Otherwise records the value's signature (if it is a tensor) and returns false so the caller validates it.
+  static bool MatchesSignature(const OrtValue& value, ValueSignature& signature) {
+    if (!value.IsTensor()) {
+      signature.element_type = nullptr;
+      return false;
+    }
+
+    const auto& tensor = value.Get<Tensor>();
+    if (signature.element_type == tensor.DataType() && signature.shape == tensor.Shape()) {
+      return true;
+    }
+
+    signature.element_type = tensor.DataType();
+    signature.shape = tensor.Shape();
+    return false;
+  }
+
+  // Forget recorded signatures, e.g. after a failed validation.
+  void ResetSignatures() {
+    for (auto& signature : feed_signatures_) signature.element_type = nullptr;
+    for (auto& signature : fetch_signatures_) signature.element_type = nullptr;
+  }
+
+  const InferenceSession& session_;
+  FeedsFetchesManager feeds_fetches_manager_;
+  std::vector<ValueSignature> feed_signatures_;
+  std::vector<ValueSignature> fetch_signatures_;
+};
+}  // namespace onnxruntime
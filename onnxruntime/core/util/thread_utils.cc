@@ -18,9 +18,12 @@ std::ostream& operator<<(std::ostream& os, const OrtThreadPoolParams& params) {
   os << " thread_pool_size: " << params.thread_pool_size;
   os << " auto_set_affinity: " << params.auto_set_affinity;
   os << " allow_spinning: " << params.allow_spinning;
+  os << " adaptive_spinning: " << params.adaptive_spinning;
   os << " dynamic_block_base_: " << params.dynamic_block_base_;
+  os << " guided_scheduling: " << params.guided_scheduling;
   os << " stack_size: " << params.stack_size;
   os << " affinity_str: " << params.affinity_str;
+  os << " numa_node: " << params.numa_node;
   // os << " name: " << (params.name ? params.name : L"nullptr");
   os << " set_denormal_as_zero: " << params.set_denormal_as_zero;
   // os << " custom_create_thread_fn: " << (params.custom_create_thread_fn ? "set" : "nullptr");
@@ -91,7 +94,26 @@ static std::vector<LogicalProcessors> ReadThreadAffinityConfig(const std::string
 static std::unique_ptr<ThreadPool>
 CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   ThreadOptions to;
-  if (options.thread_pool_size <= 0) {  // default
+  std::vector<LogicalProcessors> numa_node_affinities;
+  if (options.numa_node >= 0 && options.affinity_str.empty()) {
+    numa_node_affinities = Env::Default().GetNumaNodeThreadAffinities(options.numa_node);
+    if (numa_node_affinities.empty()) {
+      LOGS_DEFAULT(WARNING) << "NUMA node " << options.numa_node
+                            << " is not available, the thread pool will not be bound to it";
+    }
+  }
+
+  if (!numa_node_affinities.empty()) {
+    if (options.thread_pool_size <= 0) {
+      options.thread_pool_size = static_cast<int>(numa_node_affinities.size());
+    }
+    // as with the default affinities the first entry belongs to the calling thread and is dropped by the pool.
+    // more threads than cores in the node share the cores round robin.
+    to.affinities.reserve(options.thread_pool_size);
+    for (int i = 0; i < options.thread_pool_size; ++i) {
+      to.affinities.push_back(numa_node_affinities[i % numa_node_affinities.size()]);
+    }
+  } else if (options.thread_pool_size <= 0) {  // default
     auto default_affinities = Env::Default().GetDefaultThreadAffinities();
     if (default_affinities.size() <= 1) {
       return nullptr;
@@ -132,6 +154,8 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   to.custom_thread_creation_options = options.custom_thread_creation_options;
   to.custom_join_thread_fn = options.custom_join_thread_fn;
   to.dynamic_block_base_ = options.dynamic_block_base_;
+  to.guided_scheduling = options.guided_scheduling;
+  to.adaptive_spinning = options.adaptive_spinning;
   if (to.custom_create_thread_fn) {
     ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set");
   }
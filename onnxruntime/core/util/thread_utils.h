@@ -21,10 +21,18 @@ struct OrtThreadPoolParams {
   // If it is true, the thread pool will spin a while after the queue became empty.
   bool allow_spinning = true;
 
+  // If it is true, each thread adapts how long it spins to the gaps between the work it receives.
+  // Only used when allow_spinning is true.
+  bool adaptive_spinning = false;
+
   // It it is non-negative, thread pool will split a task by a decreasing block size
   // of remaining_of_total_iterations / (num_of_threads * dynamic_block_base_)
   int dynamic_block_base_ = 0;
 
+  // If it is true and the CPU is hybrid, parallel loops claim shrinking shares of the remaining iterations instead of
+  // fixed blocks. Not used when dynamic_block_base_ is positive.
+  bool guided_scheduling = false;
+
   unsigned int stack_size = 0;
 
   // A utf-8 string of affinity settings, format be like:
@@ -37,6 +45,10 @@ struct OrtThreadPoolParams {
   // meaning ith thread will be attached to first 8 logical processors
   std::string affinity_str;
 
+  // If it is non-negative, bind the threads to the physical cores of this NUMA node, one thread per core.
+  // thread_pool_size = 0 then means one thread per core of the node. Ignored if affinity_str is set.
+  int numa_node = -1;
+
   const ORTCHAR_T* name = nullptr;
 
   // Set or unset denormal as zero
@@ -0,0 +1,186 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/async_run_scheduler.h"
+
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Records the requests completed by a scheduler and waits for them.
+class CompletedRequests {
+ public:
+  AsyncRunScheduler::RunFn Record(std::string name) {
+    return [this, name = std::move(name)](const Status& status) {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      completed_.push_back({name, status.IsOK(), std::this_thread::get_id()});
+      cv_.notify_all();
+    };
+  }
+
+  struct Request {
+    std::string name;
+    bool ok;
+    std::thread::id thread_id;
+  };
+
+  std::vector<Request> WaitFor(size_t num_requests) {
+    std::unique_lock<OrtMutex> lock(mutex_);
+    cv_.wait(lock, [&]() { return completed_.size() >= num_requests; });
+    return completed_;
+  }
+
+ private:
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  std::vector<Request> completed_;
+};
+
+OrtThreadPoolParams SingleThreadParams() {
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 1;
+  return to;
+}
+
+// Submits a request that occupies the only worker until the returned promise is set.
+std::promise<void> BlockWorker(AsyncRunScheduler& scheduler) {
+  std::promise<void> release;
+  auto started = std::make_shared<std::promise<void>>();
+  auto started_future = started->get_future();
+  ORT_THROW_IF_ERROR(scheduler.Submit(0, std::nullopt,
+                                      [started, release_future = release.get_future().share()](const Status&) {
+                                        started->set_value();
+                                        release_future.wait();
+                                      }));
+  started_future.wait();
+  return release;
+}
+
+}  // namespace
+
+TEST(AsyncRunSchedulerTest, RunsRequestsInPriorityOrder) {
+  CompletedRequests completed;
+  AsyncRunScheduler scheduler(SingleThreadParams(), 0);
+  auto release = BlockWorker(scheduler);
+
+  ASSERT_STATUS_OK(scheduler.Submit(0, std::nullopt, completed.Record("low_first")));
+  ASSERT_STATUS_OK(scheduler.Submit(2, std::nullopt, completed.Record("high")));
+  ASSERT_STATUS_OK(scheduler.Submit(0, std::nullopt, completed.Record("low_second")));
+  ASSERT_STATUS_OK(scheduler.Submit(1, std::nullopt, completed.Record("medium")));
+  EXPECT_EQ(scheduler.QueueDepth(), 4u);
+  release.set_value();
+
+  const auto requests = completed.WaitFor(4);
+  std::vector<std::string> order;
+  for (const auto& request : requests) {
+    EXPECT_TRUE(request.ok);
+    // Submit queues the request, it never runs on the calling thread
+    EXPECT_NE(request.thread_id, std::this_thread::get_id());
+    order.push_back(request.name);
+  }
+  EXPECT_EQ(order, (std::vector<std::string>{"high", "medium", "low_first", "low_second"}));
+}
+
+TEST(AsyncRunSchedulerTest, QueuesBurstLargerThanThreadPoolQueues) {
+  // more requests than the 1024 tasks a thread pool worker queues, past which a scheduled task runs inline
+  constexpr size_t num_requests = 2000;
+  CompletedRequests completed;
+  AsyncRunScheduler scheduler(SingleThreadParams(), 0);
+  auto release = BlockWorker(scheduler);
+
+  for (size_t i = 0; i < num_requests; ++i) {
+    ASSERT_STATUS_OK(scheduler.Submit(0, std::nullopt, completed.Record(std::to_string(i))));
+  }
+  EXPECT_EQ(scheduler.QueueDepth(), num_requests);
+  release.set_value();
+
+  const auto requests = completed.WaitFor(num_requests);
+  ASSERT_EQ(requests.size(), num_requests);
+  for (const auto& request : requests) {
+    EXPECT_NE(request.thread_id, std::this_thread::get_id());
+  }
+}
+
+TEST(AsyncRunSchedulerTest, RejectsRequestsWhenQueueIsFull) {
+  CompletedRequests completed;
+  AsyncRunScheduler scheduler(SingleThreadParams(), 2);
+  auto release = BlockWorker(scheduler);
+
+  ASSERT_STATUS_OK(scheduler.Submit(0, std::nullopt, completed.Record("first")));
+  ASSERT_STATUS_OK(scheduler.Submit(0, std::nullopt, completed.Record("second")));
+  bool rejected_run = false;
+  EXPECT_FALSE(scheduler.Submit(0, std::nullopt, [&rejected_run](const Status&) { rejected_run = true; }).IsOK());
+  EXPECT_EQ(scheduler.QueueDepth(), 2u);
+  release.set_value();
+
+  const auto requests = completed.WaitFor(2);
+  ASSERT_EQ(requests.size(), 2u);
+  EXPECT_TRUE(requests[0].ok);
+  EXPECT_TRUE(requests[1].ok);
+  EXPECT_FALSE(rejected_run);
+
+  // the queue accepts requests again once it has room
+  ASSERT_STATUS_OK(scheduler.Submit(0, std::nullopt, completed.Record("third")));
+  EXPECT_EQ(completed.WaitFor(3).size(), 3u);
+}
+
+TEST(AsyncRunSchedulerTest, CompletesExpiredRequestsWithError) {
+  CompletedRequests completed;
+  AsyncRunScheduler scheduler(SingleThreadParams(), 0);
+  auto release = BlockWorker(scheduler);
+
+  const auto now = AsyncRunScheduler::Clock::now();
+  ASSERT_STATUS_OK(scheduler.Submit(0, now + std::chrono::milliseconds(1), completed.Record("expired")));
+  ASSERT_STATUS_OK(scheduler.Submit(0, now + std::chrono::hours(1), completed.Record("in_time")));
+  ASSERT_STATUS_OK(scheduler.Submit(0, std::nullopt, completed.Record("no_deadline")));
+  // the first deadline passes while the worker is busy
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  release.set_value();
+
+  const auto requests = completed.WaitFor(3);
+  ASSERT_EQ(requests.size(), 3u);
+  EXPECT_EQ(requests[0].name, "expired");
+  EXPECT_FALSE(requests[0].ok);
+  EXPECT_EQ(requests[1].name, "in_time");
+  EXPECT_TRUE(requests[1].ok);
+  EXPECT_EQ(requests[2].name, "no_deadline");
+  EXPECT_TRUE(requests[2].ok);
+}
+
+TEST(AsyncRunSchedulerTest, CompletesQueuedRequestsWithErrorOnDestruction) {
+  CompletedRequests completed;
+  std::optional<AsyncRunScheduler> scheduler;
+  scheduler.emplace(SingleThreadParams(), 0);
+  auto release = BlockWorker(*scheduler);
+  ASSERT_STATUS_OK(scheduler->Submit(0, std::nullopt, completed.Record("queued")));
+
+  // the destructor waits for the blocked request, so release it once the scheduler stops accepting requests
+  // the optional is disengaged before the destructor runs, so the releaser must not go through it
+  AsyncRunScheduler* stopping = &*scheduler;
+  std::thread releaser([stopping, &release]() {
+    while (stopping->Submit(0, std::nullopt, [](const Status&) {}).IsOK()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    release.set_value();
+  });
+  scheduler.reset();
+  releaser.join();
+
+  const auto requests = completed.WaitFor(1);
+  ASSERT_EQ(requests.size(), 1u);
+  EXPECT_FALSE(requests[0].ok);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
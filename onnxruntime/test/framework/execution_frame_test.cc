@@ -8,6 +8,7 @@
 #include "core/graph/model.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test_utils.h"
 #include "test/test_environment.h"
 #include "test/framework/TestAllocatorManager.h"
@@ -330,6 +331,120 @@ TEST_F(ExecutionFrameTest, MemPatternTest) {
   ASSERT_EQ(p->GetBlock(4)->offset_, kAllocAlignment);
 }
 
+// The memory patterns are planned from the symbolic shapes, without tracing an execution, for each new batch size.
+TEST_F(ExecutionFrameTest, StaticMemPatternTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  // a row count of -1 makes a tensor with a symbolic number of rows
+  auto make_type = [](int64_t rows, int64_t columns) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    auto* shape = type.mutable_tensor_type()->mutable_shape();
+    if (rows == -1) {
+      shape->add_dim()->set_dim_param("batch");
+    } else {
+      shape->add_dim()->set_dim_value(rows);
+    }
+    shape->add_dim()->set_dim_value(columns);
+    return type;
+  };
+  TypeProto tensor_x1 = make_type(-1, 2), tensor_x2 = make_type(2, 2), tensor_x3 = make_type(2, 3);
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &tensor_x1),
+      input_def2("X2", &tensor_x2),
+      input_def3("X3", &tensor_x3),
+      gemm1_out_def("T1", &tensor_float),
+      gemm2_out_def("T2", &tensor_float),
+      clip_out_def("T3", &tensor_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "MatMul", "gemm2", ArgMap{&gemm1_out_def, &input_def3}, ArgMap{&gemm2_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "Clip", "clip1", ArgMap{&gemm2_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_type, std::move(cpu_xp)));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigStaticMemoryPlanning, "1"));
+
+  SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                     DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map(state.GetOrtValueNameIdxMap());
+
+  int x1_idx = -1, x2_idx = -1, x3_idx = -1;
+  int t1_idx = -1, t2_idx = -1, t3_idx = -1;
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X1", x1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X2", x2_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X3", x3_idx).IsOK());
+
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T1", t1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T2", t2_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T3", t3_idx).IsOK());
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->CreatePreferredAllocators()[0];
+
+  for (int64_t batch : {1, 16}) {
+    OrtValue v1, v2, v3;
+    CreateMLValue<float>(cpu_allocator,
+                         std::vector<int64_t>{batch, 2},
+                         std::vector<float>(static_cast<size_t>(batch * 2), 1.0f), &v1);
+    CreateMLValue<float>(cpu_allocator,
+                         std::vector<int64_t>{2, 2},
+                         std::vector<float>(4, 1.0f), &v2);
+    CreateMLValue<float>(cpu_allocator,
+                         std::vector<int64_t>{2, 3},
+                         std::vector<float>(6, 1.0f), &v3);
+
+    const InlinedHashMap<int, TensorShape>* inferred_shapes = nullptr;
+    std::vector<OrtValue> feeds{v1, v2, v3};
+    std::vector<int> feed_idxs{x1_idx, x2_idx, x3_idx};
+    std::vector<int> fetch_idxs{t3_idx};
+    const MemoryPatternGroup* pattern_group = state.GetMemoryPatternGroup(feeds, feed_idxs, fetch_idxs,
+                                                                          inferred_shapes);
+    ASSERT_NE(pattern_group, nullptr);
+
+    // T1 is released after T2 is allocated, so the two are planned next to each other.
+    auto p = pattern_group->GetPatterns(cpu_allocator->Info().device);
+    ASSERT_NE(p, nullptr);
+    const size_t t1_size = ((static_cast<size_t>(batch) * 2 * sizeof(float) + kAllocAlignment - 1) /
+                            kAllocAlignment) *
+                           kAllocAlignment;
+    const size_t t2_size = ((static_cast<size_t>(batch) * 3 * sizeof(float) + kAllocAlignment - 1) /
+                            kAllocAlignment) *
+                           kAllocAlignment;
+    ASSERT_EQ(p->PeakSize(), t1_size + t2_size);
+    ASSERT_EQ(p->GetBlock(t1_idx)->offset_, 0u);
+    ASSERT_EQ(p->GetBlock(t1_idx)->size_, t1_size);
+    ASSERT_EQ(p->GetBlock(t2_idx)->offset_, t1_size);
+    ASSERT_EQ(p->GetBlock(t2_idx)->size_, t2_size);
+    ASSERT_EQ(p->GetBlock(t3_idx), nullptr);
+  }
+}
+
 #ifdef ENABLE_TRAINING
 TEST_F(ExecutionFrameTest, MemPatternWithExternalOutputsTest) {
   auto cpu_xp = CreateCPUExecutionProvider();
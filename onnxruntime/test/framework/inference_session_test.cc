@@ -6,8 +6,12 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <filesystem>
 #include <functional>
 #include <iterator>
+#include <map>
+#include <numeric>
+#include <sstream>
 #include <thread>
 #include <fstream>
 
@@ -47,6 +51,7 @@
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
+#include "core/session/prepared_run.h"
 #include "dummy_provider.h"
 #include "test_utils.h"
 #include "test/capturing_sink.h"
@@ -55,6 +60,7 @@
 #include "test/optimizer/dummy_graph_transformer.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/inference_session_wrapper.h"
+#include "test/util/include/temp_dir.h"
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -413,6 +419,114 @@ TEST(InferenceSessionTests, OnlyExecutePathToFetches) {
   RunModel(session_object, run_options);
 }
 
+// alloc_tensor_reuse.onnx computes outp0 = Neg(inp0 + inp1) and outp1 = Neg(inp0 - inp1), and the output of Sub
+// reuses the buffer of the output of Add. Runs fetching one output skip the branch of the other.
+TEST(InferenceSessionTests, PruneToFetches) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PruneToFetches";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigPruneToFetches, "1"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/alloc_tensor_reuse.onnx")));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  std::vector<int64_t> dims = {10};
+  OrtValue inp0, inp1;
+  CreateMLValue<float>(allocator, dims, std::vector<float>(10, 3.0f), &inp0);
+  CreateMLValue<float>(allocator, dims, std::vector<float>(10, 1.0f), &inp1);
+  NameMLValMap feeds{{"inp0", inp0}, {"inp1", inp1}};
+
+  const std::vector<float> expected_outp0(10, -4.0f);
+  const std::vector<float> expected_outp1(10, -2.0f);
+
+  RunOptions run_options;
+  // run each set of fetches twice so the second run uses the cached memory patterns
+  for (int i = 0; i < 2; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(run_options, feeds, {"outp0"}, &fetches));
+    VerifyOutputs(fetches, dims, expected_outp0);
+
+    fetches.clear();
+    ASSERT_STATUS_OK(session_object.Run(run_options, feeds, {"outp1"}, &fetches));
+    VerifyOutputs(fetches, dims, expected_outp1);
+
+    fetches.clear();
+    ASSERT_STATUS_OK(session_object.Run(run_options, feeds, {"outp1", "outp0"}, &fetches));
+    ASSERT_EQ(fetches.size(), 2u);
+    VerifyOutputs(fetches[0].Get<Tensor>(), dims, expected_outp1);
+    VerifyOutputs(fetches[1].Get<Tensor>(), dims, expected_outp0);
+  }
+
+  // a prepared run looks up the nodes to execute on its first run only
+  std::unique_ptr<PreparedRun> prepared_run;
+  ASSERT_STATUS_OK(session_object.NewPreparedRun(std::vector<std::string>{"inp0", "inp1"},
+                                                 std::vector<std::string>{"outp1"}, prepared_run));
+  for (int i = 0; i < 2; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(run_options, *prepared_run, std::vector<OrtValue>{inp0, inp1}, &fetches));
+    VerifyOutputs(fetches, dims, expected_outp1);
+  }
+}
+
+#if !defined(__wasm__)
+// Counts the kernels of each op type run by a session fetching only outp0 of alloc_tensor_reuse.onnx, from the
+// kernel events of the profile.
+static void CountKernelsRunForOutp0(bool prune_to_fetches, std::map<std::string, int>& op_counts) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PruneToFetchesSkipsNodes";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_prune_to_fetches_test");
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigPruneToFetches,
+                                                    prune_to_fetches ? "1" : "0"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/alloc_tensor_reuse.onnx")));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  std::vector<int64_t> dims = {10};
+  OrtValue inp0, inp1;
+  CreateMLValue<float>(allocator, dims, std::vector<float>(10, 3.0f), &inp0);
+  CreateMLValue<float>(allocator, dims, std::vector<float>(10, 1.0f), &inp1);
+  NameMLValMap feeds{{"inp0", inp0}, {"inp1", inp1}};
+
+  RunOptions run_options;
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(run_options, feeds, {"outp0"}, &fetches));
+  VerifyOutputs(fetches, dims, std::vector<float>(10, -4.0f));
+
+  std::ifstream profile(session_object.EndProfiling());
+  ASSERT_TRUE(profile);
+  std::string line;
+  while (std::getline(profile, line)) {
+    if (line.find("_kernel_time") == std::string::npos) {
+      continue;
+    }
+    for (const char* op_type : {"Add", "Sub", "Neg"}) {
+      if (line.find(std::string("\"op_name\" : \"") + op_type + "\"") != std::string::npos) {
+        ++op_counts[op_type];
+      }
+    }
+  }
+}
+
+// outp0 = Neg(inp0 + inp1) doesn't need the Sub and Neg nodes computing outp1.
+TEST(InferenceSessionTests, PruneToFetchesSkipsNodes) {
+  std::map<std::string, int> pruned_op_counts;
+  ASSERT_NO_FATAL_FAILURE(CountKernelsRunForOutp0(true, pruned_op_counts));
+  EXPECT_EQ(pruned_op_counts["Add"], 1);
+  EXPECT_EQ(pruned_op_counts["Sub"], 0);
+  EXPECT_EQ(pruned_op_counts["Neg"], 1);
+
+  std::map<std::string, int> op_counts;
+  ASSERT_NO_FATAL_FAILURE(CountKernelsRunForOutp0(false, op_counts));
+  EXPECT_EQ(op_counts["Add"], 1);
+  EXPECT_EQ(op_counts["Sub"], 1);
+  EXPECT_EQ(op_counts["Neg"], 2);
+}
+#endif
+
 TEST(InferenceSessionTests, DisableCPUArena) {
   SessionOptions so;
 
@@ -490,6 +604,77 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 }
 
+TEST(InferenceSessionTests, OptimizedModelCache) {
+  const PathString cache_dir = ORT_TSTR("optimized_model_cache_test_dir");
+  TemporaryDirectory temp_dir{cache_dir};
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCache";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    ToUTF8String(cache_dir).c_str()));
+
+  auto get_cache_entries = [&cache_dir]() {
+    std::vector<std::filesystem::path> entries;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+      entries.push_back(entry.path());
+    }
+    return entries;
+  };
+
+  auto create_session = [&test_model](const SessionOptions& session_options) {
+    InferenceSessionWrapper session{session_options, GetEnvironment()};
+    ASSERT_STATUS_OK(session.Load(test_model));
+    ASSERT_STATUS_OK(session.Initialize());
+    ASSERT_EQ(CountOpsInGraph(session.GetGraph())["Identity"], 0);
+  };
+
+  // the first session saves the optimized model
+  create_session(so);
+  auto entries = get_cache_entries();
+  ASSERT_EQ(entries.size(), 1u);
+  const auto entry_write_time = std::filesystem::last_write_time(entries[0]);
+
+  // the second session loads it and leaves the entry as is
+  create_session(so);
+  ASSERT_EQ(get_cache_entries(), entries);
+  ASSERT_EQ(std::filesystem::last_write_time(entries[0]), entry_write_time);
+
+  // the graph of a valid entry is used as is. replace the entry with an unoptimized ORT format model to tell
+  {
+    SessionOptions so_unoptimized;
+    so_unoptimized.graph_optimization_level = TransformerLevel::Default;
+    so_unoptimized.optimized_model_filepath = (std::filesystem::path{cache_dir} / "unoptimized.tmp").native();
+    ASSERT_STATUS_OK(so_unoptimized.config_options.AddConfigEntry(kOrtSessionOptionsConfigSaveModelFormat, "ORT"));
+    InferenceSession session{so_unoptimized, GetEnvironment()};
+    ASSERT_STATUS_OK(session.Load(test_model));
+    ASSERT_STATUS_OK(session.Initialize());
+    std::filesystem::rename(so_unoptimized.optimized_model_filepath, entries[0]);
+
+    InferenceSessionWrapper cached_session{so, GetEnvironment()};
+    ASSERT_STATUS_OK(cached_session.Load(test_model));
+    ASSERT_STATUS_OK(cached_session.Initialize());
+    ASSERT_EQ(CountOpsInGraph(cached_session.GetGraph())["Identity"], 1);
+    std::filesystem::remove(entries[0]);
+    create_session(so);
+  }
+
+  // a different optimization level is a different entry
+  SessionOptions so_level2 = so;
+  so_level2.graph_optimization_level = TransformerLevel::Level2;
+  create_session(so_level2);
+  ASSERT_EQ(get_cache_entries().size(), 2u);
+
+  // an entry that fails to load is replaced
+  {
+    std::ofstream corrupted_entry(entries[0], std::ios::binary | std::ios::trunc);
+    corrupted_entry << "not an ORT format model";
+  }
+  create_session(so);
+  ASSERT_GT(std::filesystem::file_size(entries[0]), 32u);
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -2833,6 +3018,79 @@ TEST(InferenceSessionTests, InitializerSharing_EnsureSessionsUseUserAddedInitial
   }
 }
 
+// A MatMul with a constant 32x32 weight, large enough to be shared by content and pre-packed
+static std::string CreateMatMulModelWithWeight(const std::vector<float>& weight) {
+  onnxruntime::Model model("matmul", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(32);
+
+  auto& input = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& weight_arg = graph.GetOrCreateNodeArg("W", nullptr);
+  auto& output = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("matmul", "MatMul", "MatMul with constant weight", {&input, &weight_arg}, {&output});
+
+  ONNX_NAMESPACE::TensorProto weight_proto;
+  weight_proto.set_name("W");
+  weight_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  weight_proto.add_dims(32);
+  weight_proto.add_dims(32);
+  weight_proto.set_raw_data(weight.data(), weight.size() * sizeof(float));
+  graph.AddInitializedTensor(weight_proto);
+
+  ORT_ENFORCE(graph.Resolve().IsOK());
+  std::string model_bytes;
+  model.ToProto().SerializeToString(&model_bytes);
+  return model_bytes;
+}
+
+TEST(InferenceSessionTests, InitializerSharing_SharesIdenticalInitializersByContent) {
+  std::vector<float> weight(32 * 32);
+  std::iota(weight.begin(), weight.end(), 0.f);
+  std::vector<float> other_weight(weight);
+  other_weight.back() = -1.f;
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigShareInitializersByContent, "1"));
+  const auto load_session = [&so](const std::vector<float>& model_weight) {
+    auto session = std::make_unique<InferenceSessionWrapper>(so, GetEnvironment());
+    std::stringstream model_stream(CreateMatMulModelWithWeight(model_weight));
+    ORT_THROW_IF_ERROR(session->Load(model_stream));
+    ORT_THROW_IF_ERROR(session->Initialize());
+    return session;
+  };
+  const auto get_weight_buffer = [](const InferenceSessionWrapper& session) {
+    int idx;
+    ORT_THROW_IF_ERROR(session.GetSessionState().GetOrtValueNameIdxMap().GetIdx("W", idx));
+    return session.GetSessionState().GetInitializedTensors().at(idx).Get<Tensor>().DataRaw();
+  };
+
+  {
+    auto session_1 = load_session(weight);
+    auto session_2 = load_session(weight);
+    auto session_3 = load_session(other_weight);
+
+    EXPECT_EQ(get_weight_buffer(*session_1), get_weight_buffer(*session_2));
+    EXPECT_NE(get_weight_buffer(*session_1), get_weight_buffer(*session_3));
+
+    // the MatMul kernels of the second session use the weight pre-packed by the first one, on the platforms where
+    // MLAS pre-packs it
+    if (session_1->GetSessionState().GetNumberOfPrepacksCounter() > 0) {
+      EXPECT_EQ(session_1->GetSessionState().GetUsedSharedPrePackedWeightCounter(), size_t{0});
+      EXPECT_EQ(session_2->GetSessionState().GetUsedSharedPrePackedWeightCounter(), size_t{1});
+      EXPECT_EQ(session_3->GetSessionState().GetUsedSharedPrePackedWeightCounter(), size_t{0});
+    }
+  }
+
+  // the pre-packed weights are released with the last session sharing initializers by content
+  auto session_4 = load_session(weight);
+  EXPECT_EQ(session_4->GetSessionState().GetUsedSharedPrePackedWeightCounter(), size_t{0});
+}
+
 void RunModelWithDenormalAsZero(InferenceSession& session_object,
                                 const RunOptions& run_options,
                                 bool set_denormal_as_zero) {
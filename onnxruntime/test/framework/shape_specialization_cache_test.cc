@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shape_specialization_cache.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+ShapeSpecializationCache::StateFactory CountingFactory(int& num_created) {
+  return {[](const void* context, std::shared_ptr<const void>& state) {
+            int& num_created = *static_cast<int*>(const_cast<void*>(context));
+            state = std::make_shared<int>(++num_created);
+            return Status::OK();
+          },
+          &num_created};
+}
+
+}  // namespace
+
+TEST(ShapeSpecializationCacheTest, CreatesStateWhenSignatureIsHot) {
+  ShapeSpecializationCache cache(2, 3);
+  int num_created = 0;
+  const auto create_fn = CountingFactory(num_created);
+  const std::vector<int64_t> signature{2, 4, 8};
+  const void* state = nullptr;
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_STATUS_OK(cache.GetOrCreateState(0, signature, create_fn, state));
+    EXPECT_EQ(state, nullptr);
+  }
+
+  ASSERT_STATUS_OK(cache.GetOrCreateState(0, signature, create_fn, state));
+  ASSERT_NE(state, nullptr);
+  const void* hot_state = state;
+
+  ASSERT_STATUS_OK(cache.GetOrCreateState(0, signature, create_fn, state));
+  EXPECT_EQ(state, hot_state);
+  EXPECT_EQ(num_created, 1);
+
+  // the signatures of each node are counted separately
+  ASSERT_STATUS_OK(cache.GetOrCreateState(1, signature, create_fn, state));
+  EXPECT_EQ(state, nullptr);
+
+  const std::vector<int64_t> other_signature{2, 4, 9};
+  ASSERT_STATUS_OK(cache.GetOrCreateState(0, other_signature, create_fn, state));
+  EXPECT_EQ(state, nullptr);
+}
+
+TEST(ShapeSpecializationCacheTest, BoundsSignaturesPerNode) {
+  ShapeSpecializationCache cache(1, 1);
+  int num_created = 0;
+  const auto create_fn = CountingFactory(num_created);
+  const void* state = nullptr;
+
+  int64_t dim = 0;
+  do {
+    ASSERT_STATUS_OK(cache.GetOrCreateState(0, std::vector<int64_t>{1, dim++}, create_fn, state));
+  } while (state != nullptr);
+
+  // a node seeing many hot shapes stops caching new ones, but keeps the cached ones
+  EXPECT_EQ(num_created, static_cast<int>(dim - 1));
+  ASSERT_STATUS_OK(cache.GetOrCreateState(0, std::vector<int64_t>{1, 0}, create_fn, state));
+  EXPECT_NE(state, nullptr);
+
+  // signatures longer than the kernels build on the stack are not cached
+  ShapeSpecializationCache other_cache(1, 1);
+  const std::vector<int64_t> long_signature(ShapeSpecializationCache::kMaxSignatureLength + 1, 1);
+  ASSERT_STATUS_OK(other_cache.GetOrCreateState(0, long_signature, create_fn, state));
+  EXPECT_EQ(state, nullptr);
+
+  // nodes added after the cache was created are not cached
+  ASSERT_STATUS_OK(cache.GetOrCreateState(1, std::vector<int64_t>{1, 0}, create_fn, state));
+  EXPECT_EQ(state, nullptr);
+}
+
+TEST(ShapeSpecializationCacheTest, ColdSignaturesDontTakeSlots) {
+  ShapeSpecializationCache cache(1, 2);
+  int num_created = 0;
+  const auto create_fn = CountingFactory(num_created);
+  const void* state = nullptr;
+
+  // many shapes seen once, as during warm-up
+  for (int64_t dim = 100; dim < 200; ++dim) {
+    ASSERT_STATUS_OK(cache.GetOrCreateState(0, std::vector<int64_t>{1, dim}, create_fn, state));
+    EXPECT_EQ(state, nullptr);
+  }
+
+  // the shapes seen repeatedly afterwards still become hot, up to the slots of the node
+  int64_t dim = 0;
+  do {
+    for (int i = 0; i < 2; ++i) {
+      ASSERT_STATUS_OK(cache.GetOrCreateState(0, std::vector<int64_t>{1, dim}, create_fn, state));
+    }
+    ++dim;
+  } while (state != nullptr);
+
+  EXPECT_EQ(num_created, static_cast<int>(dim - 1));
+  EXPECT_GT(num_created, 1);
+
+  for (int64_t hot_dim = 0; hot_dim < dim - 1; ++hot_dim) {
+    ASSERT_STATUS_OK(cache.GetOrCreateState(0, std::vector<int64_t>{1, hot_dim}, create_fn, state));
+    EXPECT_NE(state, nullptr);
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
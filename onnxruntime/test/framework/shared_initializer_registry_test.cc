@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_registry.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+ONNX_NAMESPACE::TensorProto CreateFloatTensorProto(const std::string& name, const std::vector<int64_t>& dims,
+                                                   const std::vector<float>& values) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (const int64_t dim : dims) {
+    tensor_proto.add_dims(dim);
+  }
+  tensor_proto.set_raw_data(values.data(), values.size() * sizeof(float));
+  return tensor_proto;
+}
+
+}  // namespace
+
+TEST(SharedInitializerRegistryTest, SharesInitializersWithSameContent) {
+  SharedInitializerRegistry registry;
+  const std::vector<float> values{1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+
+  std::shared_ptr<const OrtValue> first, second;
+  ASSERT_STATUS_OK(registry.GetOrAddInitializer(CreateFloatTensorProto("W", {2, 3}, values), Path(), first));
+  // the names of the initializers don't matter
+  ASSERT_STATUS_OK(registry.GetOrAddInitializer(CreateFloatTensorProto("other_W", {2, 3}, values), Path(), second));
+  EXPECT_EQ(first, second);
+
+  std::shared_ptr<const OrtValue> other_shape, other_values;
+  ASSERT_STATUS_OK(registry.GetOrAddInitializer(CreateFloatTensorProto("W", {3, 2}, values), Path(), other_shape));
+  EXPECT_NE(other_shape, first);
+
+  const std::vector<float> changed_values{1.f, 2.f, 3.f, 4.f, 5.f, 7.f};
+  ASSERT_STATUS_OK(registry.GetOrAddInitializer(CreateFloatTensorProto("W", {2, 3}, changed_values), Path(),
+                                                other_values));
+  EXPECT_NE(other_values, first);
+
+  const auto& tensor = first->Get<Tensor>();
+  ASSERT_EQ(tensor.Shape(), TensorShape({2, 3}));
+  EXPECT_EQ(std::vector<float>(tensor.Data<float>(), tensor.Data<float>() + 6), values);
+}
+
+TEST(SharedInitializerRegistryTest, MatchesRawAndTypedData) {
+  SharedInitializerRegistry registry;
+  const std::vector<float> values{1.f, 2.f, 3.f, 4.f};
+
+  std::shared_ptr<const OrtValue> raw, typed;
+  ASSERT_STATUS_OK(registry.GetOrAddInitializer(CreateFloatTensorProto("W", {4}, values), Path(), raw));
+
+  ONNX_NAMESPACE::TensorProto typed_proto;
+  typed_proto.set_name("W");
+  typed_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  typed_proto.add_dims(4);
+  for (const float value : values) {
+    typed_proto.add_float_data(value);
+  }
+  ASSERT_STATUS_OK(registry.GetOrAddInitializer(typed_proto, Path(), typed));
+  EXPECT_EQ(raw, typed);
+}
+
+TEST(SharedInitializerRegistryTest, ReleasesInitializersNoLongerHeld) {
+  SharedInitializerRegistry registry;
+  const auto tensor_proto = CreateFloatTensorProto("W", {4}, {1.f, 2.f, 3.f, 4.f});
+
+  std::shared_ptr<const OrtValue> initializer;
+  ASSERT_STATUS_OK(registry.GetOrAddInitializer(tensor_proto, Path(), initializer));
+  std::weak_ptr<const OrtValue> released = initializer;
+  initializer.reset();
+  EXPECT_TRUE(released.expired());
+
+  ASSERT_STATUS_OK(registry.GetOrAddInitializer(tensor_proto, Path(), initializer));
+  ASSERT_NE(initializer, nullptr);
+  EXPECT_EQ(initializer->Get<Tensor>().Data<float>()[3], 4.f);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
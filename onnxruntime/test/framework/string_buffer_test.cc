@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/string_buffer.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(StringBufferViewTest, ViewOfExternalData) {
+  const std::string data = "Thisisatest";
+  const std::vector<size_t> offsets = {0, 4, 6, 7};
+
+  StringBufferView view;
+  ASSERT_STATUS_OK(StringBufferView::Create(data.data(), data.size(), offsets, view));
+  ASSERT_EQ(view.Size(), 4u);
+  EXPECT_EQ(view[0], "This");
+  EXPECT_EQ(view[1], "is");
+  EXPECT_EQ(view[2], "a");
+  EXPECT_EQ(view[3], "test");
+
+  std::vector<std::string> strings(2);
+  view.CopyTo(1, strings);
+  EXPECT_EQ(strings, (std::vector<std::string>{"is", "a"}));
+
+  const std::vector<size_t> decreasing_offsets = {0, 4, 2};
+  EXPECT_FALSE(StringBufferView::Create(data.data(), data.size(), decreasing_offsets, view).IsOK());
+
+  const std::vector<size_t> out_of_bounds_offsets = {0, 4, 20};
+  EXPECT_FALSE(StringBufferView::Create(data.data(), data.size(), out_of_bounds_offsets, view).IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
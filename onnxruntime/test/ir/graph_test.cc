@@ -2127,5 +2127,72 @@ TEST_F(GraphTest, SubgraphOutputIsOuterScopeValue) {
               ::testing::ContainsRegex("Subgraph output \\(.*\\) is an outer scope value being returned directly."));
 }
 
+TEST_F(GraphTest, IncrementalResolve) {
+  for (auto mode : {Graph::IncrementalResolveMode::kEnabled, Graph::IncrementalResolveMode::kVerified}) {
+    std::shared_ptr<Model> model;
+    {
+      ModelProto m;
+      m.set_ir_version(4);
+      ImportOpset(m, "", 10);
+      ConstructASimpleAddGraph(*m.mutable_graph(), nullptr);
+      ASSERT_STATUS_OK(Model::Load(std::move(m), model, nullptr, *logger_));
+    }
+
+    Graph& graph = model->MainGraph();
+    graph.SetIncrementalResolveMode(mode);
+    ASSERT_STATUS_OK(graph.Resolve());
+    graph.SetGraphResolveNeeded();
+    ASSERT_STATUS_OK(graph.Resolve());
+
+    // the added node is inferred while the unchanged Add node is not, unless verified
+    auto* sum = graph.GetNodeArg("sum");
+    auto* relu_out = &graph.GetOrCreateNodeArg("relu_out", nullptr);
+    graph.AddNode("relu", "Relu", "relu of sum", {sum}, {relu_out});
+    graph.SetOutputs({relu_out});
+    ASSERT_STATUS_OK(graph.Resolve());
+
+    ASSERT_NE(relu_out->Shape(), nullptr);
+    EXPECT_EQ(utils::GetTensorShapeFromTensorShapeProto(*relu_out->Shape()), TensorShape({3, 4, 5}));
+  }
+}
+
+TEST_F(GraphTest, IncrementalResolveReaddedInitializer) {
+  Model model("graph_1", false, *logger_);
+  auto& graph = model.MainGraph();
+  graph.SetIncrementalResolveMode(Graph::IncrementalResolveMode::kEnabled);
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  auto& data = graph.GetOrCreateNodeArg("data", &float_tensor);
+  auto& shape = graph.GetOrCreateNodeArg("shape", nullptr);
+  auto& reshaped = graph.GetOrCreateNodeArg("reshaped", nullptr);
+  graph.AddNode("reshape", "Reshape", "reshape data", {&data, &shape}, {&reshaped});
+
+  auto add_shape_initializer = [&graph](std::initializer_list<int64_t> dims) {
+    TensorProto shape_initializer;
+    shape_initializer.set_name("shape");
+    shape_initializer.set_data_type(TensorProto_DataType_INT64);
+    shape_initializer.add_dims(static_cast<int64_t>(dims.size()));
+    for (const int64_t dim : dims) {
+      shape_initializer.add_int64_data(dim);
+    }
+    graph.AddInitializedTensor(shape_initializer);
+  };
+
+  add_shape_initializer({-1, 3});
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_NE(reshaped.Shape(), nullptr);
+  ASSERT_EQ(reshaped.Shape()->dim_size(), 2);
+  EXPECT_FALSE(utils::HasDimValue(reshaped.Shape()->dim(0)));
+
+  // replace the initializer as the transpose optimizer does. the new TensorProto may be allocated at the address of
+  // the removed one, so the Reshape must be re-inferred even if it is.
+  graph.RemoveInitializedTensor("shape");
+  add_shape_initializer({2, 3});
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(utils::GetTensorShapeFromTensorShapeProto(*reshaped.Shape()), TensorShape({2, 3}));
+}
+
 }  // namespace test
 }  // namespace onnxruntime
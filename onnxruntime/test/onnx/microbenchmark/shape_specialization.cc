@@ -0,0 +1,63 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include "core/framework/shape_specialization_cache.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+
+using namespace onnxruntime;
+
+// the broadcast plan MatMul computes on every call when the shapes are not hot
+static void BM_MatMulComputeHelper(benchmark::State& state) {
+  const TensorShape a_shape({state.range(0), 64, 128});
+  const TensorShape b_shape({128, 256});
+  for (auto _ : state) {
+    MatMulComputeHelper helper;
+    ORT_THROW_IF_ERROR(helper.Compute(a_shape, b_shape));
+    benchmark::DoNotOptimize(helper.OutputOffsets().data());
+  }
+}
+
+BENCHMARK(BM_MatMulComputeHelper)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kNanosecond)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(256);
+
+// looking up the cached broadcast plan of hot shapes, from a signature built on the stack as the kernels do
+static void BM_ShapeSpecializationCacheHotLookup(benchmark::State& state) {
+  const TensorShape a_shape({state.range(0), 64, 128});
+  const TensorShape b_shape({128, 256});
+  const TensorShape* shapes[] = {&a_shape, &b_shape};
+  ShapeSpecializationCache cache(1, 1);
+  const ShapeSpecializationCache::StateFactory create_fn{
+      [](const void* context, std::shared_ptr<const void>& new_state) {
+        const auto* shapes = static_cast<const TensorShape* const*>(context);
+        auto helper = std::make_shared<MatMulComputeHelper>();
+        ORT_RETURN_IF_ERROR(helper->Compute(*shapes[0], *shapes[1]));
+        new_state = std::move(helper);
+        return Status::OK();
+      },
+      shapes};
+
+  for (auto _ : state) {
+    std::array<int64_t, ShapeSpecializationCache::kMaxSignatureLength> signature;
+    size_t length = 0;
+    for (const TensorShape* shape : shapes) {
+      signature[length++] = static_cast<int64_t>(shape->NumDimensions());
+      shape->CopyDims(signature.data() + length, shape->NumDimensions());
+      length += shape->NumDimensions();
+    }
+
+    const void* cached = nullptr;
+    ORT_THROW_IF_ERROR(cache.GetOrCreateState(0, gsl::make_span(signature.data(), length), create_fn, cached));
+    benchmark::DoNotOptimize(cached);
+  }
+}
+
+BENCHMARK(BM_ShapeSpecializationCacheHotLookup)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kNanosecond)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(256);
@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "graph_transform_test_builder.h"
+
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+namespace test {
+
+#ifndef DISABLE_CONTRIB_OPS
+
+// The inputs cover each way FusedElementwise broadcasts an input: same shape as the output, scalar, innermost
+// dimensions of the output and strided. The output spans several tiles.
+TEST(ElementwiseChainFusionTests, FuseChain) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* x = builder.MakeInput<float>({2, 16, 100}, -3.f, 3.f);
+    auto* gate = builder.MakeInput<float>({2, 1, 100}, -1.f, 1.f);
+    auto* mask = builder.MakeInputBool({16, 1});
+    auto* condition = builder.MakeInputBool({2, 16, 100});
+    auto* bias = builder.MakeInitializer<float>({100}, -1.f, 1.f);
+    auto* scale = builder.MakeScalarInitializer<float>(0.5f);
+    auto* denominator = builder.MakeInitializer<float>({100}, 1.f, 2.f);
+
+    auto* add_out = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* tanh_out = builder.MakeIntermediate();
+    auto* sub_out = builder.MakeIntermediate();
+    auto* cast_out = builder.MakeIntermediate();
+    auto* masked_out = builder.MakeIntermediate();
+    auto* erf_out = builder.MakeIntermediate();
+    auto* where_out = builder.MakeIntermediate();
+    auto* output = builder.MakeOutput();
+
+    builder.AddNode("Add", {x, bias}, {add_out});
+    builder.AddNode("Mul", {add_out, scale}, {mul_out});
+    builder.AddNode("Tanh", {mul_out}, {tanh_out});
+    builder.AddNode("Sub", {tanh_out, gate}, {sub_out});
+    builder.AddNode("Cast", {mask}, {cast_out})
+        .AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+    builder.AddNode("Mul", {sub_out, cast_out}, {masked_out});
+    builder.AddNode("Erf", {masked_out}, {erf_out});
+    builder.AddNode("Where", {condition, erf_out, x}, {where_out});
+    builder.AddNode("Div", {where_out, denominator}, {output});
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(session.GetGraph().NumberOfNodes(), 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level2, TransformerLevel::Level3, 13);
+}
+
+// A value that is a graph output is not computed in a group.
+TEST(ElementwiseChainFusionTests, GraphOutputEndsGroup) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* x = builder.MakeInput<float>({4, 8}, -3.f, 3.f);
+    auto* y = builder.MakeInput<float>({4, 8}, -3.f, 3.f);
+    auto* add_out = builder.MakeOutput();
+    auto* relu_out = builder.MakeIntermediate();
+    auto* output = builder.MakeOutput();
+
+    builder.AddNode("Add", {x, y}, {add_out});
+    builder.AddNode("Relu", {add_out}, {relu_out});
+    builder.AddNode("Sigmoid", {relu_out}, {output});
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Add"], 1);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+    EXPECT_EQ(op_to_count["Sigmoid"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level2, TransformerLevel::Level3, 13);
+}
+
+#endif  // DISABLE_CONTRIB_OPS
+
+}  // namespace test
+}  // namespace onnxruntime
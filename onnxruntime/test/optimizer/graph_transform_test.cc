@@ -72,6 +72,7 @@
 #include "core/session/inference_session.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/util/math.h"
+#include "core/util/thread_utils.h"
 #include "test/capturing_sink.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/compare_ortvalue.h"
@@ -1024,6 +1025,116 @@ TEST_F(GraphTransformationTests, ConstantFoldingStringInitializer) {
   ASSERT_EQ(op_to_count.size(), 0U) << "Identity node should have been removed";
 }
 
+// Test the nodes whose outputs would exceed the size ratio are not folded
+TEST_F(GraphTransformationTests, ConstantFoldingMaxSizeRatio) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({{1024}});
+    auto* value_arg = builder.MakeInitializer<float>({1}, {1.0f});
+    auto* shape_arg = builder.Make1DInitializer<int64_t>({1024});
+    auto* lhs_arg = builder.MakeInitializer<float>({1024}, -1.f, 1.f);
+    auto* rhs_arg = builder.MakeInitializer<float>({1024}, -1.f, 1.f);
+    auto* expand_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Expand", {value_arg, shape_arg}, {expand_out});
+    builder.AddNode("Add", {lhs_arg, rhs_arg}, {add_out});
+    builder.AddNode("Mul", {input_arg, expand_out}, {mul_out});
+    builder.AddNode("Add", {mul_out, add_out}, {output_arg});
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Expand"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Mul"] == 1);
+    return Status::OK();
+  };
+
+  std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  auto transformer = std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/,
+                                                       InlinedHashSet<std::string_view>{},
+                                                       InlinedHashSet<std::string>{},
+                                                       nullptr /*thread_pool*/, 2.0 /*max_size_ratio*/);
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                        TransformerLevel::Level1, 1, nullptr, post_graph_checker));
+}
+
+// Test the nodes folded concurrently give the same initializers as the nodes folded one by one. The independent
+// foldable nodes fill the batches, and the chains flush a batch whenever a node uses the output of a pending fold.
+TEST_F(GraphTransformationTests, ConstantFoldingWithThreadPool) {
+  constexpr int num_independent_nodes = 8;
+  constexpr int num_chains = 4;
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({{2, 4}});
+    std::vector<NodeArg*> sum_inputs{input_arg};
+    const std::array<const char*, 3> ops{"Add", "Mul", "Sub"};
+    for (int i = 0; i < num_independent_nodes; ++i) {
+      auto* out = builder.MakeIntermediate();
+      builder.AddNode(ops[i % ops.size()], {builder.MakeInitializer<float>({2, 4}, -1.f, 1.f),
+                                            builder.MakeInitializer<float>({2, 4}, -1.f, 1.f)},
+                      {out});
+      sum_inputs.push_back(out);
+    }
+
+    for (int i = 0; i < num_chains; ++i) {
+      auto* add_out = builder.MakeIntermediate();
+      auto* mul_out = builder.MakeIntermediate();
+      builder.AddNode("Add", {builder.MakeInitializer<float>({2, 4}, -1.f, 1.f),
+                              builder.MakeInitializer<float>({2, 4}, -1.f, 1.f)},
+                      {add_out});
+      builder.AddNode("Mul", {add_out, builder.MakeInitializer<float>({4}, -1.f, 1.f)}, {mul_out});
+      sum_inputs.push_back(mul_out);
+    }
+
+    // consumes every folded value after all the foldable nodes in topological order
+    builder.AddNode("Sum", sum_inputs, {builder.MakeOutput()});
+  };
+
+  // the values of the folded initializers by name
+  using FoldedValues = std::map<std::string, std::vector<float>>;
+  auto fold = [&](concurrency::ThreadPool* thread_pool, FoldedValues& folded_values) {
+    auto post_graph_checker = [&folded_values](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["Add"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Mul"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Sub"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Sum"] == 1);
+      for (const Node& node : graph.Nodes()) {
+        for (const NodeArg* input_def : node.InputDefs()) {
+          const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_def->Name());
+          if (tensor_proto != nullptr) {
+            Initializer folded{*tensor_proto, graph.ModelPath()};
+            auto values = folded.DataAsSpan<float>();
+            folded_values[input_def->Name()].assign(values.begin(), values.end());
+          }
+        }
+      }
+      TEST_RETURN_IF_NOT(folded_values.size() == static_cast<size_t>(num_independent_nodes + num_chains));
+      return Status::OK();
+    };
+
+    std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+    auto transformer = std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/,
+                                                         InlinedHashSet<std::string_view>{},
+                                                         InlinedHashSet<std::string>{}, thread_pool);
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                          TransformerLevel::Level1, 1, nullptr, post_graph_checker));
+  };
+
+  FoldedValues serial_values;
+  ASSERT_NO_FATAL_FAILURE(fold(nullptr, serial_values));
+
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 4;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  FoldedValues concurrent_values;
+  ASSERT_NO_FATAL_FAILURE(fold(tp.get(), concurrent_values));
+
+  EXPECT_EQ(concurrent_values, serial_values);
+}
+
 TEST_F(GraphTransformationTests, ConstantFoldingIfConstantInlining) {
   // This test covers the following necessary cases:
   // The input refers to the explicit or implicit inputs of If node.
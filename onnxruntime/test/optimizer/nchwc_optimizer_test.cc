@@ -6,6 +6,7 @@
 #include "core/mlas/inc/mlas.h"
 #include "core/session/environment.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/compare_ortvalue.h"
 #include "test/test_environment.h"
 #include "test/framework/test_utils.h"
@@ -167,7 +168,8 @@ struct NchwcTestHelper {
 
 void NchwcOptimizerTester(const std::function<void(NchwcTestHelper& helper)>& build_test_case,
                           const std::function<void(InferenceSessionWrapper& session)>& check_nchwc_graph,
-                          int opset_version = 13) {
+                          int opset_version = 13,
+                          const std::function<void(SessionOptions&)>& add_session_options = {}) {
   // Ignore the test if NCHWc is not supported by the platform.
   if (MlasNchwcGetBlockSize() <= 1) {
     return;
@@ -190,6 +192,9 @@ void NchwcOptimizerTester(const std::function<void(NchwcTestHelper& helper)>& bu
     SessionOptions session_options;
     session_options.graph_optimization_level = level;
     session_options.session_logid = "NchwcOptimizerTests";
+    if (add_session_options) {
+      add_session_options(session_options);
+    }
     InferenceSessionWrapper session{session_options, GetEnvironment()};
     ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
     ASSERT_STATUS_OK(session.Initialize());
@@ -407,6 +412,39 @@ TEST(NchwcOptimizerTests, ConvPointwise) {
   }
 }
 
+TEST(NchwcOptimizerTests, ConvCostModel) {
+  auto build_test_case = [&](NchwcTestHelper& helper) {
+    // The reorders of the input and output of this pointwise convolution cost
+    // more than the convolution saves.
+    auto* input1_arg = helper.MakeInput<float>({1, 16, 28, 28});
+    auto* output1_arg = helper.MakeOutput();
+    helper.AddConvNode(input1_arg, output1_arg, {16, 16, 1, 1});
+
+    // The savings of these convolutions outweigh the reorders.
+    auto* input2_arg = helper.MakeInput<float>({1, 64, 28, 28});
+    auto* conv_output_arg = helper.MakeIntermediate();
+    auto* output2_arg = helper.MakeOutput();
+    auto& conv1_node = helper.AddConvNode(input2_arg, conv_output_arg, {64, 64, 3, 3});
+    conv1_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    auto& conv2_node = helper.AddConvNode(conv_output_arg, output2_arg, {64, 64, 3, 3});
+    conv2_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  };
+
+  auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["Conv"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], 2);
+    EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], 1);
+  };
+
+  auto add_session_options = [](SessionOptions& session_options) {
+    ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigNchwcCostModel, "1"));
+  };
+
+  NchwcOptimizerTester(build_test_case, check_nchwc_graph, 13, add_session_options);
+}
+
 TEST(NchwcOptimizerTests, ConvMaxPool) {
   auto build_test_case = [&](NchwcTestHelper& helper) {
     auto* input_arg = helper.MakeInput<float>({1, 48, 34, 34});
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <memory>
 #include <functional>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -51,11 +52,12 @@ void ValidateTestData(TestData& test_data, int expected = 1) {
 // test the function with a null pointer, reflecting scenarios where we
 // run with just the main thread.  Note that the thread pool API uses
 // static methods and should operate across all of these cases.
-void CreateThreadPoolAndTest(const std::string&, int num_threads, const std::function<void(ThreadPool*)>& test_body, int dynamic_block_base = 0, bool mock_hybrid = false) {
+void CreateThreadPoolAndTest(const std::string&, int num_threads, const std::function<void(ThreadPool*)>& test_body, int dynamic_block_base = 0, bool mock_hybrid = false, bool guided_scheduling = false) {
   if (num_threads > 0) {
-    if (dynamic_block_base > 0) {
+    if (dynamic_block_base > 0 || guided_scheduling) {
       onnxruntime::ThreadOptions thread_options;
       thread_options.dynamic_block_base_ = dynamic_block_base;
+      thread_options.guided_scheduling = guided_scheduling;
       auto tp_dynamic_block_size = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, num_threads, true, mock_hybrid);
       test_body(tp_dynamic_block_size.get());  // test thread pool with dynamic block size
     } else {
@@ -85,7 +87,7 @@ void TestBatchParallelFor(const std::string& name, int num_threads, int num_task
   ValidateTestData(*test_data);
 }
 
-void TestConcurrentParallelFor(const std::string& name, int num_threads, int num_concurrent, int num_tasks, int dynamic_block_base = 0, bool mock_hybrid = false) {
+void TestConcurrentParallelFor(const std::string& name, int num_threads, int num_concurrent, int num_tasks, int dynamic_block_base = 0, bool mock_hybrid = false, bool guided_scheduling = false) {
   // Test running multiple concurrent loops over the same thread pool.  This aims to provoke a
   // more diverse mix of interleavings than with a single loop running at a time.
   for (int rep = 0; rep < 5; rep++) {
@@ -120,7 +122,7 @@ void TestConcurrentParallelFor(const std::string& name, int num_threads, int num
           }
           td.clear();
         },
-        dynamic_block_base, mock_hybrid);
+        dynamic_block_base, mock_hybrid, guided_scheduling);
   }
 }
 
@@ -416,6 +418,32 @@ TEST(ThreadPoolTest, TestConcurrentParallelFor_4Thread_4Conc_1MTasks_dynamic_blo
   TestConcurrentParallelFor("TestConcurrentParallelFor_4Thread_4Conc_1MTasks_dynamic_block_base_128", 4, 4, 1000000, 128, true);
 }
 
+TEST(ThreadPoolTest, TestConcurrentParallelFor_4Thread_4Conc_8Tasks_guided_hybrid) {
+  TestConcurrentParallelFor("TestConcurrentParallelFor_4Thread_4Conc_8Tasks_guided_hybrid", 4, 4, 8, 0, true, true);
+}
+
+TEST(ThreadPoolTest, TestConcurrentParallelFor_4Thread_4Conc_1MTasks_guided_hybrid) {
+  TestConcurrentParallelFor("TestConcurrentParallelFor_4Thread_4Conc_1MTasks_guided_hybrid", 4, 4, 1000000, 0, true, true);
+}
+
+TEST(ThreadPoolTest, TestParallelForWithCost_guided_hybrid) {
+  // guided scheduling claims ranges of several blocks; every iteration must still run exactly once
+  for (int num_tasks : {7, 1000, 100000}) {
+    auto test_data = CreateTestData(num_tasks);
+    CreateThreadPoolAndTest(
+        "TestParallelForWithCost_guided_hybrid", 4, [&](ThreadPool* tp) {
+          ThreadPool::TryParallelFor(tp, num_tasks, onnxruntime::TensorOpCost{1.0, 1.0, 100.0},
+                                     [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+                                       for (std::ptrdiff_t i = first; i < last; ++i) {
+                                         IncrementElement(*test_data, i);
+                                       }
+                                     });
+        },
+        0, true, true);
+    ValidateTestData(*test_data);
+  }
+}
+
 TEST(ThreadPoolTest, TestBurstScheduling_0Tasks) {
   TestBurstScheduling("TestBurstScheduling_0Tasks", 0);
 }
@@ -613,6 +641,203 @@ TEST(ThreadPoolTest, TestAffinityStringWellShaped) {
   }
 }
 
+TEST(ThreadPoolTest, TestNumaNode) {
+  OrtThreadPoolParams tp_params;
+
+  // a node that does not exist falls back to an unbound pool
+  tp_params.numa_node = 1 << 20;
+  tp_params.thread_pool_size = 2;
+  ASSERT_TRUE(onnxruntime::Env::Default().GetNumaNodeThreadAffinities(tp_params.numa_node).empty());
+  auto fallback_tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                   tp_params,
+                                                   concurrency::ThreadPoolType::INTRA_OP);
+  ASSERT_NE(fallback_tp, nullptr);
+
+  tp_params.numa_node = 0;
+  tp_params.thread_pool_size = 0;
+  const auto node_affinities = onnxruntime::Env::Default().GetNumaNodeThreadAffinities(tp_params.numa_node);
+  if (node_affinities.size() < 2) {
+    return;  // no NUMA topology, or a single core node, on this machine
+  }
+
+  for (const auto& core : node_affinities) {
+    ASSERT_FALSE(core.empty());
+  }
+
+  // one thread per core of the node by default
+  auto node_tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                               tp_params,
+                                               concurrency::ThreadPoolType::INTRA_OP);
+  ASSERT_NE(node_tp, nullptr);
+  auto DOP = concurrency::ThreadPool::DegreeOfParallelism(node_tp.get());
+  ASSERT_TRUE(DOP >= static_cast<int>(node_affinities.size()));
+}
+
+TEST(ThreadPoolTest, TestSpinCount) {
+  using std::chrono::milliseconds;
+  constexpr int max_spin_count = 1 << 20;
+  constexpr int min_spin_count = 1 << 10;
+
+  SpinCount fixed(max_spin_count, min_spin_count, false);
+  fixed.OnWakeUp(milliseconds(1), milliseconds(100));
+  ASSERT_EQ(fixed.Get(), max_spin_count);
+
+  SpinCount spin_count(max_spin_count, min_spin_count, true);
+  ASSERT_EQ(spin_count.Get(), max_spin_count);
+
+  // work arriving long after a full spin halves the spin count, down to the minimum
+  spin_count.OnWakeUp(milliseconds(10), milliseconds(100));
+  ASSERT_EQ(spin_count.Get(), max_spin_count / 2);
+  for (int i = 0; i < 20; i++) {
+    spin_count.OnWakeUp(milliseconds(1), milliseconds(100));
+  }
+  ASSERT_EQ(spin_count.Get(), min_spin_count);
+
+  // work arriving within the time of max_spin_count spins doubles it. The spin of min_spin_count took 1ms, so
+  // max_spin_count spins take 1s
+  spin_count.OnWakeUp(milliseconds(1), milliseconds(500));
+  ASSERT_EQ(spin_count.Get(), min_spin_count * 2);
+
+  // as does work found while spinning, up to the maximum
+  for (int i = 0; i < 20; i++) {
+    spin_count.OnSpinHit();
+  }
+  ASSERT_EQ(spin_count.Get(), max_spin_count);
+}
+
+#ifndef ORT_MINIMAL_BUILD
+// Returns the spin counts of the workers in a thread pool profile, skipping the workers that never spun.
+static std::vector<int> GetSpinCounts(const std::string& profile) {
+  std::vector<int> spin_counts;
+  const std::string key = "\"spin_count\": ";
+  for (auto pos = profile.find(key); pos != std::string::npos; pos = profile.find(key, pos + key.size())) {
+    const int spin_count = std::stoi(profile.substr(pos + key.size()));
+    if (spin_count > 0) {
+      spin_counts.push_back(spin_count);
+    }
+  }
+  return spin_counts;
+}
+
+TEST(ThreadPoolTest, TestAdaptiveSpinning) {
+  constexpr int num_tasks = 1024;
+  constexpr int max_spin_count = 1 << 20;
+  onnxruntime::ThreadOptions thread_options;
+  thread_options.adaptive_spinning = true;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, 4, true);
+  auto run_loop = [&]() {
+    auto test_data = CreateTestData(num_tasks);
+    ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    ValidateTestData(*test_data);
+  };
+
+  // idle gaps much longer than a full spin make the workers that ran the loops back off
+  ThreadPool::StartProfiling(tp.get());
+  for (int gap = 0; gap < 5; gap++) {
+    run_loop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  }
+  run_loop();
+  auto spin_counts = GetSpinCounts(ThreadPool::StopProfiling(tp.get()));
+  ASSERT_FALSE(spin_counts.empty());
+  ASSERT_LT(*std::min_element(spin_counts.begin(), spin_counts.end()), max_spin_count);
+
+  // back to back loops find the workers spinning, which spin longer again
+  ThreadPool::StartProfiling(tp.get());
+  for (int l = 0; l < 200; l++) {
+    run_loop();
+  }
+  spin_counts = GetSpinCounts(ThreadPool::StopProfiling(tp.get()));
+  ASSERT_FALSE(spin_counts.empty());
+  ASSERT_EQ(*std::max_element(spin_counts.begin(), spin_counts.end()), max_spin_count);
+}
+#endif
+
+#ifndef ORT_MINIMAL_BUILD
+TEST(ThreadPoolTest, TestTracing) {
+  constexpr int num_tasks = 1024;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 4, true);
+  ThreadPool::StartTracing(tp.get(), std::chrono::high_resolution_clock::now(), 100000);
+
+  auto test_data = CreateTestData(num_tasks);
+  ThreadPool::TryParallelFor(tp.get(), num_tasks, 1000.0, [&](std::ptrdiff_t s, std::ptrdiff_t e) {
+    for (auto i = s; i < e; ++i) IncrementElement(*test_data, i);
+  });
+  ValidateTestData(*test_data);
+
+  // workers record a task once it returned, which may be after the loop completed
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  onnxruntime::profiling::Events events;
+  ThreadPool::StopTracing(tp.get(), events);
+  auto num_events = [&](const std::string& name) {
+    return std::count_if(events.cbegin(), events.cend(), [&](const auto& e) { return e.name == name; });
+  };
+  ASSERT_EQ(num_events("parallel_loop"), 1);
+  ASSERT_GE(num_events("task"), 1);
+  for (const auto& e : events) {
+    ASSERT_EQ(e.cat, onnxruntime::profiling::THREAD_POOL_EVENT);
+    ASSERT_GE(e.dur, 0);
+    if (e.name == "parallel_loop") {
+      ASSERT_EQ(e.args.count("num_work_items"), 1u);
+      ASSERT_EQ(e.args.count("block_size"), 1u);
+    } else if (e.name == "task") {
+      ASSERT_EQ(e.args.count("stolen"), 1u);
+    }
+  }
+
+  // nothing is recorded once tracing stopped
+  ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t) {});
+  onnxruntime::profiling::Events events_after_stop;
+  ThreadPool::StopTracing(tp.get(), events_after_stop);
+  ASSERT_TRUE(events_after_stop.empty());
+
+  // tracing again starts from empty buffers and keeps to the maximum number of events
+  ThreadPool::StartTracing(tp.get(), std::chrono::high_resolution_clock::now(), 2);
+  for (int i = 0; i < 10; ++i) {
+    ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t) {});
+  }
+  onnxruntime::profiling::Events limited_events;
+  ThreadPool::StopTracing(tp.get(), limited_events);
+  ASSERT_EQ(limited_events.size(), 2u);
+  ASSERT_EQ(limited_events[0].name, "parallel_loop");
+}
+#endif
+
+TEST(ThreadPoolTest, TestScopedLoopThreadLimit) {
+  constexpr int num_tasks = 1024;
+  CreateThreadPoolAndTest("TestScopedLoopThreadLimit", 4, [&](ThreadPool* tp) {
+    const auto unlimited_dop = ThreadPool::DegreeOfParallelism(tp);
+    ASSERT_EQ(ThreadPool::ScopedLoopThreadLimit::Current(), 0);
+    {
+      ThreadPool::ScopedLoopThreadLimit limit(1);
+      ASSERT_EQ(ThreadPool::ScopedLoopThreadLimit::Current(), 1);
+      ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp), 1);
+      ASSERT_FALSE(ThreadPool::ShouldParallelize(tp));
+
+      auto test_data = CreateTestData(num_tasks);
+      ThreadPool::TrySimpleParallelFor(tp, num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+      ValidateTestData(*test_data);
+
+      {
+        // limits nest and are restored in turn
+        ThreadPool::ScopedLoopThreadLimit inner_limit(2);
+        ASSERT_EQ(ThreadPool::ScopedLoopThreadLimit::Current(), 2);
+        ASSERT_TRUE(ThreadPool::ShouldParallelize(tp));
+        ASSERT_LE(ThreadPool::DegreeOfParallelism(tp), unlimited_dop);
+
+        auto inner_test_data = CreateTestData(num_tasks);
+        ThreadPool::TryParallelFor(tp, num_tasks, 1000.0, [&](std::ptrdiff_t s, std::ptrdiff_t e) {
+          for (auto i = s; i < e; ++i) IncrementElement(*inner_test_data, i);
+        });
+        ValidateTestData(*inner_test_data);
+      }
+      ASSERT_EQ(ThreadPool::ScopedLoopThreadLimit::Current(), 1);
+    }
+    ASSERT_EQ(ThreadPool::ScopedLoopThreadLimit::Current(), 0);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp), unlimited_dop);
+  });
+}
+
 #ifdef _WIN32
 TEST(ThreadPoolTest, TestDefaultAffinity) {
   test::CpuGroup cpu_group = {{0, 1},
@@ -1,14 +1,18 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <atomic>
 #include <future>
 #include <thread>
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/clog_sink.h"
 #include "core/framework/session_state.h"
+#include "core/session/environment.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 #include "test/providers/provider_test_utils.h"
 #include "test/util/include/default_providers.h"
@@ -1042,6 +1046,185 @@ TEST(Loop, IterationCountAsOutput) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// a subgraph that doubles sum and outputs its square. with pass_cond_through it passes 'cond' through, so
+// each iteration writes its loop output directly into the Loop output. otherwise it computes 'cond'.
+static const ONNX_NAMESPACE::GraphProto CreateKnownIterationCountSubgraph(bool pass_cond_through = true,
+                                                                        int64_t sum_size = 2) {
+  Model model("Loop output with known iteration count", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  /* Inputs: iter_num, cond_in, sum_in.
+
+       cond_in     sum_in  sum_in
+          |            \    /
+     [Identity]        [Add]
+      or [And]           |
+          |              |
+       cond_out       sum_out  sum_out
+                          \     /
+                           [Mul]
+                             |
+                         square_out
+  */
+
+  TypeProto int64_scalar;
+  int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  TypeProto bool_scalar;
+  bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(sum_size);
+
+  auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+  auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+  auto& sum_in = graph.GetOrCreateNodeArg("sum_in", &float_tensor);
+
+  auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+  auto& sum_out = graph.GetOrCreateNodeArg("sum_out", &float_tensor);
+  auto& square_out = graph.GetOrCreateNodeArg("square_out", &float_tensor);
+
+  if (pass_cond_through) {
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+  } else {
+    graph.AddNode("cond_in_and", "And", "Compute cond_out from cond_in", {&cond_in, &cond_in}, {&cond_out});
+  }
+  graph.AddNode("add", "Add", "Double sum_in", {&sum_in, &sum_in}, {&sum_out});
+  graph.AddNode("mul", "Mul", "Square sum_out", {&sum_out, &sum_out}, {&square_out});
+
+  graph.SetInputs({&iter_num_in, &cond_in, &sum_in});
+  graph.SetOutputs({&cond_out, &sum_out, &square_out});
+
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
+
+  return graph.ToGraphProto();
+}
+
+TEST(Loop, LoopOutputsWithKnownIterationCount) {
+  OpTester test("Loop", 11);
+  auto body = CreateKnownIterationCountSubgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {3});
+  test.AddOptionalInputEdge<bool>();
+  test.AddInput<float>("sum", {2}, {1.f, 2.f});
+
+  test.AddOutput<float>("sum_final", {2}, {8.f, 16.f});
+  test.AddOutput<float>("squares", {3, 2}, {4.f, 16.f, 16.f, 64.f, 64.f, 256.f});
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+// 'cond' is initially false, so the loop runs no iterations even though it has a max trip count
+TEST(Loop, LoopOutputsWithKnownIterationCount_FalseCondition) {
+  OpTester test("Loop", 11);
+  auto body = CreateKnownIterationCountSubgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {3});
+  test.AddInput<bool>("cond", {1}, {false});
+  test.AddInput<float>("sum", {2}, {1.f, 2.f});
+
+  test.AddOutput<float>("sum_final", {2}, {1.f, 2.f});
+  test.AddOutput<float>("squares", {0, 2}, {});
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+namespace {
+// counts the bytes allocated on CPU by the sessions of an environment it is registered with
+class CountingCpuAllocator : public CPUAllocator {
+ public:
+  CountingCpuAllocator() : CPUAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
+
+  void* Alloc(size_t size) override {
+    num_bytes_ += size;
+    return CPUAllocator::Alloc(size);
+  }
+
+  size_t NumBytes() const { return num_bytes_; }
+
+ private:
+  std::atomic<size_t> num_bytes_{0};
+};
+}  // namespace
+
+// runs a Loop of num_iterations over body and returns the number of bytes allocated by the run
+static size_t GetBytesAllocatedByLoop(const GraphProto& body, int64_t num_iterations, int64_t sum_size) {
+  std::unique_ptr<Environment> env;
+  ORT_THROW_IF_ERROR(Environment::Create(std::make_unique<logging::LoggingManager>(
+                                             std::unique_ptr<logging::ISink>(new logging::CLogSink()),
+                                             logging::Severity::kWARNING, false,
+                                             logging::LoggingManager::InstanceType::Temporal),
+                                         env));
+  auto allocator = std::make_shared<CountingCpuAllocator>();
+  ORT_THROW_IF_ERROR(env->RegisterAllocator(allocator));
+
+  Model model("Loop", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto int64_scalar;
+  int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  TypeProto bool_scalar;
+  bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(sum_size);
+
+  auto& max_trip_count = graph.GetOrCreateNodeArg("M", &int64_scalar);
+  auto& cond = graph.GetOrCreateNodeArg("cond", &bool_scalar);
+  auto& sum = graph.GetOrCreateNodeArg("sum", &float_tensor);
+  auto& sum_final = graph.GetOrCreateNodeArg("sum_final", &float_tensor);
+  auto& squares = graph.GetOrCreateNodeArg("squares", nullptr);
+
+  auto& loop = graph.AddNode("loop", "Loop", "Loop", {&max_trip_count, &cond, &sum}, {&sum_final, &squares});
+  loop.AddAttribute("body", body);
+  ORT_THROW_IF_ERROR(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  SessionOptions so;
+  ORT_THROW_IF_ERROR(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseEnvAllocators, "1"));
+  InferenceSession session{so, *env};
+  ORT_THROW_IF_ERROR(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ORT_THROW_IF_ERROR(session.Initialize());
+
+  auto input_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  NameMLValMap feeds;
+  OrtValue ml_value;
+  CreateMLValue<int64_t>(input_allocator, {1}, {num_iterations}, &ml_value);
+  feeds.insert(std::make_pair("M", ml_value));
+  CreateMLValue<bool>(input_allocator, {1}, {true}, &ml_value);
+  feeds.insert(std::make_pair("cond", ml_value));
+  CreateMLValue<float>(input_allocator, {sum_size}, std::vector<float>(static_cast<size_t>(sum_size), 1.f), &ml_value);
+  feeds.insert(std::make_pair("sum", ml_value));
+
+  std::vector<OrtValue> fetches;
+  const size_t num_bytes_before_run = allocator->NumBytes();
+  ORT_THROW_IF_ERROR(session.Run(onnxruntime::RunOptions{}, feeds, {"sum_final", "squares"}, &fetches));
+  EXPECT_EQ(fetches[1].Get<Tensor>().Shape(), TensorShape({num_iterations, sum_size}));
+  return allocator->NumBytes() - num_bytes_before_run;
+}
+
+// with the iteration count known the loop outputs aren't allocated per iteration and concatenated at the end
+TEST(Loop, LoopOutputsWithKnownIterationCount_NoPerIterationCopies) {
+  constexpr int64_t num_iterations = 4;
+  constexpr int64_t sum_size = 1024;
+  const size_t known_count_bytes = GetBytesAllocatedByLoop(CreateKnownIterationCountSubgraph(true, sum_size),
+                                                           num_iterations, sum_size);
+  const size_t computed_cond_bytes = GetBytesAllocatedByLoop(CreateKnownIterationCountSubgraph(false, sum_size),
+                                                             num_iterations, sum_size);
+  const size_t per_iteration_output_bytes = sum_size * sizeof(float);
+  EXPECT_GE(computed_cond_bytes, known_count_bytes + num_iterations * per_iteration_output_bytes);
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM)
 // test that when part of the subgraph run on CUDA/ROCm it executes successfully
 TEST(Loop, MixedExecutionProviders) {
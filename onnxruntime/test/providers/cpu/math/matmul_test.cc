@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/providers/run_options_config_keys.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/common/dnnl_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/common/tensor_op_test_utils.h"
@@ -298,6 +299,25 @@ TEST(MathOpTest, MatMul_bfloat16) {
 }
 #endif
 
+// The broadcast plan computed for the input shapes is cached on the first execution with them
+TEST(MathOpTest, MatMulShapeSpecialized) {
+  OpTester test("MatMul");
+  test.AddInput<float>("A", {2, 2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f,
+                                        -1.0f, -2.0f, -3.0f, -4.0f, -5.0f, -6.0f});
+  test.AddInput<float>("B", {3, 2}, {1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f});
+  test.AddOutput<float>("Y", {2, 2, 2}, {4.0f, 5.0f, 10.0f, 11.0f, -4.0f, -5.0f, -10.0f, -11.0f});
+
+  SessionOptions so;
+  ASSERT_EQ(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigShapeSpecializationHotThreshold, "1"),
+            Status::OK());
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Config(so)
+      .ConfigEps(std::move(execution_providers))
+      .RunWithConfig();
+}
+
 #ifndef ENABLE_TRAINING
 // Prepacking is disabled in full training build so no need to test the feature in a training build.
 TEST(MathOpTest, MatMulSharedPrepackedWeights) {
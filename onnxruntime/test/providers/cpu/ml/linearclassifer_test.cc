@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -166,5 +168,60 @@ TEST(MLOpTest, LinearClassifierMulticlassInt32Input) {
 TEST(MLOpTest, LinearClassifierMulticlassDoubleInput) {
   LinearClassifierMulticlass<double>();
 }
+
+// Enough rows for the batch to be split into several blocks of rows, each computing its labels and applying the
+// post transform to its scores. The batch is only split if there are at least as many blocks as threads, so the
+// session uses a fixed number of threads.
+TEST(MLOpTest, LinearClassifierMultipleRowBlocks) {
+  // 1638 rows per block of 8K elements with 2 features and 3 classes, so 4 blocks
+  constexpr int64_t num_batches = 5000;
+  constexpr int64_t num_features = 2;
+  constexpr int64_t num_classes = 3;
+
+  std::vector<float> coefficients = {-0.22562418f, 0.34188559f, 0.68346153f,
+                                     -0.68051993f, -0.1975279f, 0.03748541f};
+  std::vector<float> intercepts = {-3.91601811f, 0.42575697f, 0.13731251f};
+  std::vector<int64_t> classes = {1, 2, 3};
+
+  std::vector<float> X(num_batches * num_features);
+  for (int64_t b = 0; b < num_batches; ++b) {
+    X[b * num_features] = static_cast<float>(b % 17 - 8);
+    X[b * num_features + 1] = static_cast<float>(b % 11) * 0.5f - 2.f;
+  }
+
+  std::vector<int64_t> predicted_class(num_batches);
+  std::vector<float> predictions(num_batches * num_classes);
+  for (int64_t b = 0; b < num_batches; ++b) {
+    int64_t best = 0;
+    float best_score = 0.f;
+    for (int64_t c = 0; c < num_classes; ++c) {
+      float score = intercepts[c];
+      for (int64_t f = 0; f < num_features; ++f) {
+        score += X[b * num_features + f] * coefficients[c * num_features + f];
+      }
+      if (c == 0 || score > best_score) {
+        best = c;
+        best_score = score;
+      }
+      predictions[b * num_classes + c] = 1.f / (1.f + std::exp(-score));
+    }
+    predicted_class[b] = classes[best];
+  }
+
+  OpTester test("LinearClassifier", 1, onnxruntime::kMLDomain);
+  test.AddAttribute("coefficients", coefficients);
+  test.AddAttribute("intercepts", intercepts);
+  test.AddAttribute("classlabels_ints", classes);
+  test.AddAttribute("post_transform", std::string("LOGISTIC"));
+
+  test.AddInput<float>("X", {num_batches, num_features}, X);
+  test.AddOutput<int64_t>("Y", {num_batches}, predicted_class);
+  test.AddOutput<float>("Z", {num_batches, num_classes}, predictions);
+  test.SetOutputAbsErr("Z", 0.0001f);
+
+  SessionOptions so;
+  so.intra_op_param.thread_pool_size = 2;
+  test.Config(so).RunWithConfig();
+}
 }  // namespace test
 }  // namespace onnxruntime
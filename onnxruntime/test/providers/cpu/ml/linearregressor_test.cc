@@ -85,5 +85,41 @@ INSTANTIATE_TEST_SUITE_P(
                     LinearRegressorParam("SOFTMAX_ZERO", {3.442477e-14f, 1.f, 1.670142e-05f, 1.f, 1.0f, 0.f}, 2)
 
                         ));
+
+// Enough rows and features for the batch to be split into several blocks of rows.
+TEST(MLOpTest, LinearRegressorMultipleRowBlocks) {
+  constexpr int64_t num_batches = 64;
+  constexpr int64_t num_features = 256;
+  constexpr int64_t num_targets = 2;
+
+  std::vector<float> coefficients(num_targets * num_features);
+  for (size_t i = 0; i < coefficients.size(); ++i) {
+    coefficients[i] = static_cast<float>(static_cast<int64_t>(i % 7) - 3);
+  }
+  std::vector<float> intercepts{1.f, -2.f};
+  std::vector<float> input(num_batches * num_features);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i % 5);
+  }
+
+  std::vector<float> expected(num_batches * num_targets);
+  for (int64_t b = 0; b < num_batches; ++b) {
+    for (int64_t t = 0; t < num_targets; ++t) {
+      float sum = intercepts[t];
+      for (int64_t f = 0; f < num_features; ++f) {
+        sum += input[b * num_features + f] * coefficients[t * num_features + f];
+      }
+      expected[b * num_targets + t] = sum;
+    }
+  }
+
+  OpTester test("LinearRegressor", 1, onnxruntime::kMLDomain);
+  test.AddAttribute("intercepts", intercepts);
+  test.AddAttribute("coefficients", coefficients);
+  test.AddAttribute("targets", num_targets);
+  test.AddInput<float>("X", {num_batches, num_features}, input);
+  test.AddOutput<float>("Y", {num_batches, num_targets}, expected);
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
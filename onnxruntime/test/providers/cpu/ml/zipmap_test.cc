@@ -55,6 +55,24 @@ TEST(MLOpTest, ZipMapOpInt64Float1D) {
   TestHelper<int64_t>({10, 20, 30, 40, 50, 60}, "int64_t", {6});
 }
 
+TEST(MLOpTest, ZipMapOpStringFloatUnsortedLabels) {
+  TestHelper<string>({"zeta", "alpha", "mu"}, "string", {2, 3});
+}
+
+TEST(MLOpTest, ZipMapOpInt64FloatUnsortedLabels) {
+  TestHelper<int64_t>({30, -10, 20}, "int64_t", {2, 3});
+}
+
+TEST(MLOpTest, ZipMapOpInt64FloatDuplicateLabels) {
+  // a repeated label takes the value of its last occurrence
+  OpTester test("ZipMap", 1, onnxruntime::kMLDomain);
+  test.AddAttribute("classlabels_int64s", std::vector<int64_t>{7, 3, 7});
+  test.AddInput<float>("X", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  std::vector<std::map<int64_t, float>> expected_output{{{3, 2.f}, {7, 3.f}}, {{3, 5.f}, {7, 6.f}}};
+  test.AddOutput<int64_t, float>("Z", expected_output);
+  test.Run();
+}
+
 // Negative test cases
 TEST(MLOpTest, ZipMapOpStringFloatStrideMoreThanNumLabels) {
   TestHelper<string>({"class1", "class2", "class3"}, "string", {1, 6}, OpTester::ExpectResult::kExpectFailure);
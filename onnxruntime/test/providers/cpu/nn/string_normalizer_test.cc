@@ -1,11 +1,14 @@
 ﻿// Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
-#if ((__cplusplus >= 201703L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L)))
-// TODO: handle the u8string.
-#else
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
+#ifdef _MSC_VER
+#include <locale.h>
+#else
+#include <locale>
+#endif
+
 namespace onnxruntime {
 namespace test {
 
@@ -34,10 +37,145 @@ void InitTestAttr(OpTester& test, const std::string& case_change_action,
     test.AddAttribute("locale", locale);
   }
 }
+
+// Returns true if the locale is installed and maps the ASCII 'i' and 'I' to the Turkish dotted and dotless i.
+bool HasTurkishCaseMapping(const std::string& locale) {
+#ifdef _MSC_VER
+  _locale_t loc = _create_locale(LC_CTYPE, locale.c_str());
+  if (loc == nullptr) {
+    return false;
+  }
+  const bool result = ::_towupper_l(L'i', loc) == L'\u0130' && ::_towlower_l(L'I', loc) == L'\u0131';
+  _free_locale(loc);
+  return result;
+#else
+  ORT_TRY {
+    const std::locale loc(locale.c_str());
+    return std::toupper(L'i', loc) == L'\u0130' && std::tolower(L'I', loc) == L'\u0131';
+  }
+  ORT_CATCH(const std::runtime_error&) {
+    return false;
+  }
+  return false;
+#endif
+}
 }  // namespace str_normalizer_test
 
 using namespace str_normalizer_test;
 
+// ASCII strings are mapped with the lookup tables of the locale, 8 bytes at a time when checking for ASCII
+TEST(StringNormalizerTest, AsciiInput) {
+  const std::vector<std::string> input = {"monday", "Tuesday is the second day of the week", "", "MiXeD 123 !?"};
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "UPPER", true, {}, test_locale);
+    test.AddInput<std::string>("T", {4}, input);
+    test.AddOutput<std::string>("Y", {4}, {"MONDAY", "TUESDAY IS THE SECOND DAY OF THE WEEK", "", "MIXED 123 !?"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", true, {}, test_locale);
+    test.AddInput<std::string>("T", {4}, input);
+    test.AddOutput<std::string>("Y", {4}, {"monday", "tuesday is the second day of the week", "", "mixed 123 !?"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  // case insensitive stopwords keep the case of the other strings
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "NONE", false, {"MONDAY", "mixed 123 !?"}, test_locale);
+    test.AddInput<std::string>("T", {4}, input);
+    test.AddOutput<std::string>("Y", {2}, {"Tuesday is the second day of the week", ""});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+}
+
+// The ASCII strings of the input take the lookup tables and the others the wide character conversion,
+// including those whose non-ASCII characters come after the first 8 bytes.
+TEST(StringNormalizerTest, MixedAsciiAndNonAsciiInput) {
+  const std::vector<std::string> input = {"hello world", "hello wörld", "abcdefghijklmnopé", "Понедельник", "中文"};
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "UPPER", true, {}, test_locale);
+    test.AddInput<std::string>("T", {5}, input);
+    test.AddOutput<std::string>("Y", {5}, {"HELLO WORLD", "HELLO WÖRLD", "ABCDEFGHIJKLMNOPÉ", "ПОНЕДЕЛЬНИК", "中文"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", true, {}, test_locale);
+    test.AddInput<std::string>("T", {1, 5}, input);
+    test.AddOutput<std::string>("Y", {1, 5}, {"hello world", "hello wörld", "abcdefghijklmnopé", "понедельник", "中文"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+}
+
+TEST(StringNormalizerTest, CaseInsensitiveNonAsciiStopwords) {
+  const std::vector<std::string> input = {"école", "ÉCOLE", "мир", "Tuesday", "Besançon"};
+  // no case change: the strings that are not stopwords are output unchanged
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "NONE", false, {"École", "МИР"}, test_locale);
+    test.AddInput<std::string>("T", {5}, input);
+    test.AddOutput<std::string>("Y", {2}, {"Tuesday", "Besançon"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  // the strings that are not stopwords are output in the case they were compared in
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "UPPER", false, {"École", "МИР"}, test_locale);
+    test.AddInput<std::string>("T", {5}, input);
+    test.AddOutput<std::string>("Y", {2}, {"TUESDAY", "BESANÇON"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", false, {"École", "МИР"}, test_locale);
+    test.AddInput<std::string>("T", {5}, input);
+    test.AddOutput<std::string>("Y", {2}, {"tuesday", "besançon"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+}
+
+// The Turkish locale maps the ASCII 'i' and 'I' outside of ASCII, so the lookup tables can't be used
+// and even ASCII strings go through the wide character conversion.
+TEST(StringNormalizerTest, LocaleMappingAsciiOutsideAscii) {
+#ifdef _MSC_VER
+  const std::string turkish_locale("tr-TR");
+#else
+  const std::string turkish_locale("tr_TR.UTF-8");
+#endif
+  if (!HasTurkishCaseMapping(turkish_locale)) {
+    GTEST_SKIP() << "The locale " << turkish_locale << " is not installed or doesn't map the Turkish i";
+  }
+
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "UPPER", true, {}, turkish_locale);
+    test.AddInput<std::string>("T", {3}, {"istanbul", "izmir", "ANKARA"});
+    test.AddOutput<std::string>("Y", {3}, {"İSTANBUL", "İZMİR", "ANKARA"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", true, {}, turkish_locale);
+    test.AddInput<std::string>("T", {3}, {"ISTANBUL", "Izmir", "ankara"});
+    test.AddOutput<std::string>("Y", {3}, {"ıstanbul", "ızmir", "ankara"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  // stopwords are compared in the case of the locale
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "NONE", false, {"İSTANBUL"}, turkish_locale);
+    test.AddInput<std::string>("T", {2}, {"istanbul", "ISTANBUL"});
+    test.AddOutput<std::string>("Y", {1}, {"ISTANBUL"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+}
+
+#if ((__cplusplus >= 201703L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L)))
+// TODO: handle the u8string.
+#else
 TEST(ContribOpTest, StringNormalizerTest) {
   // - casesensitive approach
   // - no stopwords.
@@ -201,7 +339,7 @@ TEST(ContribOpTest, StringNormalizerTest) {
     test.Run(OpTester::ExpectResult::kExpectSuccess);
   }
 }
+#endif
 
 }  // namespace test
 }  // namespace onnxruntime
-#endif
\ No newline at end of file
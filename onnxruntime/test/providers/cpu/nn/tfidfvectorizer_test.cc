@@ -689,6 +689,91 @@ TEST(TfIdfVectorizerTest, String_TFIDFWeights_onlyBigrams_Skip5_2rows) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+// The same n-grams are found at several skip distances and overlap each other. Uni-grams are counted once,
+// the longer n-grams once per skip distance they are found at.
+TEST(TfIdfVectorizerTest, Int32_TF_UniBiAndTrigrams_OverlappingSkip2) {
+  OpTester test("TfIdfVectorizer", opset_ver);
+  // s=2, Min=1, Max=3, weights empty, int32
+  InitTestAttr(test, "TF", 1, 3, 2,
+               {0, 2, 6},
+               {0, 1, 2, 3, 4},  // 5 output indexes
+               {},
+               {1, 2,         // 1-grams
+                1, 2, 2, 1,   // bi-grams
+                1, 2, 1},     // tri-grams
+               {});
+
+  test.AddInput<int32_t>("T", {5}, {1, 2, 1, 2, 1});
+
+  // (1, 2) and (2, 1) are found twice at distance 1 and once at distance 3. (1, 2, 1) is found twice at
+  // distance 1 but not at distance 2, as (1, 1, 1) skips the 2s.
+  test.AddOutput<float>("Y", {5}, {3.f, 2.f, 3.f, 3.f, 2.f});
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(TfIdfVectorizerTest, Int32_TF_BiAndTrigrams_OverlappingSkip2) {
+  OpTester test("TfIdfVectorizer", opset_ver);
+  // s=2, Min=2, Max=3, weights empty, int32
+  InitTestAttr(test, "TF", 2, 3, 2,
+               {0, 2, 6},
+               {0, 1, 2, 3, 4},  // 5 output indexes
+               {},
+               {1, 2,         // 1-grams
+                1, 2, 2, 1,   // bi-grams
+                1, 2, 1},     // tri-grams
+               {});
+
+  test.AddInput<int32_t>("T", {5}, {1, 2, 1, 2, 1});
+
+  test.AddOutput<float>("Y", {5}, {0.f, 0.f, 3.f, 3.f, 2.f});
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+// A repeated token makes every n-gram overlap the others at each skip distance
+TEST(TfIdfVectorizerTest, Int32_TF_RepeatedToken_Skip1) {
+  OpTester test("TfIdfVectorizer", opset_ver);
+  // s=1, Min=1, Max=3, weights empty, int32
+  InitTestAttr(test, "TF", 1, 3, 1,
+               {0, 1, 3},
+               {0, 1, 2},  // 3 output indexes
+               {},
+               {1,          // 1-grams
+                1, 1,       // bi-grams
+                1, 1, 1},   // tri-grams
+               {});
+
+  test.AddInput<int32_t>("T", {4}, {1, 1, 1, 1});
+
+  // bi-grams: 3 at distance 1 and 2 at distance 2. tri-grams: 2 at distance 1, none fit at distance 2.
+  test.AddOutput<float>("Y", {3}, {4.f, 5.f, 2.f});
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+// Pool strings that are prefixes of one another, and of input strings, only match themselves.
+// The bi-gram (ab, a) is also the prefix of the tri-gram (ab, a, abc).
+TEST(TfIdfVectorizerTest, String_TF_PrefixPoolStrings_Skip1) {
+  OpTester test("TfIdfVectorizer", opset_ver);
+  // s=1, Min=1, Max=3, weights empty, string
+  InitTestAttr(test, "TF", 1, 3, 1,
+               {0, 3, 7},
+               {0, 1, 2, 3, 4, 5},  // 6 output indexes
+               {},
+               {},
+               {"a", "ab", "abc",           // 1-grams
+                "ab", "a", "a", "abc",      // bi-grams
+                "ab", "a", "abc"});         // tri-grams
+
+  test.AddInput<std::string>("T", {7}, {"ab", "a", "abcd", "abc", "ab", "a", "abc"});
+
+  // "abcd" matches none of the pool strings. (a, abc) is found once at distance 1 and once at distance 2.
+  test.AddOutput<float>("Y", {6}, {2.f, 2.f, 2.f, 2.f, 2.f, 1.f});
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 // This test runs the inference 100 times to test the improvement
 // It enables profiling while running inference multiple times.
 // So we can manually inspect the profiling output
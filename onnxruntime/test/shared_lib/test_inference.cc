@@ -2072,6 +2072,34 @@ TEST(CApiTest, fill_string_tensor_directly) {
   }
 }
 
+TEST(CApiTest, fill_string_tensor_from_buffer) {
+  const std::string buffer = "Thisisatest";
+  const std::vector<size_t> offsets = {0, 4, 6, 7};
+  const std::vector<std::string> expected = {"This", "is", "a", "test"};
+  const int64_t expected_len = static_cast<int64_t>(offsets.size());
+
+  MockedOrtAllocator default_allocator;
+  Ort::Value tensor = Ort::Value::CreateTensor(&default_allocator, &expected_len, 1U,
+                                               ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING);
+  tensor.FillStringTensorFromBuffer(buffer.data(), buffer.size(), offsets.data(), offsets.size());
+
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_EQ(expected[i], tensor.GetStringTensorElement(i));
+  }
+
+  // round trip through GetStringTensorContent
+  std::string content(tensor.GetStringTensorDataLength(), '\0');
+  std::vector<size_t> content_offsets(offsets.size());
+  tensor.GetStringTensorContent(content.data(), content.size(), content_offsets.data(), content_offsets.size());
+  ASSERT_EQ(buffer, content);
+  ASSERT_EQ(offsets, content_offsets);
+
+  // offsets past the end of the buffer are rejected
+  const std::vector<size_t> bad_offsets = {0, 4, 6, 20};
+  ASSERT_THROW(tensor.FillStringTensorFromBuffer(buffer.data(), buffer.size(), bad_offsets.data(), bad_offsets.size()),
+               Ort::Exception);
+}
+
 TEST(CApiTest, get_string_tensor_element) {
   const char* s[] = {"abc", "kmp"};
   constexpr int64_t expected_len = 2;
@@ -3658,6 +3686,120 @@ TEST(MultiKernelSingleSchemaTest, DuplicateKernel) {
 
 #endif
 
+TEST(CApiTest, RunPrepared) {
+  Ort::Session session(*ort_env, MODEL_URI, Ort::SessionOptions{});
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::PreparedRun prepared_run(session, input_names, 1, output_names, 1);
+
+  float x_value[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  int64_t x_dim[] = {3, 2};
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::Value input_tensor = Ort::Value::CreateTensor<float>(memory_info, x_value, 6, x_dim, 2);
+  const std::array<float, 6> expected_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  // outputs allocated by onnxruntime
+  Ort::RunOptions run_options;
+  for (int i = 0; i < 2; ++i) {
+    Ort::Value output{nullptr};
+    session.Run(run_options, prepared_run, &input_tensor, 1, &output, 1);
+    ASSERT_TRUE(output.IsTensor());
+    const float* y = output.GetTensorData<float>();
+    ASSERT_EQ(output.GetTensorTypeAndShapeInfo().GetElementCount(), expected_y.size());
+    EXPECT_TRUE(std::equal(expected_y.cbegin(), expected_y.cend(), y));
+  }
+
+  // pre-allocated output
+  std::array<float, 6> y_value{};
+  Ort::Value output = Ort::Value::CreateTensor<float>(memory_info, y_value.data(), y_value.size(), x_dim, 2);
+  session.Run(run_options, prepared_run, &input_tensor, 1, &output, 1);
+  EXPECT_EQ(y_value, expected_y);
+
+  // values are still validated when they differ from the previous run
+  int32_t x_int_value[] = {1, 2, 3, 4, 5, 6};
+  Ort::Value int_input_tensor = Ort::Value::CreateTensor<int32_t>(memory_info, x_int_value, 6, x_dim, 2);
+  Ort::Value unused_output{nullptr};
+  EXPECT_THROW(session.Run(run_options, prepared_run, &int_input_tensor, 1, &unused_output, 1), Ort::Exception);
+  EXPECT_THROW(session.Run(run_options, prepared_run, &input_tensor, 0, &unused_output, 1), Ort::Exception);
+
+  // invalid names are rejected up front
+  const char* bad_names[] = {"not_an_input"};
+  EXPECT_THROW(Ort::PreparedRun(session, bad_names, 1, output_names, 1), Ort::Exception);
+  EXPECT_THROW(Ort::PreparedRun(session, input_names, 1, bad_names, 1), Ort::Exception);
+}
+
+TEST(CApiTest, SampledProfiling) {
+  Ort::AllocatorWithDefaultOptions allocator;
+
+  // not enabled by default
+  Ort::Session unsampled_session(*ort_env, MODEL_URI, Ort::SessionOptions{});
+  EXPECT_THROW(unsampled_session.GetSampledProfileAllocated(allocator), Ort::Exception);
+
+  Ort::SessionOptions session_options;
+  session_options.AddConfigEntry(kOrtSessionOptionsConfigSampledProfilingInterval, "2");
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  float x_value[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  int64_t x_dim[] = {3, 2};
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::Value input_tensor = Ort::Value::CreateTensor<float>(memory_info, x_value, 6, x_dim, 2);
+
+  // nothing is recorded before the first run
+  std::string profile = session.GetSampledProfileAllocated(allocator).get();
+  EXPECT_EQ(profile.find("_count{"), std::string::npos);
+
+  // 1 in 2 of the runs are sampled
+  for (int i = 0; i < 4; ++i) {
+    session.Run(Ort::RunOptions{}, input_names, &input_tensor, 1, output_names, 1);
+  }
+  profile = session.GetSampledProfileAllocated(allocator).get();
+  EXPECT_NE(profile.find("# TYPE onnxruntime_node_latency_microseconds histogram"), std::string::npos);
+  EXPECT_NE(profile.find("op_type=\"Mul\",le=\"+Inf\"} 2\n"), std::string::npos) << profile;
+  EXPECT_NE(profile.find("onnxruntime_node_latency_microseconds_count{"), std::string::npos);
+}
+
+TEST(CApiTest, PeakMemoryUsage) {
+  {
+    // not recorded by default
+    Ort::Session session(*ort_env, MODEL_URI, Ort::SessionOptions{});
+    size_t planned_peak_bytes = 0;
+    size_t actual_peak_bytes = 0;
+    EXPECT_THROW(session.GetPeakMemoryUsage({{3, 2}}, planned_peak_bytes, actual_peak_bytes), Ort::Exception);
+  }
+
+  Ort::SessionOptions session_options;
+  session_options.AddConfigEntry(kOrtSessionOptionsConfigRecordPeakMemoryUsage, "1");
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  float x_value[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  int64_t x_dim[] = {3, 2};
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::Value input_tensor = Ort::Value::CreateTensor<float>(memory_info, x_value, 6, x_dim, 2);
+
+  size_t planned_peak_bytes = 0;
+  size_t actual_peak_bytes = 0;
+  EXPECT_THROW(session.GetPeakMemoryUsage({{3, 2}}, planned_peak_bytes, actual_peak_bytes), Ort::Exception);
+
+  for (int i = 0; i < 2; ++i) {
+    session.Run(Ort::RunOptions{}, input_names, &input_tensor, 1, output_names, 1);
+  }
+
+  // the output Y is allocated by the run
+  session.GetPeakMemoryUsage({{3, 2}}, planned_peak_bytes, actual_peak_bytes);
+  EXPECT_GE(actual_peak_bytes, sizeof(x_value));
+
+  // no run with other input shapes
+  EXPECT_THROW(session.GetPeakMemoryUsage({{4, 2}}, planned_peak_bytes, actual_peak_bytes), Ort::Exception);
+  // the shapes are matched exactly, not by the set of their dims
+  EXPECT_THROW(session.GetPeakMemoryUsage({{2, 3}}, planned_peak_bytes, actual_peak_bytes), Ort::Exception);
+  EXPECT_THROW(session.GetPeakMemoryUsage({{3, 2}, {3, 2}}, planned_peak_bytes, actual_peak_bytes), Ort::Exception);
+}
+
 static std::thread::id caller_tid = std::this_thread::get_id();
 static std::atomic_bool atomic_wait{false};
 
@@ -3714,6 +3856,59 @@ void CallbackFail(void*, OrtValue**, size_t, OrtStatusPtr) {
   EXPECT_TRUE(false);  // the callback is not supposed to be invoked
 }
 
+TEST(CApiTest, RunAsyncDedicatedThreads) {
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(1);  // no intra op workers are needed with dedicated async run threads
+  session_options.AddConfigEntry(kOrtSessionOptionsConfigAsyncRunNumThreads, "1");
+  session_options.AddConfigEntry(kOrtSessionOptionsConfigAsyncRunMaxQueueDepth, "4");
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  const char* input_names[] = {"X"};
+  float x_value[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  int64_t x_dim[] = {3, 2};
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+  Ort::Value input_tensors[1] = {
+      Ort::Value::CreateTensor<float>(memory_info, x_value, 6, x_dim, 2),
+  };
+
+  const char* output_names[] = {"Y"};
+  Ort::RunOptions run_options;
+  run_options.AddConfigEntry(kOrtRunOptionsConfigAsyncRunPriority, "1");
+  Ort::Value output_values[1] = {Ort::Value{nullptr}};
+
+  atomic_wait.store(false);
+  EXPECT_NO_THROW(session.RunAsync(run_options, input_names, input_tensors, 1, output_names, output_values, 1,
+                                   CallbackSucceed, &caller_tid));
+
+  std::chrono::duration<double, std::milli> dur{100};
+  // timeout in about 10 secs
+  for (int i = 0; i < 100 && !atomic_wait.load(); ++i) {
+    std::this_thread::sleep_for(dur);
+  }
+  EXPECT_EQ(atomic_wait.load(), true);
+
+  // a request whose deadline has passed is completed with an error without running
+  static std::atomic_bool expired{false};
+  Ort::RunOptions expired_run_options;
+  expired_run_options.AddConfigEntry(kOrtRunOptionsConfigAsyncRunDeadlineMs, "-1");
+  Ort::Value expired_output_values[1] = {Ort::Value{nullptr}};
+  EXPECT_NO_THROW(session.RunAsync(
+      expired_run_options, input_names, input_tensors, 1, output_names, expired_output_values, 1,
+      [](void*, OrtValue**, size_t num_outputs, OrtStatusPtr status_ptr) {
+        Ort::Status status(status_ptr);
+        EXPECT_FALSE(status.IsOK());
+        EXPECT_EQ(num_outputs, 0UL);
+        expired.store(true);
+      },
+      nullptr));
+
+  for (int i = 0; i < 100 && !expired.load(); ++i) {
+    std::this_thread::sleep_for(dur);
+  }
+  EXPECT_EQ(expired.load(), true);
+}
+
 TEST(CApiTest, RunAsyncFail) {
   Ort::SessionOptions session_options;
   session_options.SetIntraOpNumThreads(1);  // This will cause RunAsync fail